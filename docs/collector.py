@@ -0,0 +1,114 @@
+"""
+A stand-in collector for the segment uploader (see uploader.h).
+
+On every connection, it tells the device the segment and offset it needs
+next, i.e. the end of the latest segment it has, and then appends the bytes
+it receives to the segments in its directory.
+
+Usage: python3 collector.py [port] [directory]
+"""
+
+import os
+import re
+import socketserver
+import struct
+import sys
+
+UPLOAD_MAGIC = 0x55504C44
+RESUME = struct.Struct("<IIQ")
+HEADER = struct.Struct("<IIQQ")
+
+directory = "."
+
+
+def segment_path(segment_id):
+    """
+    Get the path of a segment
+
+    Args:
+        segment_id (int): the id of the segment
+
+    Returns:
+        str: the path of the segment
+    """
+
+    return os.path.join(directory, "ssids_%08u.seg" % segment_id)
+
+
+def resume_point():
+    """
+    Find where the upload should resume from
+
+    Returns:
+        (segment_id, offset): the end of the latest segment
+    """
+
+    ids = [int(m.group(1)) for m in
+           (re.match(r"ssids_(\d{8})\.seg$", name) for name in os.listdir(directory)) if m]
+
+    if not ids:
+        return 0, 0
+
+    return max(ids), os.path.getsize(segment_path(max(ids)))
+
+
+def receive(stream, size):
+    """
+    Receive a number of bytes, or less if the device disconnects
+    """
+
+    data = b""
+
+    while len(data) < size:
+        chunk = stream.read(size - len(data))
+        if not chunk:
+            break
+        data += chunk
+
+    return data
+
+
+class UploadHandler(socketserver.StreamRequestHandler):
+
+    def handle(self):
+        segment_id, offset = resume_point()
+        print("%s: resume at %u:%u" % (self.client_address[0], segment_id, offset))
+
+        self.wfile.write(RESUME.pack(UPLOAD_MAGIC, segment_id, offset))
+        self.wfile.flush()
+
+        while True:
+            header = receive(self.rfile, HEADER.size)
+            if len(header) < HEADER.size:
+                break
+
+            magic, segment_id, offset, size = HEADER.unpack(header)
+            if magic != UPLOAD_MAGIC:
+                break
+
+            path = segment_path(segment_id)
+            mode = "r+b" if os.path.exists(path) else "wb"
+
+            with open(path, mode) as f:
+                # Whatever is past the offset is sent again
+                f.truncate(offset)
+                f.seek(offset)
+
+                while offset < size:
+                    data = self.rfile.read(min(size - offset, 64 * 1024))
+                    if not data:
+                        return
+                    f.write(data)
+                    offset += len(data)
+
+            print("%s: segment %u complete (%u bytes)" % (self.client_address[0], segment_id, size))
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 5151
+    directory = sys.argv[2] if len(sys.argv) > 2 else "."
+
+    socketserver.TCPServer.allow_reuse_address = True
+
+    with socketserver.TCPServer(("", port), UploadHandler) as server:
+        server.serve_forever()
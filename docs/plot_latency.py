@@ -61,5 +61,5 @@ def generate_plot(x, y):
     figure.savefig('latency.png', dpi=60, bbox_inches='tight')
 
 if __name__ == '__main__':
-    x, y = parse_logfile('../src/ssids.txt')
+    x, y = parse_logfile('/dev/shm/ssids.txt')
     generate_plot(x, y)
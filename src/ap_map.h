@@ -0,0 +1,70 @@
+/**
+  * @file ap_map.h
+  * @brief Contains the format of the AP map, i.e. the known positions and
+  *        signal models of the APs, that the localizer maps to memory.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef AP_MAP_H
+#define AP_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The default file of the AP map. */
+#define AP_MAP_FILE "ap_map.bin"
+
+/** The magic number and version of the AP map. */
+#define AP_MAP_MAGIC   (0x50414D41u)
+#define AP_MAP_VERSION (1u)
+
+/***************************** Type Definitions ******************************/
+
+/** The header of the AP map. It is followed by the entries, sorted by BSSID
+  * (compared as bytes), so that they are looked up by binary search. The
+  * positions are in meters, east (x) and north (y) of the origin.
+  */
+struct APMapHeader {
+  u32_t magic;
+  u16_t version;
+  u16_t header_size;
+  u32_t entry_size;
+  u32_t count;
+  f64_t origin_lat, origin_lon;  /* degrees */
+};
+
+/** The distance (in meters) that a closer sighting counts as, in the model
+  * of an AP (both when it is fitted and when it is used).
+  */
+#define AP_MAP_MIN_DISTANCE (1.0f)
+
+/** An AP of the map. Its expected RSSI at a distance d (in meters) follows
+  * the log-distance path loss model: rssi_1m - 10 * path_loss * log10(d),
+  * with d at least AP_MAP_MIN_DISTANCE, and a gaussian error of deviation
+  * sigma (in dB).
+  */
+struct APMapEntry {
+  u8_t bssid[6];
+  u16_t sightings;
+  f32_t x, y;
+  f32_t rssi_1m;
+  f32_t path_loss;
+  f32_t sigma;
+};
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* AP_MAP_H */
\ No newline at end of file
@@ -0,0 +1,689 @@
+/**
+  * @file benchmarks.c
+  * @brief Implements the microbenchmarks of the modules.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#include "time_helpers.h"
+#include "ssid_store.h"
+#include "workload.h"
+#include "flash_writer.h"
+#include "localizer.h"
+#include "cold_tier.h"
+#include "prefetcher.h"
+
+#include "benchmarks.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The size of a batch, i.e. the APs of a whole scan. */
+#define BENCH_BATCH (200u)
+
+/** The number of batches that are looked up per store size. */
+#define BENCH_BATCHES (2000u)
+
+/** The capacity of the store and the days replayed to compare the policies. */
+#define BENCH_POLICY_CAPACITY (256u)
+#define BENCH_POLICY_DAYS     (7u)
+
+/** The cold tier that the evicted SSIDs are spilled to, to measure the
+  * prefetches.
+  */
+#define BENCH_COLD_FILE STAGING_DIR "/ssid_cold_bench.dat"
+
+/** The jitter benchmark: the frames of a read task that scans and then
+  * flushes the log, while a store task appends the batch of each scan. It
+  * runs in a directory on disk, so that the flushes have a real cost.
+  */
+#define BENCH_JITTER_DIR    "/var/tmp/jitter_XXXXXX"
+#define BENCH_JITTER_FRAMES (300u)
+#define BENCH_JITTER_FRAME  (50u)   /* msecs */
+#define BENCH_JITTER_SCAN   (20u)   /* msecs */
+#define BENCH_STAGING_FILE  STAGING_DIR "/ssid_staging_bench.dat"
+#define BENCH_JITTER_BATCH  (1000u)
+
+/** A batch is a spike if it takes this many times the median. */
+#define BENCH_SPIKE_FACTOR (3u)
+
+/** The synthetic AP map (a grid of APs), and the route that is localized on
+  * it (a circle, driven at a constant speed).
+  */
+#define BENCH_MAP_FILE     STAGING_DIR "/ap_map_bench.bin"
+#define BENCH_MAP_SIDE     (8u)
+#define BENCH_MAP_SPACING  (250.0f)
+#define BENCH_AP_RANGE     (500.0f)
+#define BENCH_ROUTE_RADIUS (600.0f)
+#define BENCH_ROUTE_SPEED  (10.0f)
+#define BENCH_EPOCHS       (200u)
+#define BENCH_WARMUP       (20u)
+
+/** The calls that each timestamp source is timed over, and the samples (and
+  * their interval, in msecs) of the counter against the clock.
+  */
+#define BENCH_TIMESTAMP_CALLS    (1000000u)
+#define BENCH_TIMESTAMP_SAMPLES  (200u)
+#define BENCH_TIMESTAMP_INTERVAL (10u)
+
+/***************************** Type Definitions ******************************/
+
+/** A benchmark that can be run by name. */
+struct Benchmark {
+  const char* name;
+  void (*run)(void);
+};
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the next pseudo-random number (xorshift32).
+ * @param state The state of the generator.
+ * @return The next number.
+ */
+static u32_t nextRandom(u32_t* state);
+
+/**
+ * @brief Compare the serial and batched (prefetched) lookups of the store.
+ * @return Void.
+ */
+static void benchmarkStore(void);
+
+/**
+ * @brief Compare the eviction policies of the store on the replay workload.
+ * @return Void.
+ */
+static void benchmarkPolicy(void);
+
+/**
+ * @brief Compare the cold misses of the store with and without the route
+ *        prefetches, on the replay workload.
+ * @return Void.
+ */
+static void benchmarkPrefetch(void);
+
+/**
+ * @brief The store task of the jitter benchmark: it appends each batch to
+ *        the log and times it.
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void* jitterStore(void* arg);
+
+/**
+ * @brief Compare the latency spikes of the store task when the log is
+ *        flushed right after a scan, and in the quiet window after it.
+ * @return Void.
+ */
+static void benchmarkJitter(void);
+
+/**
+ * @brief Compare two latencies.
+ * @return The order of the latencies.
+ */
+static int compareLatencies(const void* a, const void* b);
+
+/**
+ * @brief Write a synthetic AP map.
+ * @param entries The entries of the map.
+ * @return Void.
+ */
+static void writeBenchmarkMap(struct APMapEntry* entries);
+
+/**
+ * @brief Measure the time and the error of the localizer per epoch, with
+ *        an increasing number of workers.
+ * @return Void.
+ */
+static void benchmarkLocalizer(void);
+
+/**
+ * @brief Compare the cost of the timestamp sources (the system call, the
+ *        vDSO and the calibrated counter), and measure the error of the
+ *        counter against the clock.
+ * @return Void.
+ */
+static void benchmarkTimestamp(void);
+
+/***************************** Static Variables ******************************/
+
+/** The benchmarks that can be run. */
+static const struct Benchmark benchmarks[] = {
+  { "store", benchmarkStore },
+  { "policy", benchmarkPolicy },
+  { "localizer", benchmarkLocalizer },
+  { "prefetch", benchmarkPrefetch },
+  { "jitter", benchmarkJitter },
+  { "timestamp", benchmarkTimestamp },
+};
+
+/** The batch under test. */
+static struct SSIDRecord batch[BENCH_BATCH];
+static u32_t found[BENCH_BATCH];
+
+/** The handover of the batches to the store task of the jitter benchmark,
+  * and the time each batch took.
+  */
+static pthread_mutex_t jitter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jitter_cond = PTHREAD_COND_INITIALIZER;
+static u8_t jitter_ready, jitter_busy, jitter_done;
+static u32_t jitter_frame;
+static f64_t jitter_latencies[BENCH_JITTER_FRAMES];
+
+/***************************** Static Functions ******************************/
+
+u32_t nextRandom(u32_t* state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+
+  return *state;
+}
+
+void benchmarkStore(void)
+{
+  u32_t i, j, size, mode, seed;
+  u64_t start_time, elapsed[3];
+  static const u32_t sizes[] = { 1000u, 100000u, 500000u };
+
+  printf("entries     serial_ns  batch_ns  sorted_ns  (per lookup)\n");
+
+  for (size = 0; size < sizeof(sizes) / sizeof(sizes[0]); size++)
+  {
+    initializeSSIDStore(sizes[size], STORE_POLICY_LRU);
+
+    for (i = 0; i < sizes[size]; i++)
+    {
+      snprintf(batch[i % BENCH_BATCH].ssid, SSID_SIZE, "ap%07u\n", i);
+      batch[i % BENCH_BATCH].timestamp = 0;
+
+      if (i % BENCH_BATCH == BENCH_BATCH - 1 || i == sizes[size] - 1)
+        storeSSIDBatch(batch, i % BENCH_BATCH + 1, FALSE);
+    }
+
+    for (mode = 0; mode < 3; mode++)
+    {
+      /* The same lookups for every mode */
+      seed = 2463534242u;
+      elapsed[mode] = 0;
+
+      for (i = 0; i < BENCH_BATCHES; i++)
+      {
+        for (j = 0; j < BENCH_BATCH; j++)
+        {
+          snprintf(batch[j].ssid, SSID_SIZE, "ap%07u\n", nextRandom(&seed) % sizes[size]);
+          batch[j].timestamp = 1;
+        }
+
+        start_time = getMonotonicTime();
+
+        if (mode == 0)
+        {
+          for (j = 0; j < BENCH_BATCH; j++)
+            found[j] = findSSID(&batch[j]);
+        }
+        else
+          findSSIDBatch(batch, BENCH_BATCH, mode == 2, found);
+
+        elapsed[mode] += getMonotonicTime() - start_time;
+      }
+    }
+
+    printf("%-10u  %-9.1f  %-8.1f  %-9.1f\n", sizes[size],
+           elapsed[0] / (f64_t)(BENCH_BATCHES * BENCH_BATCH),
+           elapsed[1] / (f64_t)(BENCH_BATCHES * BENCH_BATCH),
+           elapsed[2] / (f64_t)(BENCH_BATCHES * BENCH_BATCH));
+
+    exitSSIDStore();
+  }
+}
+
+void benchmarkPolicy(void)
+{
+  u8_t policy, bursts;
+  u32_t i, j, num;
+  u64_t scans, anchors, anchor_hits;
+  f32_t time;
+  struct StoreStats stats;
+  struct SSIDRecord scan[WORKLOAD_MAX_SCAN];
+
+  printf("workload  policy   hit_rate  anchor_hit_rate  memory   ns_per_op  admitted  rejected\n");
+
+  /* The bursts evict the anchors from a LRU store between two of their scans */
+  for (i = 0; i < 4; i++)
+  {
+    bursts = i / 2;
+    policy = (i % 2) ? STORE_POLICY_TINYLFU : STORE_POLICY_LRU;
+
+    initializeSSIDStore(BENCH_POLICY_CAPACITY, policy);
+    initializeWorkload(2463534242u, bursts);
+
+    anchors = 0;
+    anchor_hits = 0;
+
+    for (scans = 0; scans < BENCH_POLICY_DAYS * (u64_t)(WORKLOAD_DAY / WORKLOAD_SCAN_PERIOD); scans++)
+    {
+      num = nextWorkloadScan(scan, &time);
+
+      /* The anchors (home and depot) are the APs worth keeping */
+      findSSIDBatch(scan, num, FALSE, found);
+
+      for (j = 0; j < num; j++)
+      {
+        if (scan[j].ssid[0] == 'h' || scan[j].ssid[0] == 'd')
+        {
+          anchors++;
+          anchor_hits += (found[j] != STORE_NOT_FOUND);
+        }
+      }
+
+      storeSSIDBatch(scan, num, FALSE);
+    }
+
+    getStoreStats(&stats);
+
+    printf("%-8s  %-7s  %-8.4f  %-15.4f  %-7llu  %-9.1f  %-8llu  %llu\n",
+           bursts ? "bursts" : "routine", (policy == STORE_POLICY_LRU) ? "lru" : "tinylfu",
+           (f64_t)stats.hits / stats.lookups, (f64_t)anchor_hits / anchors,
+           stats.memory, (f64_t)stats.op_time / stats.lookups,
+           stats.admissions, stats.rejections);
+
+    exitSSIDStore();
+  }
+}
+
+void benchmarkPrefetch(void)
+{
+  u8_t prefetch;
+  u32_t i, num;
+  u64_t scans, baseline_misses = 0;
+  f32_t time;
+  struct ColdTierStats stats;
+  struct SSIDRecord scan[WORKLOAD_MAX_SCAN];
+  struct SightedSSID sighted[WORKLOAD_MAX_SCAN];
+
+  printf("prefetch  cold_misses  warm_hits  prefetches  wasted  accuracy  miss_reduction\n");
+
+  for (prefetch = FALSE; prefetch <= TRUE; prefetch++)
+  {
+    initializeSSIDStore(BENCH_POLICY_CAPACITY, STORE_POLICY_TINYLFU);
+    initializeColdTier(BENCH_COLD_FILE);
+    initializePrefetcher();
+    initializeWorkload(2463534242u, FALSE);
+
+    for (scans = 0; scans < BENCH_POLICY_DAYS * (u64_t)(WORKLOAD_DAY / WORKLOAD_SCAN_PERIOD); scans++)
+    {
+      num = nextWorkloadScan(scan, &time);
+
+      storeSSIDBatch(scan, num, FALSE);
+
+      /* As the prefetch task would, right after the store */
+      serviceColdTier();
+
+      if (prefetch)
+      {
+        for (i = 0; i < num; i++)
+        {
+          sighted[i].hash = hashSSID(scan[i].ssid);
+          sighted[i].tier = scan[i].tier;
+        }
+
+        prefetchEpoch(sighted, num);
+      }
+    }
+
+    exitColdTier();
+    getColdTierStats(&stats);
+
+    if (!prefetch)
+      baseline_misses = stats.cold_misses;
+
+    printf("%-8s  %-11llu  %-9llu  %-10llu  %-6llu  %-8.4f  %.4f\n", prefetch ? "on" : "off",
+           stats.cold_misses, stats.warm_hits, stats.prefetches, stats.wasted,
+           stats.prefetches ? (f64_t)stats.warm_hits / stats.prefetches : 0,
+           baseline_misses ? 1 - (f64_t)stats.cold_misses / baseline_misses : 0);
+
+    exitSSIDStore();
+  }
+
+  unlink(BENCH_COLD_FILE);
+}
+
+void* jitterStore(void* arg)
+{
+  u32_t i, frame;
+  u64_t start_time;
+  char ssid[SSID_SIZE];
+  static const u8_t bssid[BSSID_SIZE] = { 0x02, 0, 0, 0, 0, 0 };
+
+  while (1)
+  {
+    pthread_mutex_lock(&jitter_mutex);
+
+    while (!jitter_ready && !jitter_done)
+      pthread_cond_wait(&jitter_cond, &jitter_mutex);
+
+    if (jitter_done)
+    {
+      pthread_mutex_unlock(&jitter_mutex);
+      break;
+    }
+
+    frame = jitter_frame;
+    jitter_ready = FALSE;
+    jitter_busy = TRUE;
+
+    pthread_mutex_unlock(&jitter_mutex);
+
+    start_time = getMonotonicTime();
+
+    for (i = 0; i < BENCH_JITTER_BATCH; i++)
+    {
+      snprintf(ssid, SSID_SIZE, "ap%06u\n", (frame * BENCH_JITTER_BATCH + i) % 100000u);
+      appendLogRecord(ssid, bssid, -60, frame, 0, 0);
+    }
+
+    jitter_latencies[frame] = (getMonotonicTime() - start_time) / 1e6;
+
+    pthread_mutex_lock(&jitter_mutex);
+    jitter_busy = FALSE;
+    pthread_mutex_unlock(&jitter_mutex);
+    pthread_cond_broadcast(&jitter_cond);
+  }
+
+  return NULL;
+}
+
+int compareLatencies(const void* a, const void* b)
+{
+  f64_t x = *(const f64_t*)a;
+  f64_t y = *(const f64_t*)b;
+
+  return (x > y) - (x < y);
+}
+
+void benchmarkJitter(void)
+{
+  u8_t quiet;
+  u32_t i, spikes;
+  f64_t median;
+  char dir[] = BENCH_JITTER_DIR;
+  char cwd[256];
+  DIR* segments;
+  struct dirent* entry;
+  pthread_t store;
+  struct timespec frame_start, scan_end;
+
+  if (getcwd(cwd, sizeof(cwd)) == NULL || mkdtemp(dir) == NULL || chdir(dir) == -1)
+  {
+    perror("Could not create the benchmark directory");
+    return;
+  }
+
+  printf("flush   batch_p50_ms  batch_p99_ms  batch_max_ms  spikes\n");
+
+  for (quiet = FALSE; quiet <= TRUE; quiet++)
+  {
+    initializeFlashWriter(".", BENCH_STAGING_FILE);
+
+    jitter_ready = jitter_busy = jitter_done = FALSE;
+    (void)pthread_create(&store, NULL, jitterStore, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &frame_start);
+
+    for (i = 0; i < BENCH_JITTER_FRAMES; i++)
+    {
+      /* The scan, that publishes a batch when it ends */
+      scan_end = frame_start;
+      updateInterval(&scan_end, BENCH_JITTER_SCAN * 1000000ull);
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &scan_end, NULL);
+
+      pthread_mutex_lock(&jitter_mutex);
+      jitter_frame = i;
+      jitter_ready = TRUE;
+      pthread_cond_broadcast(&jitter_cond);
+
+      /* As flushLog does, the flush waits for the store task to be done */
+      while (quiet && (jitter_ready || jitter_busy))
+        pthread_cond_wait(&jitter_cond, &jitter_mutex);
+
+      pthread_mutex_unlock(&jitter_mutex);
+
+      pollFlashWriter(TRUE);
+
+      updateInterval(&frame_start, BENCH_JITTER_FRAME * 1000000ull);
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &frame_start, NULL);
+    }
+
+    pthread_mutex_lock(&jitter_mutex);
+    while (jitter_ready || jitter_busy)
+      pthread_cond_wait(&jitter_cond, &jitter_mutex);
+    jitter_done = TRUE;
+    pthread_mutex_unlock(&jitter_mutex);
+    pthread_cond_broadcast(&jitter_cond);
+
+    pthread_join(store, NULL);
+    exitFlashWriter();
+
+    qsort(jitter_latencies, BENCH_JITTER_FRAMES, sizeof(f64_t), compareLatencies);
+
+    median = jitter_latencies[BENCH_JITTER_FRAMES / 2];
+
+    for (i = 0, spikes = 0; i < BENCH_JITTER_FRAMES; i++)
+      spikes += (jitter_latencies[i] > BENCH_SPIKE_FACTOR * median);
+
+    printf("%-6s  %-12.3f  %-12.3f  %-12.3f  %u\n", quiet ? "quiet" : "after",
+           median, jitter_latencies[BENCH_JITTER_FRAMES * 99 / 100],
+           jitter_latencies[BENCH_JITTER_FRAMES - 1], spikes);
+  }
+
+  /* The segments of the benchmark are dropped */
+  if ((segments = opendir(".")) != NULL)
+  {
+    while ((entry = readdir(segments)) != NULL)
+      if (entry->d_name[0] != '.')
+        unlink(entry->d_name);
+
+    closedir(segments);
+  }
+
+  if (chdir(cwd) == -1 || rmdir(dir) == -1)
+    perror("Could not remove the benchmark directory");
+}
+
+void writeBenchmarkMap(struct APMapEntry* entries)
+{
+  u32_t i;
+  struct APMapHeader header;
+  FILE* file = fopen(BENCH_MAP_FILE, "wb");
+
+  memset(&header, 0, sizeof(header));
+  header.magic = AP_MAP_MAGIC;
+  header.version = AP_MAP_VERSION;
+  header.header_size = sizeof(header);
+  header.entry_size = sizeof(struct APMapEntry);
+  header.count = BENCH_MAP_SIDE * BENCH_MAP_SIDE;
+
+  /* The BSSIDs are in order, since they differ only in the last byte */
+  for (i = 0; i < header.count; i++)
+  {
+    memset(&entries[i], 0, sizeof(entries[i]));
+    entries[i].bssid[0] = 0x02;
+    entries[i].bssid[5] = i;
+    entries[i].x = (i % BENCH_MAP_SIDE) * BENCH_MAP_SPACING;
+    entries[i].y = (i / BENCH_MAP_SIDE) * BENCH_MAP_SPACING;
+    entries[i].rssi_1m = -40.0f;
+    entries[i].path_loss = 2.7f;
+    entries[i].sigma = 4.0f;
+  }
+
+  if (file != NULL)
+  {
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(entries, sizeof(struct APMapEntry), header.count, file);
+    fclose(file);
+  }
+}
+
+void benchmarkLocalizer(void)
+{
+  u32_t i, epoch, num, seed, workers;
+  u64_t start_time, elapsed, total, max;
+  f32_t angle, true_x, true_y, dx, dy, rssi, error;
+  struct APMapEntry entries[BENCH_MAP_SIDE * BENCH_MAP_SIDE];
+  struct Observation observations[BENCH_MAP_SIDE * BENCH_MAP_SIDE];
+  struct Position position;
+  const f32_t center = (BENCH_MAP_SIDE - 1) * BENCH_MAP_SPACING / 2;
+
+  writeBenchmarkMap(entries);
+
+  printf("particles  workers  ms_per_epoch  max_ms  rms_error_m\n");
+
+  for (workers = 1; workers <= LOCALIZER_MAX_WORKERS; workers *= 2)
+  {
+    initializeLocalizer(BENCH_MAP_FILE, workers);
+
+    /* The same route and noise for every number of workers */
+    seed = 2463534242u;
+    total = max = 0;
+    error = 0;
+
+    for (epoch = 0; epoch < BENCH_EPOCHS; epoch++)
+    {
+      angle = epoch * WORKLOAD_SCAN_PERIOD * BENCH_ROUTE_SPEED / BENCH_ROUTE_RADIUS;
+      true_x = center + BENCH_ROUTE_RADIUS * cosf(angle);
+      true_y = center + BENCH_ROUTE_RADIUS * sinf(angle);
+
+      for (i = 0, num = 0; i < BENCH_MAP_SIDE * BENCH_MAP_SIDE; i++)
+      {
+        dx = entries[i].x - true_x;
+        dy = entries[i].y - true_y;
+
+        if (dx * dx + dy * dy > BENCH_AP_RANGE * BENCH_AP_RANGE)
+          continue;
+
+        /* The path loss model, with gaussian noise (Box-Muller) */
+        rssi = entries[i].rssi_1m - 5.0f * entries[i].path_loss * log10f(fmaxf(dx * dx + dy * dy, 1.0f)) +
+               entries[i].sigma * sqrtf(-2.0f * logf((nextRandom(&seed) >> 8) / 16777216.0f + 1e-7f)) *
+               cosf(6.2831853f * (nextRandom(&seed) >> 8) / 16777216.0f);
+
+        memcpy(observations[num].bssid, entries[i].bssid, sizeof(entries[i].bssid));
+        observations[num].rssi = rssi;
+        num++;
+      }
+
+      start_time = getMonotonicTime();
+      localizeEpoch(observations, num, epoch * WORKLOAD_SCAN_PERIOD);
+      elapsed = getMonotonicTime() - start_time;
+
+      total += elapsed;
+      if (elapsed > max)
+        max = elapsed;
+
+      getPosition(&position);
+
+      if (epoch >= BENCH_WARMUP)
+        error += (position.x - true_x) * (position.x - true_x) +
+                 (position.y - true_y) * (position.y - true_y);
+    }
+
+    printf("%-9u  %-7u  %-12.2f  %-6.2f  %.1f\n", LOCALIZER_PARTICLES, workers,
+           total / (1e6 * BENCH_EPOCHS), max / 1e6, sqrtf(error / (BENCH_EPOCHS - BENCH_WARMUP)));
+
+    exitLocalizer();
+  }
+
+  unlink(BENCH_MAP_FILE);
+}
+
+void benchmarkTimestamp(void)
+{
+  u32_t i, source;
+  u64_t start_time, elapsed, counter_time, error, max_error = 0;
+  f64_t sum = 0;
+  f32_t timestamp_sum = 0;
+  struct timespec current_t, interval;
+  static const char* names[] = { "syscall", "vdso", "counter", "timestamp" };
+
+  printf("source     ns_per_call\n");
+
+  for (source = 0; source < 4; source++)
+  {
+    start_time = getClockTime();
+
+    for (i = 0; i < BENCH_TIMESTAMP_CALLS; i++)
+    {
+      /* The system call is what the vDSO falls back to on some kernels */
+      if (source == 0)
+        syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &current_t);
+      else if (source == 1)
+        clock_gettime(CLOCK_MONOTONIC, &current_t);
+      else if (source == 2)
+        sum += getMonotonicTime();
+      else
+        timestamp_sum += getCurrentTimestamp();
+    }
+
+    elapsed = getClockTime() - start_time;
+
+    printf("%-10s %.1f\n", names[source], (f64_t)elapsed / BENCH_TIMESTAMP_CALLS);
+  }
+
+  interval.tv_sec = 0;
+  interval.tv_nsec = BENCH_TIMESTAMP_INTERVAL * 1000000ul;
+
+  for (i = 0; i < BENCH_TIMESTAMP_SAMPLES; i++)
+  {
+    /* The counter is compared to the middle of two reads of the clock */
+    start_time = getClockTime();
+    counter_time = getMonotonicTime();
+    elapsed = getClockTime() - start_time;
+    start_time += elapsed / 2;
+    error = (counter_time > start_time) ? counter_time - start_time : start_time - counter_time;
+
+    if (error > max_error)
+      max_error = error;
+
+    nanosleep(&interval, NULL);
+  }
+
+  printf("\nmax_error_us  %.1f (%u samples over %u msecs)\n", max_error / 1e3,
+         BENCH_TIMESTAMP_SAMPLES, BENCH_TIMESTAMP_SAMPLES * BENCH_TIMESTAMP_INTERVAL);
+  printTimeSourceStats(stdout);
+
+  /* The sums only keep the calls from being optimized out */
+  if (sum < 0 || timestamp_sum < 0)
+    printf("\n");
+}
+
+/***************************** Public Functions ******************************/
+
+u8_t runBenchmark(const char* name)
+{
+  u32_t i;
+
+  for (i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++)
+  {
+    if (!strcmp(benchmarks[i].name, name))
+    {
+      benchmarks[i].run();
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
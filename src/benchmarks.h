@@ -0,0 +1,35 @@
+/**
+  * @file benchmarks.h
+  * @brief Contains the declarations of functions defined in benchmarks.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Run a microbenchmark and print its results.
+* @param name The name of the benchmark.
+* @return TRUE if the benchmark exists, FALSE otherwise.
+*/
+u8_t runBenchmark(const char* name);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* BENCHMARKS_H */
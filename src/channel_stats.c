@@ -0,0 +1,215 @@
+/**
+  * @file channel_stats.c
+  * @brief Implements the per-channel dwell time and yield instrumentation.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "metrics.h"
+
+#include "channel_stats.h"
+
+/***************************** Type Definitions ******************************/
+
+/** The rolling window of the latest scans of a channel. */
+struct ChannelWindow {
+  f32_t dwell_ms[CHANNEL_WINDOW];
+  u32_t aps[CHANNEL_WINDOW];
+
+  u32_t next, count;
+
+  u64_t total_scans;
+  u32_t skip_streak;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The channel numbers that are scanned. */
+static const u8_t channel_numbers[NUM_CHANNELS] = {
+  1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+  36, 40, 44, 48, 149, 153, 157, 161, 165
+};
+
+/** The windows of all the channels, plus the one of the full scan. */
+static struct ChannelWindow windows[NUM_CHANNELS + 1];
+
+/** Guards the windows, since they are read by the metrics writer. */
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Sum up the window of a channel.
+ * @param window The window of the channel.
+ * @param dwell_ms The total dwell time of the window.
+ * @param aps The total APs found in the window.
+ * @return Void.
+ */
+static void sumWindow(struct ChannelWindow* window, f32_t* dwell_ms, u32_t* aps);
+
+/**
+ * @brief Get the yield of a window (the stats mutex must be held).
+ * @param window The window of the channel.
+ * @return The APs found per ms of dwell time.
+ */
+static f32_t windowYield(struct ChannelWindow* window);
+
+/**
+ * @brief Print the per-channel stats.
+ * @param file The file to print the stats to.
+ * @return Void.
+ */
+static void writeChannelStats(FILE* file);
+
+/***************************** Static Functions ******************************/
+
+void sumWindow(struct ChannelWindow* window, f32_t* dwell_ms, u32_t* aps)
+{
+  u32_t i;
+
+  *dwell_ms = 0;
+  *aps = 0;
+
+  for (i = 0; i < window->count; i++)
+  {
+    *dwell_ms += window->dwell_ms[i];
+    *aps += window->aps[i];
+  }
+}
+
+f32_t windowYield(struct ChannelWindow* window)
+{
+  f32_t dwell_ms;
+  u32_t aps;
+
+  sumWindow(window, &dwell_ms, &aps);
+
+  return (dwell_ms > 0) ? (aps / dwell_ms) : 0;
+}
+
+void writeChannelStats(FILE* file)
+{
+  u32_t i;
+  f32_t dwell_ms;
+  u32_t aps;
+
+  fprintf(file, "channel  freq  scans  dwell_ms  aps  yield_aps_per_ms\n");
+
+  pthread_mutex_lock(&stats_mutex);
+
+  for (i = 0; i <= NUM_CHANNELS; i++)
+  {
+    if (windows[i].count == 0)
+      continue;
+
+    sumWindow(&windows[i], &dwell_ms, &aps);
+
+    if (i == ALL_CHANNELS)
+      fprintf(file, "all      -    ");
+    else
+      fprintf(file, "%-7u  %-4u ", channel_numbers[i], getChannelFrequency(i));
+
+    fprintf(file, " %-5llu  %-8.1f  %-3u  %.6f\n", windows[i].total_scans,
+            dwell_ms / windows[i].count, aps, windowYield(&windows[i]));
+  }
+
+  pthread_mutex_unlock(&stats_mutex);
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeChannelStats(void)
+{
+  memset(windows, 0, sizeof(windows));
+
+  registerMetricsSource("channels", writeChannelStats);
+}
+
+u16_t getChannelFrequency(u32_t channel)
+{
+  if (channel_numbers[channel] <= 13)
+    return 2407 + 5 * channel_numbers[channel];
+  else
+    return 5000 + 5 * channel_numbers[channel];
+}
+
+void recordChannelScan(u32_t channel, f32_t dwell_ms, u32_t aps)
+{
+  struct ChannelWindow* window = &windows[channel];
+
+  pthread_mutex_lock(&stats_mutex);
+
+  window->dwell_ms[window->next] = dwell_ms;
+  window->aps[window->next] = aps;
+
+  window->next++;
+
+  if (window->next == CHANNEL_WINDOW)
+    window->next = 0;
+  if (window->count < CHANNEL_WINDOW)
+    window->count++;
+
+  window->total_scans++;
+  window->skip_streak = 0;
+
+  pthread_mutex_unlock(&stats_mutex);
+}
+
+f32_t getChannelYield(u32_t channel)
+{
+  f32_t yield;
+
+  pthread_mutex_lock(&stats_mutex);
+  yield = windowYield(&windows[channel]);
+  pthread_mutex_unlock(&stats_mutex);
+
+  return yield;
+}
+
+f32_t getMeanChannelYield(void)
+{
+  u32_t i, scanned = 0;
+  f32_t yield = 0;
+
+  pthread_mutex_lock(&stats_mutex);
+
+  for (i = 0; i < NUM_CHANNELS; i++)
+  {
+    if (windows[i].count > 0)
+    {
+      yield += windowYield(&windows[i]);
+      scanned++;
+    }
+  }
+
+  pthread_mutex_unlock(&stats_mutex);
+
+  return (scanned > 0) ? (yield / scanned) : 0;
+}
+
+u8_t shouldSkipChannel(u32_t channel, f32_t min_yield)
+{
+  u8_t skip = FALSE;
+  struct ChannelWindow* window = &windows[channel];
+
+  pthread_mutex_lock(&stats_mutex);
+
+  if (window->count == CHANNEL_WINDOW &&
+      windowYield(window) < min_yield &&
+      window->skip_streak < CHANNEL_REPROBE_CYCLES)
+  {
+    window->skip_streak++;
+    skip = TRUE;
+  }
+
+  pthread_mutex_unlock(&stats_mutex);
+
+  return skip;
+}
@@ -0,0 +1,88 @@
+/**
+  * @file channel_stats.h
+  * @brief Contains the declarations of functions defined in channel_stats.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef CHANNEL_STATS_H
+#define CHANNEL_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The number of channels that can be scanned (2.4 GHz and non-DFS 5 GHz). */
+#define NUM_CHANNELS (22u)
+
+/** The pseudo-channel that accounts a scan of all the channels at once. */
+#define ALL_CHANNELS (NUM_CHANNELS)
+
+/** The number of the latest scans of a channel that its yield is based on. */
+#define CHANNEL_WINDOW (8u)
+
+/** The number of cycles a low-yield channel is skipped before it is probed
+  * again, so that a channel that became busy is eventually picked up.
+  */
+#define CHANNEL_REPROBE_CYCLES (10u)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module.
+* @return Void.
+*/
+void initializeChannelStats(void);
+
+/**
+* @brief Get the center frequency of a channel.
+* @param channel The index of the channel.
+* @return The frequency in MHz.
+*/
+u16_t getChannelFrequency(u32_t channel);
+
+/**
+* @brief Account a scan of a channel to its rolling window.
+* @param channel The index of the channel (or ALL_CHANNELS).
+* @param dwell_ms The time spent scanning the channel.
+* @param aps The number of APs found on the channel.
+* @return Void.
+*/
+void recordChannelScan(u32_t channel, f32_t dwell_ms, u32_t aps);
+
+/**
+* @brief Get the yield of a channel over its rolling window.
+* @param channel The index of the channel.
+* @return The APs found per ms of dwell time.
+*/
+f32_t getChannelYield(u32_t channel);
+
+/**
+* @brief Get the average yield of the channels that have been scanned.
+* @return The average APs found per ms of dwell time.
+*/
+f32_t getMeanChannelYield(void);
+
+/**
+* @brief Decide whether a channel should be left out of the next scan.
+* @param channel The index of the channel.
+* @param min_yield The yield under which a channel is considered low-yield.
+* @return TRUE if the channel has a full window with a low yield and it has
+*         not been skipped for CHANNEL_REPROBE_CYCLES, FALSE otherwise.
+*/
+u8_t shouldSkipChannel(u32_t channel, f32_t min_yield);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* CHANNEL_STATS_H */
@@ -0,0 +1,509 @@
+/**
+  * @file cold_tier.c
+  * @brief Implements the cold tier of the store, i.e. a file that the
+  *        evicted SSIDs are spilled to, and the warm tier in front of it,
+  *        that the SSIDs expected to be sighted next are prefetched to.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "memory_regions.h"
+
+#include "cold_tier.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The way (or warm slot) of an SSID that was not found. */
+#define NOT_FOUND (U32_MAX)
+
+/***************************** Type Definitions ******************************/
+
+/** The tag of a slot of the file, kept in memory so that a lookup reads the
+  * file only for an SSID that is there.
+  */
+struct ColdTag {
+  u32_t hash;
+  u32_t version;  /* changed on every write, so that a racing read is dropped */
+  f32_t last_seen;
+  u8_t valid;
+};
+
+/** A slot of the warm tier. */
+struct WarmSlot {
+  struct ColdEntry entry;
+  u8_t valid;
+};
+
+/** An evicted SSID that waits to be written. */
+struct QueuedSpill {
+  struct ColdEntry entry;
+  u8_t valid;  /* cleared if the SSID is promoted before it is written */
+};
+
+/** A sighted SSID that waits to be read, from the slot its tag pointed to. */
+struct QueuedPromotion {
+  char ssid[SSID_SIZE];
+  u32_t hash;
+  u32_t set, way;
+  u32_t version;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The cold tier file and the tags of its slots. */
+static s32_t cold_fd = -1;
+static struct ColdTag tags[COLD_TIER_SETS][COLD_TIER_WAYS];
+
+/** The warm tier, replaced in FIFO order. */
+static struct WarmSlot warm[WARM_TIER_CAPACITY];
+static u32_t warm_next;
+
+/** The spills and the promotions that wait for the prefetch task (rings,
+  * indexed by free-running counters).
+  */
+static struct QueuedSpill spill_queue[COLD_SPILL_QUEUE];
+static u32_t spill_head, spill_tail;
+static struct QueuedPromotion promotion_queue[COLD_PROMOTION_QUEUE];
+static u32_t promotion_head, promotion_tail;
+
+/** The counters of the tiers. */
+static struct ColdTierStats stats;
+
+/** Guards the tags, the warm tier, the queues and the counters. The store
+  * task only touches memory with the lock held; the file is written and read
+  * by the prefetch task without it.
+  */
+static pthread_mutex_t cold_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the offset of a slot in the file.
+ * @param set The set of the slot.
+ * @param way The way of the slot.
+ * @return The offset.
+ */
+static off_t slotOffset(u32_t set, u32_t way);
+
+/**
+ * @brief Find the way of a set that holds an SSID.
+ * @param set The set.
+ * @param hash The hash of the SSID.
+ * @return The way, or NOT_FOUND.
+ */
+static u32_t findWay(u32_t set, u32_t hash);
+
+/**
+ * @brief Find the slot of the warm tier that holds an SSID.
+ * @param hash The hash of the SSID.
+ * @return The slot, or NOT_FOUND.
+ */
+static u32_t findWarm(u32_t hash);
+
+/**
+ * @brief Read a slot of the file.
+ * @param set The set of the slot.
+ * @param way The way of the slot.
+ * @param entry The SSID of the slot.
+ * @return TRUE if it was read, FALSE otherwise.
+ */
+static u8_t readSlot(u32_t set, u32_t way, struct ColdEntry* entry);
+
+/**
+ * @brief Write the queued spills to the file. Called with the lock held,
+ *        which is released while a slot is written.
+ * @return Void.
+ */
+static void writeSpills(void);
+
+/**
+ * @brief Read the queued promotions from the file, and restore their
+ *        timestamps to the store. Called with the lock held, which is
+ *        released while a slot is read and the store is updated.
+ * @return Void.
+ */
+static void readPromotions(void);
+
+/***************************** Static Functions ******************************/
+
+off_t slotOffset(u32_t set, u32_t way)
+{
+  return ((off_t)set * COLD_TIER_WAYS + way) * sizeof(struct ColdEntry);
+}
+
+u32_t findWay(u32_t set, u32_t hash)
+{
+  u32_t way;
+
+  for (way = 0; way < COLD_TIER_WAYS; way++)
+  {
+    if (tags[set][way].valid && tags[set][way].hash == hash)
+      return way;
+  }
+
+  return NOT_FOUND;
+}
+
+u32_t findWarm(u32_t hash)
+{
+  u32_t i;
+
+  for (i = 0; i < WARM_TIER_CAPACITY; i++)
+  {
+    if (warm[i].valid && warm[i].entry.hash == hash)
+      return i;
+  }
+
+  return NOT_FOUND;
+}
+
+u8_t readSlot(u32_t set, u32_t way, struct ColdEntry* entry)
+{
+  return pread(cold_fd, entry, sizeof(struct ColdEntry), slotOffset(set, way)) ==
+         sizeof(struct ColdEntry);
+}
+
+void writeSpills(void)
+{
+  u32_t set, way, oldest;
+  u8_t written;
+  struct ColdEntry entry;
+  struct QueuedSpill* spill;
+  struct ColdTag* tag;
+
+  for (; spill_tail != spill_head; spill_tail++)
+  {
+    spill = &spill_queue[spill_tail % COLD_SPILL_QUEUE];
+
+    if (!spill->valid)
+      continue;
+
+    entry = spill->entry;
+    set = entry.hash % COLD_TIER_SETS;
+    oldest = 0;
+
+    /* The SSID replaces its older copy, or an empty slot, or else the SSID
+     * of the set that was seen the longest ago.
+     */
+    if ((way = findWay(set, entry.hash)) == NOT_FOUND)
+    {
+      for (way = 0; way < COLD_TIER_WAYS && tags[set][way].valid; way++)
+      {
+        if (tags[set][way].last_seen < tags[set][oldest].last_seen)
+          oldest = way;
+      }
+
+      if (way == COLD_TIER_WAYS)
+        way = oldest;
+    }
+
+    /* The slot is invalid while it is written, so that it is not read */
+    tag = &tags[set][way];
+    tag->valid = FALSE;
+    tag->version++;
+
+    pthread_mutex_unlock(&cold_mutex);
+
+    written = pwrite(cold_fd, &entry, sizeof(struct ColdEntry), slotOffset(set, way)) ==
+              sizeof(struct ColdEntry);
+
+    if (!written)
+      perror("Could not write to the cold tier file");
+
+    pthread_mutex_lock(&cold_mutex);
+
+    /* An SSID promoted from the queue meanwhile is not valid in the file */
+    if (written && spill->valid)
+    {
+      tag->hash = entry.hash;
+      tag->last_seen = entry.timestamps[(entry.num_timestamps - 1) % STORE_HISTORY];
+      tag->valid = TRUE;
+      stats.spills++;
+    }
+
+    spill->valid = FALSE;
+  }
+}
+
+void readPromotions(void)
+{
+  u8_t read;
+  struct ColdEntry entry;
+  struct QueuedPromotion promotion;
+
+  for (; promotion_tail != promotion_head; promotion_tail++)
+  {
+    promotion = promotion_queue[promotion_tail % COLD_PROMOTION_QUEUE];
+
+    /* The slot was rewritten since the SSID was sighted */
+    if (!tags[promotion.set][promotion.way].valid ||
+        tags[promotion.set][promotion.way].version != promotion.version)
+      continue;
+
+    pthread_mutex_unlock(&cold_mutex);
+
+    read = readSlot(promotion.set, promotion.way, &entry) && !strcmp(entry.ssid, promotion.ssid);
+
+    pthread_mutex_lock(&cold_mutex);
+
+    if (!read || tags[promotion.set][promotion.way].version != promotion.version)
+      continue;
+
+    /* The SSID moved back to the store, so its copy is dropped (only from
+     * the tags, since the file is emptied on the next boot anyway).
+     */
+    tags[promotion.set][promotion.way].valid = FALSE;
+    tags[promotion.set][promotion.way].version++;
+    stats.cold_misses++;
+
+    pthread_mutex_unlock(&cold_mutex);
+
+    restoreSSIDHistory(&entry);
+
+    pthread_mutex_lock(&cold_mutex);
+  }
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeColdTier(const char* path)
+{
+  if ((cold_fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) == -1)
+  {
+    perror("Could not open the cold tier file");
+    exit(-11);
+  }
+
+  if (ftruncate(cold_fd, slotOffset(COLD_TIER_SETS, 0)) == -1)
+  {
+    perror("Could not resize the cold tier file");
+    exit(-11);
+  }
+
+  memset(tags, 0, sizeof(tags));
+  memset(warm, 0, sizeof(warm));
+  memset(&stats, 0, sizeof(stats));
+  warm_next = 0;
+  spill_head = spill_tail = 0;
+  promotion_head = promotion_tail = 0;
+
+  /* The store task looks them up on every miss; only the file is pageable */
+  lockMemoryRegion("cold tags", tags, sizeof(tags));
+  lockMemoryRegion("warm tier", warm, sizeof(warm));
+  lockMemoryRegion("cold spills", spill_queue, sizeof(spill_queue));
+  lockMemoryRegion("cold promos", promotion_queue, sizeof(promotion_queue));
+}
+
+void exitColdTier(void)
+{
+  u32_t i;
+
+  if (cold_fd != -1)
+  {
+    pthread_mutex_lock(&cold_mutex);
+
+    for (i = 0; i < WARM_TIER_CAPACITY; i++)
+    {
+      if (warm[i].valid)
+        stats.wasted++;
+
+      warm[i].valid = FALSE;
+    }
+
+    pthread_mutex_unlock(&cold_mutex);
+
+    close(cold_fd);
+    releaseMemoryRegion(tags);
+    releaseMemoryRegion(warm);
+    releaseMemoryRegion(spill_queue);
+    releaseMemoryRegion(promotion_queue);
+  }
+
+  cold_fd = -1;
+}
+
+u8_t isColdTierOpen(void)
+{
+  return cold_fd != -1;
+}
+
+void spillColdEntry(const struct ColdEntry* entry)
+{
+  u32_t slot;
+
+  pthread_mutex_lock(&cold_mutex);
+
+  /* A prefetched copy of the SSID is stale, since it was promoted again */
+  if ((slot = findWarm(entry->hash)) != NOT_FOUND)
+  {
+    warm[slot].valid = FALSE;
+    stats.wasted++;
+  }
+
+  if (spill_head - spill_tail < COLD_SPILL_QUEUE)
+  {
+    spill_queue[spill_head % COLD_SPILL_QUEUE].entry = *entry;
+    spill_queue[spill_head % COLD_SPILL_QUEUE].valid = TRUE;
+    spill_head++;
+  }
+  else
+    stats.dropped++;
+
+  pthread_mutex_unlock(&cold_mutex);
+}
+
+u8_t promoteColdEntry(u32_t hash, const char* ssid, struct ColdEntry* entry)
+{
+  u8_t tier = STORE_TIER_NEW;
+  u32_t set = hash % COLD_TIER_SETS;
+  u32_t way, slot, i;
+  struct QueuedSpill* spill;
+  struct QueuedPromotion* promotion;
+
+  pthread_mutex_lock(&cold_mutex);
+
+  if ((slot = findWarm(hash)) != NOT_FOUND && !strcmp(warm[slot].entry.ssid, ssid))
+  {
+    *entry = warm[slot].entry;
+    warm[slot].valid = FALSE;
+    stats.warm_hits++;
+    tier = STORE_TIER_WARM;
+  }
+
+  /* An SSID sighted again before its spill was written */
+  for (i = spill_head; i != spill_tail && tier == STORE_TIER_NEW; i--)
+  {
+    spill = &spill_queue[(i - 1) % COLD_SPILL_QUEUE];
+
+    if (spill->valid && spill->entry.hash == hash && !strcmp(spill->entry.ssid, ssid))
+    {
+      *entry = spill->entry;
+      spill->valid = FALSE;
+      stats.queued_hits++;
+      tier = STORE_TIER_WARM;
+    }
+  }
+
+  /* The SSID moves back to the store, so its copy is dropped (only from the
+   * tags, since the file is emptied on the next boot anyway).
+   */
+  if (tier == STORE_TIER_WARM && (way = findWay(set, hash)) != NOT_FOUND)
+  {
+    tags[set][way].valid = FALSE;
+    tags[set][way].version++;
+  }
+
+  /* An SSID in the file is read by the prefetch task */
+  if (tier == STORE_TIER_NEW && (way = findWay(set, hash)) != NOT_FOUND)
+  {
+    if (promotion_head - promotion_tail < COLD_PROMOTION_QUEUE)
+    {
+      promotion = &promotion_queue[promotion_head % COLD_PROMOTION_QUEUE];
+      strcpy(promotion->ssid, ssid);
+      promotion->hash = hash;
+      promotion->set = set;
+      promotion->way = way;
+      promotion->version = tags[set][way].version;
+      promotion_head++;
+
+      tier = STORE_TIER_COLD;
+    }
+    else
+      stats.dropped++;
+  }
+
+  pthread_mutex_unlock(&cold_mutex);
+
+  return tier;
+}
+
+u8_t prefetchColdEntry(u32_t hash)
+{
+  u32_t set = hash % COLD_TIER_SETS;
+  u32_t way, version;
+  struct ColdEntry entry;
+
+  pthread_mutex_lock(&cold_mutex);
+
+  if (findWarm(hash) != NOT_FOUND || (way = findWay(set, hash)) == NOT_FOUND)
+  {
+    pthread_mutex_unlock(&cold_mutex);
+    return FALSE;
+  }
+
+  version = tags[set][way].version;
+
+  pthread_mutex_unlock(&cold_mutex);
+
+  if (!readSlot(set, way, &entry))
+    return FALSE;
+
+  pthread_mutex_lock(&cold_mutex);
+
+  /* The slot was rewritten or promoted while it was read */
+  if (!tags[set][way].valid || tags[set][way].version != version || findWarm(hash) != NOT_FOUND)
+  {
+    pthread_mutex_unlock(&cold_mutex);
+    return FALSE;
+  }
+
+  if (warm[warm_next].valid)
+    stats.wasted++;
+
+  warm[warm_next].entry = entry;
+  warm[warm_next].valid = TRUE;
+  warm_next = (warm_next + 1) % WARM_TIER_CAPACITY;
+
+  stats.prefetches++;
+
+  pthread_mutex_unlock(&cold_mutex);
+
+  return TRUE;
+}
+
+void serviceColdTier(void)
+{
+  pthread_mutex_lock(&cold_mutex);
+
+  /* The spills first, since a promotion may be for an SSID spilled before */
+  writeSpills();
+  readPromotions();
+
+  pthread_mutex_unlock(&cold_mutex);
+}
+
+void getColdTierStats(struct ColdTierStats* cold_stats)
+{
+  pthread_mutex_lock(&cold_mutex);
+  *cold_stats = stats;
+  pthread_mutex_unlock(&cold_mutex);
+}
+
+void printColdTierStats(FILE* file)
+{
+  struct ColdTierStats cold_stats;
+
+  getColdTierStats(&cold_stats);
+
+  fprintf(file, "spills         %llu\n", cold_stats.spills);
+  fprintf(file, "cold_misses    %llu\n", cold_stats.cold_misses);
+  fprintf(file, "warm_hits      %llu\n", cold_stats.warm_hits);
+  fprintf(file, "prefetches     %llu\n", cold_stats.prefetches);
+  fprintf(file, "wasted         %llu\n", cold_stats.wasted);
+  fprintf(file, "queued_hits    %llu\n", cold_stats.queued_hits);
+  fprintf(file, "dropped        %llu\n", cold_stats.dropped);
+  fprintf(file, "accuracy       %.4f\n", cold_stats.prefetches ?
+          (f64_t)cold_stats.warm_hits / cold_stats.prefetches : 0);
+  fprintf(file, "miss_reduction %.4f\n", (cold_stats.warm_hits + cold_stats.cold_misses) ?
+          (f64_t)cold_stats.warm_hits / (cold_stats.warm_hits + cold_stats.cold_misses) : 0);
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+/**
+  * @file cold_tier.h
+  * @brief Contains the declarations of functions defined in cold_tier.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef COLD_TIER_H
+#define COLD_TIER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+#include "ssid_store.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The cold tier is a set-associative table of the evicted SSIDs: the set
+  * of an SSID is chosen by its hash, and a set is replaced by the SSID that
+  * was seen the longest ago.
+  */
+#define COLD_TIER_SETS (4096u)
+#define COLD_TIER_WAYS (4u)
+
+/** The number of SSIDs that are prefetched from the cold tier and kept in
+  * memory (the warm tier) until they are sighted.
+  */
+#define WARM_TIER_CAPACITY (64u)
+
+/** The max number of evicted SSIDs, and of sighted cold SSIDs, that wait for
+  * the prefetch task to write them to (or read them from) the file.
+  */
+#define COLD_SPILL_QUEUE     (256u)
+#define COLD_PROMOTION_QUEUE (128u)
+
+/***************************** Type Definitions ******************************/
+
+/** An evicted SSID, along with its latest timestamps. */
+struct ColdEntry {
+  char ssid[SSID_SIZE];
+  u32_t hash;
+  u32_t num_timestamps;  /* 0 if the slot is empty */
+  f32_t timestamps[STORE_HISTORY];
+  f32_t latencies[STORE_HISTORY];
+};
+
+/** The counters of the cold and warm tiers. */
+struct ColdTierStats {
+  u64_t spills;
+  u64_t warm_hits;    /* SSIDs sighted after they were prefetched */
+  u64_t cold_misses;  /* SSIDs read from the file when they were sighted */
+  u64_t prefetches;   /* SSIDs loaded to the warm tier */
+  u64_t wasted;       /* prefetched SSIDs dropped before they were sighted */
+  u64_t queued_hits;  /* SSIDs sighted before their spill was written */
+  u64_t dropped;      /* spills and promotions dropped since a queue was full */
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Create the cold tier file. It is emptied, since the timestamps of
+*        a previous boot are not comparable to the current ones.
+* @param path The cold tier file.
+* @return Void.
+*/
+void initializeColdTier(const char* path);
+
+/**
+* @brief Close the cold tier file and drop the warm tier (the SSIDs left in it
+*        count as wasted).
+* @return Void.
+*/
+void exitColdTier(void);
+
+/**
+* @brief Check whether the cold tier is open.
+* @return TRUE if it is open, FALSE otherwise.
+*/
+u8_t isColdTierOpen(void);
+
+/**
+* @brief Queue an SSID that is evicted from the store, to be written to the
+*        cold tier file by the prefetch task. It does not block on the file.
+* @param entry The SSID.
+* @return Void.
+*/
+void spillColdEntry(const struct ColdEntry* entry);
+
+/**
+* @brief Take a sighted SSID out of the warm tier or the spill queue or, if
+*        it is in the cold tier file, queue it to be read by the prefetch
+*        task, which restores its timestamps to the store. It does not block
+*        on the file.
+* @param hash The hash of the SSID.
+* @param ssid The SSID.
+* @param entry The SSID, along with its timestamps (only if it is warm).
+* @return STORE_TIER_WARM if it was in memory, STORE_TIER_COLD if it was
+*         queued to be read, STORE_TIER_NEW otherwise.
+*/
+u8_t promoteColdEntry(u32_t hash, const char* ssid, struct ColdEntry* entry);
+
+/**
+* @brief Write the queued spills to the cold tier file, and read the queued
+*        promotions from it (on the prefetch task). The file is accessed
+*        without holding the lock of the tiers.
+* @return Void.
+*/
+void serviceColdTier(void);
+
+/**
+* @brief Load an SSID from the cold tier file to the warm tier, ahead of its
+*        sighting. The file is read without holding the lock of the tiers.
+* @param hash The hash of the SSID.
+* @return TRUE if it was loaded, FALSE if it is not in the cold tier or it is
+*         already warm.
+*/
+u8_t prefetchColdEntry(u32_t hash);
+
+/**
+* @brief Get the counters of the tiers.
+* @param stats The counters.
+* @return Void.
+*/
+void getColdTierStats(struct ColdTierStats* stats);
+
+/**
+* @brief Print the counters of the tiers, along with the prefetch accuracy
+*        and the share of the cold misses that the prefetches avoided.
+* @param file The file to print to.
+* @return Void.
+*/
+void printColdTierStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* COLD_TIER_H */
\ No newline at end of file
@@ -0,0 +1,220 @@
+/**
+  * @file cyclic_executive.c
+  * @brief Implements a frame-based cyclic executive, that runs multiple
+  *        periodic activities in a single thread, driven by a timerfd.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+
+#include "time_helpers.h"
+#include "phase_controller.h"
+
+#include "cyclic_executive.h"
+
+/***************************** Static Variables ******************************/
+
+/** The frame table. */
+static struct Activity* frame_activities;
+static u32_t activity_num;
+static const struct MinorFrame* frame_table;
+static u32_t frame_num;
+static u64_t frame_length;
+
+/** The start of the current minor frame, and whether its phased activity is
+  * still to run.
+  */
+static struct timespec* current_frame;
+static u8_t phase_pending;
+
+/** The counters of the executive. */
+static u64_t minor_frames;
+static u64_t frame_overruns;
+
+/** Guards the counters, since they are reported from other tasks. */
+static pthread_mutex_t executive_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Run the activities of a minor frame, accounting their time.
+ * @param frame The minor frame.
+ * @return Void.
+ */
+static void runMinorFrame(const struct MinorFrame* frame);
+
+/***************************** Static Functions ******************************/
+
+void runMinorFrame(const struct MinorFrame* frame)
+{
+  u32_t i;
+  u64_t start_time, elapsed;
+  struct Activity* activity;
+
+  phase_pending = FALSE;
+  for (i = 0; i < frame->num; i++)
+    phase_pending |= frame_activities[frame->activities[i]].phased;
+
+  for (i = 0; i < frame->num; i++)
+  {
+    activity = &frame_activities[frame->activities[i]];
+
+    if (activity->phased)
+    {
+      waitForPhase(current_frame);
+      phase_pending = FALSE;
+    }
+
+    start_time = getMonotonicTime();
+    activity->run();
+    elapsed = getMonotonicTime() - start_time;
+
+    if (activity->phased)
+      recordPhasedScan(current_frame, start_time, start_time + elapsed);
+
+    pthread_mutex_lock(&executive_mutex);
+
+    activity->runs++;
+
+    if (elapsed > activity->max_time)
+      activity->max_time = elapsed;
+    if (elapsed > activity->budget)
+      activity->overruns++;
+
+    pthread_mutex_unlock(&executive_mutex);
+  }
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeCyclicExecutive(struct Activity* activities, u32_t num_activities,
+                               const struct MinorFrame* frames, u32_t num_frames,
+                               u64_t minor_frame)
+{
+  u32_t i, j;
+  u64_t load;
+
+  frame_activities = activities;
+  activity_num = num_activities;
+  frame_table = frames;
+  frame_num = num_frames;
+  frame_length = minor_frame;
+
+  /* Offline check of the frame table */
+  for (i = 0; i < frame_num; i++)
+  {
+    load = 0;
+
+    for (j = 0; j < frame_table[i].num; j++)
+      load += frame_activities[frame_table[i].activities[j]].budget;
+
+    if (load > frame_length)
+    {
+      fprintf(stderr, "Minor frame %u needs %llu ms, but it is %llu ms long\n",
+              i, load / 1000000ull, frame_length / 1000000ull);
+      perror("The frame table does not fit in the minor frame");
+      exit(-8);
+    }
+  }
+
+  minor_frames = 0;
+  frame_overruns = 0;
+}
+
+void runCyclicExecutive(struct timespec* frame_timer)
+{
+  s32_t fd;
+  u64_t expirations;
+  struct itimerspec timer_spec;
+
+  if ((fd = timerfd_create(CLOCK_MONOTONIC, 0)) == -1)
+  {
+    perror("Could not create the frame timer");
+    exit(-8);
+  }
+
+  current_frame = frame_timer;
+
+  /* The first minor frame starts right away */
+  runMinorFrame(&frame_table[0]);
+  minor_frames++;
+
+  updateInterval(frame_timer, frame_length);
+
+  timer_spec.it_value = *frame_timer;
+  timer_spec.it_interval.tv_sec = frame_length / NSEC_PER_SEC;
+  timer_spec.it_interval.tv_nsec = frame_length % NSEC_PER_SEC;
+
+  if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &timer_spec, NULL) == -1)
+  {
+    perror("Could not start the frame timer");
+    exit(-8);
+  }
+
+  while (1)
+  {
+    if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+      continue;
+
+    /* More than one expiration means that whole frames were missed */
+    if (expirations > 1)
+    {
+      pthread_mutex_lock(&executive_mutex);
+      frame_overruns += expirations - 1;
+      pthread_mutex_unlock(&executive_mutex);
+
+      minor_frames += expirations - 1;
+      updateInterval(frame_timer, (expirations - 1) * frame_length);
+    }
+
+    runMinorFrame(&frame_table[minor_frames % frame_num]);
+
+    minor_frames++;
+    updateInterval(frame_timer, frame_length);
+  }
+}
+
+u64_t getFrameTimeLeft(void)
+{
+  u64_t frame_end, now = getMonotonicTime();
+
+  if (current_frame == NULL)
+    return 0;
+
+  /* Without an offset (yet), the phased activity is not waited for */
+  frame_end = (u64_t)current_frame->tv_sec * NSEC_PER_SEC + current_frame->tv_nsec +
+              ((phase_pending && getPhaseOffset() > 0) ? getPhaseOffset() : frame_length);
+
+  return (frame_end > now) ? (frame_end - now) : 0;
+}
+
+void printExecutiveStats(FILE* file)
+{
+  u32_t i;
+  struct Activity* activity;
+
+  pthread_mutex_lock(&executive_mutex);
+
+  fprintf(file, "minor_frames    %llu\n", minor_frames);
+  fprintf(file, "frame_overruns  %llu\n", frame_overruns);
+  fprintf(file, "activity   runs      overruns  budget_ms  max_ms\n");
+
+  for (i = 0; i < activity_num; i++)
+  {
+    activity = &frame_activities[i];
+
+    fprintf(file, "%-10s %-9llu %-9llu %-10.1f %.1f\n", activity->name, activity->runs,
+            activity->overruns, activity->budget / 1e6, activity->max_time / 1e6);
+  }
+
+  pthread_mutex_unlock(&executive_mutex);
+}
@@ -0,0 +1,95 @@
+/**
+  * @file cyclic_executive.h
+  * @brief Contains the declarations of functions defined in cyclic_executive.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef CYCLIC_EXECUTIVE_H
+#define CYCLIC_EXECUTIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max number of activities that run in a minor frame. */
+#define MAX_FRAME_ACTIVITIES (4u)
+
+/***************************** Type Definitions ******************************/
+
+/** A periodic activity, along with the time it is allowed to run for, and
+  * whether it is started at the phase offset of its frame (instead of right
+  * after the activities before it).
+  */
+struct Activity {
+  const char* name;
+  void (*run)(void);
+  u64_t budget;  /* nsecs */
+  u8_t phased;
+
+  u64_t runs, overruns;
+  u64_t max_time;
+};
+
+/** A minor frame, i.e. the activities that run (in order) in it. */
+struct MinorFrame {
+  u32_t activities[MAX_FRAME_ACTIVITIES];
+  u32_t num;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the executive with its static frame table, and check that
+*        the budgets of every minor frame fit in it (exits otherwise).
+* @param activities The activities.
+* @param num_activities The number of activities.
+* @param frames The frame table, i.e. the minor frames of a major frame.
+* @param num_frames The number of minor frames.
+* @param minor_frame The length of a minor frame (in nsecs).
+* @return Void.
+*/
+void initializeCyclicExecutive(struct Activity* activities, u32_t num_activities,
+                               const struct MinorFrame* frames, u32_t num_frames,
+                               u64_t minor_frame);
+
+/**
+* @brief Run the frame table forever, one minor frame per timer expiration.
+* @param frame_timer The start of the first minor frame. It is updated with
+*        the start of each minor frame.
+* @return Void.
+*/
+void runCyclicExecutive(struct timespec* frame_timer);
+
+/**
+* @brief Get the time left until the next minor frame, or until the phase
+*        offset if a phased activity of the frame is still to run. It is
+*        meant for the activities, that run in the thread of the executive.
+* @return The time left (in nsecs), or 0 if the next minor frame is due.
+*/
+u64_t getFrameTimeLeft(void);
+
+/**
+* @brief Print the timing of the activities and the frame overruns.
+* @param file The file to print to.
+* @return Void.
+*/
+void printExecutiveStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* CYCLIC_EXECUTIVE_H */
@@ -0,0 +1,803 @@
+/**
+  * @file flash_writer.c
+  * @brief Implements a write scheduler that stages the log records in RAM and
+  *        writes them to flash in large, aligned appends, within a budget.
+  *        The staging buffer is a file-backed shared mapping (on tmpfs), so
+  *        that the staged records survive a crash of the process.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "time_helpers.h"
+#include "memory_regions.h"
+
+#include "flash_writer.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The size of the staging buffer. */
+#define STAGING_SIZE (STAGING_BLOCKS * ERASE_BLOCK_SIZE)
+
+/** The staged bytes from which everything is flushed in a quiet window, so
+  * that the store task rarely has to wait for the buffer to be flushed.
+  */
+#define STAGING_HIGH_WATER (STAGING_SIZE - ERASE_BLOCK_SIZE)
+
+/** The magic number that identifies a valid staging file. */
+#define STAGING_MAGIC (0x47545353u)
+
+/** The max size of the path of a segment. */
+#define PATH_SIZE (256u)
+
+/***************************** Type Definitions ******************************/
+
+/** The state of the staging buffer: the log segment that is being written,
+  * the staged bytes (from head to tail) and their offset in the segment, and
+  * the staged bytes that end the segment when the next segment has already
+  * been staged after them (0 otherwise).
+  */
+struct StagingState {
+  u32_t segment_id;
+  u32_t segment_end;
+  u32_t head;
+  u32_t tail;
+  u64_t segment_offset;
+};
+
+/** The layout of the staging file. The state is published to the other of
+  * two slots, so that a crash never leaves it half updated. A record that
+  * does not fit in the rest of a segment is replaced by padding and followed
+  * by the header of the next segment, so some slack is left for both. The
+  * staged records belong to the log directory that the file names.
+  */
+struct StagingImage {
+  u32_t magic;
+  u32_t size;
+  u32_t index;
+  u32_t reserved;
+  struct StagingState state[2];
+  char log_dir[LOG_DIR_SIZE];
+  u8_t data[STAGING_SIZE + MAX_RECORD_SIZE + sizeof(struct SegmentHeader)];
+};
+
+/***************************** Static Variables ******************************/
+
+/** The staging file, and the state of the buffer (that is published to it). */
+static struct StagingImage* image;
+static struct StagingState stage;
+static u64_t at_risk_since;
+
+/** The wall-clock time of the boot of the records of the staged segment (0
+  * for the current boot).
+  */
+static f64_t segment_base;
+
+/** The directory of the log, and the file of the segment that is being
+  * written.
+  */
+static char log_dir[LOG_DIR_SIZE];
+static s32_t segment_fd = -1;
+
+/** Whether the store task waits for the buffer to be flushed. */
+static u8_t staging_full;
+static pthread_cond_t staging_flushed = PTHREAD_COND_INITIALIZER;
+
+/** The bytes that may still be written to flash. */
+static f64_t budget;
+static u64_t budget_time;
+
+/** The counters of the writer. */
+static u64_t start_time;
+static u64_t logical_bytes;
+static u64_t flash_bytes;
+static u64_t programmed_bytes;
+static u64_t flushes, partial_flushes, forced_flushes, deferred_polls, budget_overruns;
+static u64_t sealed_segments;
+static u64_t full_waits;
+static u64_t recovered_bytes, lost_bytes;
+static u64_t checkpoint_bytes;
+
+/** Guards the writer, since it is flushed and reported from other tasks. */
+static pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the path of a segment.
+ * @param path The path of the segment.
+ * @param id The id of the segment.
+ * @param sealed Whether the segment is sealed or still being written.
+ * @return Void.
+ */
+static void segmentPath(char* path, u32_t id, u8_t sealed);
+
+/**
+ * @brief Seal the segments left open (by a crash), or drop them if they have
+ *        no records, and find the next id.
+ * @param resume Whether the segment of the staging state is resumed (so it
+ *        is left open).
+ * @return The id of the next segment.
+ */
+static u32_t recoverSegments(u8_t resume);
+
+/**
+ * @brief Map the staging file, and reset it unless it is valid.
+ * @param path The staging file.
+ * @return Whether the file is valid (so its state can be recovered).
+ */
+static u8_t mapStagingFile(const char* path);
+
+/**
+ * @brief Publish the state of the buffer to the staging file.
+ * @return Void.
+ */
+static void publishState(void);
+
+/**
+ * @brief Write the records that were staged before a crash to their segment
+ *        (skipping those that had already been written) and seal it.
+ * @return Void.
+ */
+static void recoverStaged(void);
+
+/**
+ * @brief Open the file of the current segment.
+ * @return Void.
+ */
+static void openSegmentFile(void);
+
+/**
+ * @brief Stage the header of a segment.
+ * @param id The id of the segment.
+ * @param realtime_base The wall-clock time of the boot of the records of the
+ *        segment, or 0 for the current boot.
+ * @return Void.
+ */
+static void stageSegmentHeader(u32_t id, f64_t realtime_base);
+
+/**
+ * @brief End the staged segment (before it is full) and stage the next one,
+ *        for the records of another boot.
+ * @param realtime_base The wall-clock time of the boot of the records of the
+ *        next segment, or 0 for the current boot.
+ * @return Void.
+ */
+static void startSegment(f64_t realtime_base);
+
+/**
+ * @brief Close the segment and mark it as sealed, or drop it if it has no
+ *        records (e.g. of a run that exited while it started).
+ * @return Void.
+ */
+static void sealSegment(void);
+
+/**
+ * @brief Refill the budget for the time that has passed.
+ * @param now The current time (in nsecs).
+ * @return Void.
+ */
+static void refillBudget(u64_t now);
+
+/**
+ * @brief Get the staged bytes that end on an erase block boundary.
+ * @return The bytes that can be flushed as whole, aligned blocks.
+ */
+static u32_t alignedBytes(void);
+
+/**
+ * @brief Write the first staged bytes to the current segment.
+ * @param bytes The number of bytes to be written.
+ * @return Void.
+ */
+static void writeStaged(u32_t bytes);
+
+/**
+ * @brief Write the first staged bytes to flash, moving on to the next
+ *        segment if they end the current one.
+ * @param bytes The number of bytes to be written.
+ * @param partial Whether the write is partial (not aligned to a block).
+ * @return Void.
+ */
+static void flushStaged(u32_t bytes, u8_t partial);
+
+/***************************** Static Functions ******************************/
+
+void segmentPath(char* path, u32_t id, u8_t sealed)
+{
+  snprintf(path, PATH_SIZE, "%s/ssids_%08u.%s", log_dir, id, sealed ? "seg" : "open");
+}
+
+u32_t recoverSegments(u8_t resume)
+{
+  u32_t id, next_id = 0;
+  char extension[8];
+  char path[PATH_SIZE], sealed_path[PATH_SIZE];
+  struct stat info;
+  struct dirent* entry;
+  DIR* dir = opendir(log_dir);
+
+  if (dir == NULL)
+  {
+    perror("Could not open the log directory");
+    exit(-7);
+  }
+
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (sscanf(entry->d_name, "ssids_%08u.%7s", &id, extension) != 2)
+      continue;
+
+    if (!strcmp(extension, "open") && !(resume && id == stage.segment_id))
+    {
+      segmentPath(path, id, FALSE);
+      segmentPath(sealed_path, id, TRUE);
+
+      if (!stat(path, &info) && (u64_t)info.st_size <= sizeof(struct SegmentHeader))
+        unlink(path);
+      else
+        rename(path, sealed_path);
+    }
+
+    if (id + 1 > next_id)
+      next_id = id + 1;
+  }
+
+  closedir(dir);
+
+  return next_id;
+}
+
+u8_t mapStagingFile(const char* path)
+{
+  s32_t fd;
+
+  if ((fd = open(path, O_RDWR | O_CREAT, 0644)) == -1)
+  {
+    perror("Could not open the staging file");
+    exit(-7);
+  }
+
+  if (ftruncate(fd, sizeof(struct StagingImage)) == -1)
+  {
+    perror("Could not resize the staging file");
+    exit(-7);
+  }
+
+  image = mmap(NULL, sizeof(struct StagingImage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (image == MAP_FAILED)
+  {
+    perror("Could not map the staging file");
+    exit(-7);
+  }
+
+  lockMemoryRegion("staging", image, sizeof(struct StagingImage));
+
+  if (image->magic == STAGING_MAGIC && image->size == sizeof(struct StagingImage))
+    return TRUE;
+
+  memset(image, 0, sizeof(struct StagingImage));
+  image->magic = STAGING_MAGIC;
+  image->size = sizeof(struct StagingImage);
+
+  return FALSE;
+}
+
+void publishState(void)
+{
+  u32_t next = image->index ^ 1;
+
+  image->state[next] = stage;
+
+  /* The state (and the bytes it covers) must be complete before it is used */
+  __sync_synchronize();
+  image->index = next;
+}
+
+void recoverStaged(void)
+{
+  u64_t size = 0, skip;
+  char path[PATH_SIZE];
+  struct stat info;
+
+  segmentPath(path, stage.segment_id, FALSE);
+
+  if ((segment_fd = open(path, O_WRONLY)) != -1)
+    size = lseek(segment_fd, 0, SEEK_END);
+  else
+  {
+    /* The segment was sealed after its end was written, but before the state
+     * was published.
+     */
+    segmentPath(path, stage.segment_id, TRUE);
+
+    if (stage.segment_end && !stat(path, &info) &&
+        (u64_t)info.st_size == stage.segment_offset + stage.segment_end)
+    {
+      stage.head += stage.segment_end;
+      stage.segment_end = 0;
+      stage.segment_id++;
+      openSegmentFile();
+    }
+  }
+
+  /* The segment has to end where the staged bytes start, or within them (the
+   * first ones had been written), otherwise they cannot be placed.
+   */
+  if (segment_fd == -1 || size < stage.segment_offset ||
+      size > stage.segment_offset + (stage.tail - stage.head))
+  {
+    fprintf(stderr, "The staged records could not be recovered\n");
+    lost_bytes = stage.tail - stage.head;
+
+    if (segment_fd != -1)
+      sealSegment();
+
+    return;
+  }
+
+  skip = size - stage.segment_offset;
+  stage.head += skip;
+  stage.segment_offset = size;
+
+  if (stage.segment_end && skip && (stage.segment_end -= skip) == 0)
+  {
+    sealSegment();
+    openSegmentFile();
+  }
+
+  recovered_bytes = stage.tail - stage.head;
+
+  if (stage.tail > stage.head)
+    flushStaged(stage.tail - stage.head, TRUE);
+
+  /* The records of this boot start a new segment, with its own time base */
+  sealSegment();
+}
+
+void openSegmentFile(void)
+{
+  char path[PATH_SIZE];
+
+  segmentPath(path, stage.segment_id, FALSE);
+
+  if ((segment_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1)
+  {
+    perror("Could not open the log segment");
+    exit(-7);
+  }
+
+  stage.segment_offset = 0;
+  publishState();
+}
+
+void stageSegmentHeader(u32_t id, f64_t realtime_base)
+{
+  struct SegmentHeader header;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = SEGMENT_MAGIC;
+  header.version = SEGMENT_VERSION;
+  header.header_size = sizeof(header);
+  header.segment_id = id;
+  header.realtime_base = realtime_base ? realtime_base : getRealtimeBase();
+  segment_base = realtime_base;
+
+  memcpy(&image->data[stage.tail], &header, sizeof(header));
+  stage.tail += sizeof(header);
+  publishState();
+
+  if (!at_risk_since)
+    at_risk_since = getMonotonicTime();
+}
+
+void startSegment(f64_t realtime_base)
+{
+  /* A segment that has nothing but its header only gets another header */
+  if (!stage.segment_offset && !stage.segment_end &&
+      stage.tail - stage.head == sizeof(struct SegmentHeader))
+  {
+    stage.tail = stage.head;
+    stageSegmentHeader(stage.segment_id, realtime_base);
+    return;
+  }
+
+  /* Only one segment end may be staged at a time */
+  while (stage.segment_end)
+  {
+    staging_full = TRUE;
+    full_waits++;
+    pthread_cond_wait(&staging_flushed, &writer_mutex);
+  }
+
+  /* The end is marked by the staged bytes, so a padding byte is staged if
+   * all of the segment has been flushed.
+   */
+  if (stage.tail == stage.head)
+    image->data[stage.tail++] = 0;
+
+  stage.segment_end = stage.tail - stage.head;
+  stageSegmentHeader(stage.segment_id + 1, realtime_base);
+}
+
+void sealSegment(void)
+{
+  u8_t empty = (lseek(segment_fd, 0, SEEK_END) <= (off_t)sizeof(struct SegmentHeader));
+  char path[PATH_SIZE], sealed_path[PATH_SIZE];
+
+  fdatasync(segment_fd);
+  close(segment_fd);
+  segment_fd = -1;
+
+  segmentPath(path, stage.segment_id, FALSE);
+  segmentPath(sealed_path, stage.segment_id, TRUE);
+
+  if (empty)
+    unlink(path);
+  else
+  {
+    rename(path, sealed_path);
+    sealed_segments++;
+  }
+
+  stage.segment_id++;
+  publishState();
+}
+
+void refillBudget(u64_t now)
+{
+  budget += (now - budget_time) * (f64_t)FLASH_BUDGET_PER_HOUR / (3600.0 * NSEC_PER_SEC);
+  budget_time = now;
+
+  /* Unused budget is kept for an hour at most */
+  if (budget > FLASH_BUDGET_PER_HOUR)
+    budget = FLASH_BUDGET_PER_HOUR;
+}
+
+u32_t alignedBytes(void)
+{
+  u32_t staged = stage.tail - stage.head;
+  u32_t to_boundary = ERASE_BLOCK_SIZE - (stage.segment_offset % ERASE_BLOCK_SIZE);
+
+  /* The rest of a segment that has ended is flushed by itself, since the
+   * segment ends on a block boundary.
+   */
+  if (stage.segment_end)
+    return stage.segment_end;
+
+  if (staged < to_boundary)
+    return 0;
+
+  return to_boundary + ((staged - to_boundary) / ERASE_BLOCK_SIZE) * ERASE_BLOCK_SIZE;
+}
+
+void writeStaged(u32_t bytes)
+{
+  u32_t written = 0;
+  s32_t result;
+
+  while (written < bytes)
+  {
+    if ((result = write(segment_fd, &image->data[stage.head + written], bytes - written)) == -1)
+    {
+      perror("Could not write the log segment");
+      exit(-7);
+    }
+
+    written += result;
+  }
+
+  fdatasync(segment_fd);
+
+  /* A partially programmed page has to be programmed again by the next
+   * write, so the estimate counts whole pages.
+   */
+  programmed_bytes += ((stage.segment_offset + bytes + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE -
+                       stage.segment_offset / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE;
+  flash_bytes += bytes;
+
+  /* A crash before the state is published only writes the bytes again on
+   * recovery, which skips what the segment already has.
+   */
+  stage.segment_offset += bytes;
+  stage.head += bytes;
+
+  if (stage.segment_end)
+    stage.segment_end -= bytes;
+
+  publishState();
+
+  /* The rest is moved to the start only if it does not overlap itself, so
+   * that the published bytes are intact until the state that moves them.
+   */
+  if (stage.head && stage.tail - stage.head <= stage.head)
+  {
+    memmove(image->data, &image->data[stage.head], stage.tail - stage.head);
+    stage.tail -= stage.head;
+    stage.head = 0;
+    publishState();
+  }
+}
+
+void flushStaged(u32_t bytes, u8_t partial)
+{
+  u8_t ended;
+  u32_t chunk, left = bytes;
+
+  while (left)
+  {
+    chunk = (stage.segment_end && stage.segment_end < left) ? stage.segment_end : left;
+    ended = (stage.segment_end == chunk);
+
+    writeStaged(chunk);
+    left -= chunk;
+
+    if (ended)
+    {
+      sealSegment();
+      openSegmentFile();
+    }
+  }
+
+  at_risk_since = (stage.tail > stage.head) ? getMonotonicTime() : 0;
+
+  staging_full = FALSE;
+  pthread_cond_broadcast(&staging_flushed);
+
+  budget -= bytes;
+  if (budget < 0)
+    budget_overruns++;
+
+  flushes++;
+  if (partial)
+    partial_flushes++;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeFlashWriter(const char* directory, const char* staging_file)
+{
+  u8_t resume;
+  u32_t next_id;
+  char path[PATH_MAX];
+
+  if (realpath(directory, path) == NULL || strlen(path) >= LOG_DIR_SIZE)
+  {
+    perror("Could not find the log directory");
+    exit(-7);
+  }
+
+  at_risk_since = 0;
+  staging_full = FALSE;
+  recovered_bytes = 0;
+  lost_bytes = 0;
+  checkpoint_bytes = 0;
+
+  start_time = getMonotonicTime();
+  budget = FLASH_BUDGET_PER_HOUR;
+  budget_time = start_time;
+
+  resume = mapStagingFile(staging_file);
+  stage = image->state[image->index & 1];
+  resume = resume && stage.tail > stage.head && stage.tail <= STAGING_SIZE +
+           MAX_RECORD_SIZE + sizeof(struct SegmentHeader);
+
+  /* The records staged by a run of another log directory are written to
+   * their own segment there, before the staging file is taken over.
+   */
+  if (resume && strcmp(image->log_dir, path))
+  {
+    snprintf(log_dir, LOG_DIR_SIZE, "%s", image->log_dir);
+
+    if (access(log_dir, W_OK) == 0)
+    {
+      recoverSegments(TRUE);
+      recoverStaged();
+    }
+    else
+    {
+      fprintf(stderr, "The staged records could not be recovered\n");
+      lost_bytes = stage.tail - stage.head;
+    }
+
+    resume = FALSE;
+  }
+
+  strcpy(log_dir, path);
+
+  next_id = recoverSegments(resume);
+
+  if (resume)
+    recoverStaged();
+
+  if (stage.segment_id < next_id || !resume)
+    stage.segment_id = next_id;
+
+  stage.segment_end = 0;
+  stage.head = 0;
+  stage.tail = 0;
+
+  openSegmentFile();
+  snprintf(image->log_dir, LOG_DIR_SIZE, "%s", log_dir);
+  stageSegmentHeader(stage.segment_id, 0);
+}
+
+void exitFlashWriter(void)
+{
+  pthread_mutex_lock(&writer_mutex);
+
+  if (stage.tail > stage.head)
+    flushStaged(stage.tail - stage.head, TRUE);
+
+  sealSegment();
+
+  pthread_mutex_unlock(&writer_mutex);
+
+  msync(image, sizeof(struct StagingImage), MS_SYNC);
+  releaseMemoryRegion(image);
+  munmap(image, sizeof(struct StagingImage));
+}
+
+void appendLogRecord(const char* ssid, const u8_t* bssid, s8_t rssi,
+                     f32_t timestamp, f32_t latency, f64_t realtime_base)
+{
+  u8_t* record;
+  u32_t length = strcspn(ssid, "\n");
+  u32_t size = RECORD_OVERHEAD + length;
+
+  if (length == 0 || length > 255)
+    return;
+
+  pthread_mutex_lock(&writer_mutex);
+
+  /* The records of an earlier boot are logged in segments of their own, with
+   * the wall-clock time of their boot (as it was then), for the readers to
+   * convert their timestamps.
+   */
+  if (realtime_base != segment_base)
+    startSegment(realtime_base);
+
+  /* A record never spans two segments: the rest of the segment is padded,
+   * and the next segment is staged after it, so that the store task does not
+   * wait for the flash to seal the segment (the next flush does).
+   */
+  if (!stage.segment_end && stage.segment_offset + (stage.tail - stage.head) + size > SEGMENT_SIZE)
+  {
+    memset(&image->data[stage.tail], 0, SEGMENT_SIZE - stage.segment_offset - (stage.tail - stage.head));
+    stage.tail = stage.head + SEGMENT_SIZE - stage.segment_offset;
+    stage.segment_end = stage.tail - stage.head;
+
+    stageSegmentHeader(stage.segment_id + 1, segment_base);
+  }
+
+  /* The last resort, if no flush came in time: the store task never writes
+   * to the flash itself, it waits for the flush activity to force a flush.
+   */
+  while (stage.tail + size > STAGING_SIZE)
+  {
+    staging_full = TRUE;
+    full_waits++;
+    pthread_cond_wait(&staging_flushed, &writer_mutex);
+  }
+
+  record = &image->data[stage.tail];
+  record[0] = length;
+  memcpy(&record[1], ssid, length);
+  memcpy(&record[1 + length], bssid, 6);
+  record[7 + length] = (u8_t)rssi;
+  memcpy(&record[8 + length], &timestamp, sizeof(f32_t));
+  memcpy(&record[8 + length + sizeof(f32_t)], &latency, sizeof(f32_t));
+  stage.tail += size;
+  publishState();
+
+  if (!at_risk_since)
+    at_risk_since = getMonotonicTime();
+
+  logical_bytes += size;
+
+  pthread_mutex_unlock(&writer_mutex);
+}
+
+u8_t pollFlashWriter(u8_t quiet)
+{
+  u8_t flushed = TRUE;
+  u32_t bytes, staged;
+  u64_t at_risk, now = getMonotonicTime();
+
+  pthread_mutex_lock(&writer_mutex);
+
+  refillBudget(now);
+
+  staged = stage.tail - stage.head;
+  at_risk = staged ? now - at_risk_since : 0;
+
+  bytes = alignedBytes();
+
+  if (quiet && bytes && budget >= bytes && stage.tail < STAGING_HIGH_WATER)
+    flushStaged(bytes, FALSE);
+  else if (quiet && (at_risk >= (MAX_DATA_AT_RISK - QUIET_FLUSH_MARGIN) * NSEC_PER_SEC ||
+                     stage.tail >= STAGING_HIGH_WATER))
+    flushStaged(staged, TRUE);
+  else if (at_risk >= MAX_DATA_AT_RISK * NSEC_PER_SEC || staging_full)
+  {
+    flushStaged(staged, TRUE);
+    forced_flushes++;
+  }
+  else
+  {
+    flushed = FALSE;
+
+    if (!quiet && bytes && budget >= bytes)
+      deferred_polls++;
+  }
+
+  pthread_mutex_unlock(&writer_mutex);
+
+  return flushed;
+}
+
+void accountFlashWrite(u32_t bytes)
+{
+  pthread_mutex_lock(&writer_mutex);
+
+  refillBudget(getMonotonicTime());
+
+  /* Every page of the file is programmed again */
+  programmed_bytes += (bytes + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE;
+  flash_bytes += bytes;
+  checkpoint_bytes += bytes;
+
+  budget -= bytes;
+  if (budget < 0)
+    budget_overruns++;
+
+  pthread_mutex_unlock(&writer_mutex);
+}
+
+void printFlashWriterStats(FILE* file)
+{
+  f64_t days;
+
+  pthread_mutex_lock(&writer_mutex);
+
+  days = (getMonotonicTime() - start_time) / (86400.0 * NSEC_PER_SEC);
+
+  fprintf(file, "segment             %u\n", stage.segment_id);
+  fprintf(file, "sealed_segments     %llu\n", sealed_segments);
+  fprintf(file, "staged_bytes        %u\n", stage.tail - stage.head);
+  fprintf(file, "recovered_bytes     %llu\n", recovered_bytes);
+  fprintf(file, "lost_bytes          %llu\n", lost_bytes);
+  fprintf(file, "at_risk_secs        %.1f\n",
+          at_risk_since ? (getMonotonicTime() - at_risk_since) / (f64_t)NSEC_PER_SEC : 0);
+  fprintf(file, "logical_bytes       %llu\n", logical_bytes);
+  fprintf(file, "flash_bytes         %llu\n", flash_bytes);
+  fprintf(file, "checkpoint_bytes    %llu\n", checkpoint_bytes);
+  fprintf(file, "flushes             %llu\n", flushes);
+  fprintf(file, "partial_flushes     %llu\n", partial_flushes);
+  fprintf(file, "forced_flushes      %llu\n", forced_flushes);
+  fprintf(file, "full_waits          %llu\n", full_waits);
+  fprintf(file, "deferred_polls      %llu\n", deferred_polls);
+  fprintf(file, "budget_overruns     %llu\n", budget_overruns);
+  fprintf(file, "write_amplification %.2f\n",
+          logical_bytes ? (f64_t)programmed_bytes / logical_bytes : 0);
+  fprintf(file, "bytes_per_day       %.0f\n", (days > 0) ? programmed_bytes / days : 0);
+
+  pthread_mutex_unlock(&writer_mutex);
+}
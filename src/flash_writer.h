@@ -0,0 +1,166 @@
+/**
+  * @file flash_writer.h
+  * @brief Contains the declarations of functions defined in flash_writer.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef FLASH_WRITER_H
+#define FLASH_WRITER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The default directory of the log segments and of the checkpoint of the
+  * queue (on flash).
+  */
+#define LOG_DIR "."
+
+/** The max size of the path of the log directory. */
+#define LOG_DIR_SIZE (192u)
+
+/** The directory that is written often (on tmpfs), to spare the flash. */
+#define STAGING_DIR "/dev/shm"
+
+/** The file that backs the staging buffer, so that the staged records survive
+  * a crash of the process (but not a power loss, since it is on tmpfs).
+  */
+#define STAGING_FILE STAGING_DIR "/ssid_staging.dat"
+
+/** The size of an erase block of the flash. Records are staged in RAM and
+  * flushed only in whole, aligned blocks, unless they have been at risk for
+  * too long or the staging buffer is full.
+  */
+#define ERASE_BLOCK_SIZE (128u * 1024u)
+
+/** The size of a page of the flash, i.e. the unit of programming that the
+  * write amplification is estimated on.
+  */
+#define FLASH_PAGE_SIZE (16u * 1024u)
+
+/** The size of the staging buffer (in erase blocks). */
+#define STAGING_BLOCKS (4u)
+
+/** The size of a log segment (in erase blocks). */
+#define SEGMENT_BLOCKS (32u)
+#define SEGMENT_SIZE (SEGMENT_BLOCKS * ERASE_BLOCK_SIZE)
+
+/** The bytes that may be written to flash per hour. Flushes of whole blocks
+  * wait for the budget; forced flushes do not, and are counted as overruns.
+  */
+#define FLASH_BUDGET_PER_HOUR (8u * 1024u * 1024u)
+
+/** The max time (in secs) a record may be staged before it is flushed. */
+#define MAX_DATA_AT_RISK (300u)
+
+/** The time (in secs) before the data-at-risk limit from which the staged
+  * records are flushed in the first quiet window, so that a forced flush
+  * (outside a quiet window) is needed only if no window comes in time.
+  */
+#define QUIET_FLUSH_MARGIN (30u)
+
+/** The magic number and version of a log segment. */
+#define SEGMENT_MAGIC   (0x474C5752u)
+#define SEGMENT_VERSION (2u)
+
+/** The size of a record, besides its SSID (length, BSSID, RSSI, timestamp
+  * and latency), and the max size of a record.
+  */
+#define RECORD_OVERHEAD (1u + 6u + 1u + 2u * sizeof(f32_t))
+#define MAX_RECORD_SIZE (RECORD_OVERHEAD + 255u)
+
+/***************************** Type Definitions ******************************/
+
+/** The header of a log segment. It is followed by records, each made up of
+  * the length of the SSID (1 byte, never 0), the SSID (without the trailing
+  * newline), the BSSID (6 bytes), the RSSI (1 byte, signed dBm), the
+  * timestamp and the latency (f32, little-endian). A 0 byte in place of a
+  * length is padding and is skipped. Version 1 records have no BSSID and RSSI.
+  */
+struct SegmentHeader {
+  u32_t magic;
+  u16_t version;
+  u16_t header_size;
+  u32_t segment_id;
+  u32_t reserved;
+  f64_t realtime_base;  /* CLOCK_REALTIME - CLOCK_MONOTONIC, in secs */
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module and open the next log segment. The records that
+*        were staged before a crash are written to their segment first, and a
+*        segment left open by a crash is sealed.
+* @param log_dir The directory of the log segments.
+* @param staging_file The file that backs the staging buffer.
+* @return Void.
+*/
+void initializeFlashWriter(const char* log_dir, const char* staging_file);
+
+/**
+* @brief Flush everything that is staged and close the log segment.
+* @return Void.
+*/
+void exitFlashWriter(void);
+
+/**
+* @brief Stage a record for the log. If the staging buffer is full, it waits
+*        for the next poll to flush it (it never writes to flash itself).
+* @param ssid The SSID of the record.
+* @param bssid The BSSID of the record (6 bytes).
+* @param rssi The RSSI of the record (dBm).
+* @param timestamp The timestamp of the record.
+* @param latency The latency of the record.
+* @param realtime_base The wall-clock time of the boot of a record of an
+*        earlier boot, or 0 for a record of the current boot.
+* @return Void.
+*/
+void appendLogRecord(const char* ssid, const u8_t* bssid, s8_t rssi,
+                     f32_t timestamp, f32_t latency, f64_t realtime_base);
+
+/**
+* @brief Flush the staged records. In a quiet window (when the scan and the
+*        store are idle), the whole blocks are flushed if there is budget for
+*        them, and everything is flushed if it is close to the data-at-risk
+*        limit or the buffer is nearly full. Outside a quiet window, the records
+*        are flushed only if they have reached the limit, or if the buffer is
+*        full and a record waits for it.
+* @param quiet Whether it is a quiet window.
+* @return TRUE if records were flushed, FALSE otherwise.
+*/
+u8_t pollFlashWriter(u8_t quiet);
+
+/**
+* @brief Account a write to flash outside of the log (the checkpoint of the
+*        queue), in the budget and in the estimated wear.
+* @param bytes The bytes that were rewritten in place (from the start of
+*        their file).
+* @return Void.
+*/
+void accountFlashWrite(u32_t bytes);
+
+/**
+* @brief Print the counters of the writer.
+* @param file The file to print to.
+* @return Void.
+*/
+void printFlashWriterStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* FLASH_WRITER_H */
@@ -0,0 +1,108 @@
+/**
+  * @file latency_stats.c
+  * @brief Implements latency histograms with log2 buckets split into linear
+  *        sub-buckets.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <string.h>
+
+#include "latency_stats.h"
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the bucket of a latency.
+ * @param usecs The latency (in usecs).
+ * @return The bucket.
+ */
+static u32_t latencyBucket(u64_t usecs);
+
+/**
+ * @brief Get the upper bound of a bucket.
+ * @param bucket The bucket.
+ * @return The upper bound (in usecs).
+ */
+static u64_t bucketBound(u32_t bucket);
+
+/***************************** Static Functions ******************************/
+
+u32_t latencyBucket(u64_t usecs)
+{
+  u32_t magnitude;
+
+  if (usecs < LATENCY_SUB_BUCKETS)
+    return usecs;
+
+  if (usecs >> LATENCY_MAGNITUDES)
+    return LATENCY_BUCKETS - 1;
+
+  magnitude = 63 - __builtin_clzll(usecs);
+
+  /* The top bits of the latency below the leading one pick the sub-bucket */
+  return (magnitude - LATENCY_SUB_BITS) * LATENCY_SUB_BUCKETS +
+         (usecs >> (magnitude - LATENCY_SUB_BITS));
+}
+
+u64_t bucketBound(u32_t bucket)
+{
+  u32_t shift;
+
+  if (bucket < LATENCY_SUB_BUCKETS)
+    return bucket + 1;
+
+  shift = bucket / LATENCY_SUB_BUCKETS - 1;
+
+  return (u64_t)(bucket % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS + 1) << shift;
+}
+
+/***************************** Public Functions ******************************/
+
+void resetLatencyHistogram(struct LatencyHistogram* histogram)
+{
+  memset(histogram, 0, sizeof(struct LatencyHistogram));
+}
+
+void recordLatency(struct LatencyHistogram* histogram, f64_t latency)
+{
+  u64_t usecs = (latency > 0) ? (u64_t)(latency * 1e6) : 0;
+
+  histogram->buckets[latencyBucket(usecs)]++;
+  histogram->count++;
+  histogram->sum += latency;
+
+  if (latency > histogram->max)
+    histogram->max = latency;
+}
+
+f64_t getLatencyPercentile(struct LatencyHistogram* histogram, f64_t percentile)
+{
+  u32_t bucket;
+  u64_t seen = 0;
+  u64_t rank = histogram->count * percentile / 100.0;
+
+  for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+  {
+    seen += histogram->buckets[bucket];
+
+    if (seen > rank)
+      break;
+  }
+
+  if (bucket == LATENCY_BUCKETS || bucketBound(bucket) / 1e6 > histogram->max)
+    return histogram->max;
+
+  return bucketBound(bucket) / 1e6;
+}
+
+void printLatencyHistogram(FILE* file, const char* name, struct LatencyHistogram* histogram)
+{
+  fprintf(file, "%-10s count %-8llu mean %.6f  p50 %.6f  p99 %.6f  max %.6f\n", name,
+          histogram->count, histogram->count ? histogram->sum / histogram->count : 0,
+          getLatencyPercentile(histogram, 50), getLatencyPercentile(histogram, 99),
+          histogram->max);
+}
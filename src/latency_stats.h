@@ -0,0 +1,85 @@
+/**
+  * @file latency_stats.h
+  * @brief Contains the declarations of functions defined in latency_stats.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The buckets of a histogram (HDR-style): each power of 2 of usecs, up to
+  * 2^32 (about 71 minutes), is split into linear sub-buckets, so that a
+  * percentile is off by 1/16 of its value at most (the latencies under 16
+  * usecs are counted exactly).
+  */
+#define LATENCY_SUB_BITS    (4u)
+#define LATENCY_SUB_BUCKETS (1u << LATENCY_SUB_BITS)
+#define LATENCY_MAGNITUDES  (32u)
+#define LATENCY_BUCKETS     ((LATENCY_MAGNITUDES - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+/***************************** Type Definitions ******************************/
+
+/** A histogram of latencies. */
+struct LatencyHistogram {
+  u64_t count;
+  f64_t sum;
+  f64_t max;
+  u64_t buckets[LATENCY_BUCKETS];
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Clear a histogram.
+* @param histogram The histogram.
+* @return Void.
+*/
+void resetLatencyHistogram(struct LatencyHistogram* histogram);
+
+/**
+* @brief Count a latency to a histogram.
+* @param histogram The histogram.
+* @param latency The latency (in secs).
+* @return Void.
+*/
+void recordLatency(struct LatencyHistogram* histogram, f64_t latency);
+
+/**
+* @brief Get a percentile of a histogram (the upper bound of its bucket,
+*        or the max latency if it is lower).
+* @param histogram The histogram.
+* @param percentile The percentile (0 to 100).
+* @return The latency (in secs).
+*/
+f64_t getLatencyPercentile(struct LatencyHistogram* histogram, f64_t percentile);
+
+/**
+* @brief Print the summary of a histogram in a single line.
+* @param file The file to print to.
+* @param name The name of the histogram.
+* @param histogram The histogram.
+* @return Void.
+*/
+void printLatencyHistogram(FILE* file, const char* name, struct LatencyHistogram* histogram);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* LATENCY_STATS_H */
@@ -0,0 +1,687 @@
+/**
+  * @file localizer.c
+  * @brief Implements a particle filter that estimates the position from the
+  *        scans and a map of the APs, with vectorized and parallel updates.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "time_helpers.h"
+#include "task_stacks.h"
+#include "memory_regions.h"
+
+#include "localizer.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The number of floats in a vector. */
+#define VECTOR_WIDTH (4u)
+
+/***************************** Type Definitions ******************************/
+
+/** The vectors of the kernels (NEON on ARM, SSE on x86). */
+typedef f32_t v4sf __attribute__((vector_size(16)));
+typedef s32_t v4si __attribute__((vector_size(16)));
+
+/** A worker, that updates a slice of the particles. */
+struct Worker {
+  pthread_t thread;
+  pthread_attr_t attr;
+  u32_t first, num;
+  u32_t random;
+  f32_t max_weight;
+};
+
+/** The work of an epoch: the APs that were observed and are in the map. */
+struct EpochJob {
+  const struct APMapEntry* aps[LOCALIZER_MAX_OBSERVATIONS];
+  f32_t rssi[LOCALIZER_MAX_OBSERVATIONS];
+  u32_t num;
+  f32_t motion;  /* deviation of the movement (m) */
+};
+
+/***************************** Static Variables ******************************/
+
+/** The mapped AP map. */
+static void* map_base;
+static size_t map_size;
+static const struct APMapEntry* map_entries;
+static u32_t map_count;
+
+/** The particles (structure of arrays), with their log-weights. */
+static f32_t* particle_x;
+static f32_t* particle_y;
+static f32_t* particle_w;
+static f32_t* resampled_x;
+static f32_t* resampled_y;
+static f32_t* weights;
+
+/** The workers; the first one is the thread that processes the epochs. */
+static struct Worker workers[LOCALIZER_MAX_WORKERS];
+static u32_t worker_num;
+static pthread_barrier_t start_barrier, done_barrier;
+static u8_t stopping;
+static struct EpochJob job;
+
+/** The estimate and the counters of the localizer. */
+static struct Position position;
+static f32_t last_timestamp;
+static u64_t epochs, observed, matched, resamples;
+static u64_t update_time, max_update_time;
+
+/** Guards the estimate and the counters, since they are reported from other
+  * tasks.
+  */
+static pthread_mutex_t localizer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** The epoch that waits to be processed, and the epochs that were replaced
+  * before they were processed.
+  */
+static struct Observation pending[LOCALIZER_MAX_OBSERVATIONS];
+static u32_t pending_num;
+static f32_t pending_timestamp;
+static u8_t pending_ready;
+static u64_t dropped_epochs;
+static pthread_mutex_t pending_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pending_cond = PTHREAD_COND_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the next pseudo-random number (xorshift32).
+ * @param state The state of the generator.
+ * @return The next number.
+ */
+static u32_t nextRandom(u32_t* state);
+
+/**
+ * @brief Get a number of a standard normal distribution (approximately, as
+ *        the scaled sum of four uniform numbers).
+ * @param state The state of the generator.
+ * @return The number.
+ */
+static f32_t nextGaussian(u32_t* state);
+
+/**
+ * @brief Find an AP in the map.
+ * @param bssid The BSSID of the AP.
+ * @return The entry of the AP, or NULL if it is not in the map.
+ */
+static const struct APMapEntry* findAP(const u8_t* bssid);
+
+/**
+ * @brief Select the lanes of two vectors.
+ * @param mask The lanes (all ones) to be taken from the first vector.
+ * @param a The first vector.
+ * @param b The second vector.
+ * @return The selected lanes.
+ */
+static inline v4sf selectVector(v4si mask, v4sf a, v4sf b);
+
+/**
+ * @brief Get the base-2 logarithm of a vector of positive, normal numbers
+ *        (from the exponent and a polynomial of the mantissa, which is
+ *        accurate to about 2e-4).
+ * @param x The vector.
+ * @return The logarithm of each lane.
+ */
+static inline v4sf log2Vector(v4sf x);
+
+/**
+ * @brief Add the log-likelihood of an observation to the particles of a
+ *        worker.
+ * @param worker The worker.
+ * @param ap The AP that was observed.
+ * @param rssi The observed RSSI.
+ * @return Void.
+ */
+static void weighParticles(struct Worker* worker, const struct APMapEntry* ap, f32_t rssi);
+
+/**
+ * @brief Move and weigh the particles of a worker for the current epoch.
+ * @param worker The worker.
+ * @return Void.
+ */
+static void updateSlice(struct Worker* worker);
+
+/**
+ * @brief The loop of a worker thread, one slice update per epoch.
+ * @param arg The worker.
+ * @return NULL.
+ */
+static void* workerLoop(void* arg);
+
+/**
+ * @brief Pin a thread to a CPU that is not used by the real-time tasks.
+ * @param thread The thread.
+ * @param index The index of the thread among the workers.
+ * @return Void.
+ */
+static void pinToCPU(pthread_t thread, u32_t index);
+
+/**
+ * @brief Draw new particles by their weights (systematic resampling).
+ * @param sum The sum of the weights.
+ * @return Void.
+ */
+static void resampleParticles(f32_t sum);
+
+/**
+ * @brief Map the AP map to memory and check it.
+ * @param path The file of the map.
+ * @return Void.
+ */
+static void loadMap(const char* path);
+
+/***************************** Static Functions ******************************/
+
+u32_t nextRandom(u32_t* state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+
+  return *state;
+}
+
+f32_t nextGaussian(u32_t* state)
+{
+  u32_t i;
+  f32_t sum = 0;
+
+  for (i = 0; i < 4; i++)
+    sum += (nextRandom(state) >> 8) / 16777216.0f;
+
+  return (sum - 2.0f) * 1.7320508f;
+}
+
+const struct APMapEntry* findAP(const u8_t* bssid)
+{
+  s32_t order;
+  u32_t low = 0, high = map_count;
+
+  while (low < high)
+  {
+    order = memcmp(map_entries[(low + high) / 2].bssid, bssid, 6);
+
+    if (order == 0)
+      return &map_entries[(low + high) / 2];
+    else if (order < 0)
+      low = (low + high) / 2 + 1;
+    else
+      high = (low + high) / 2;
+  }
+
+  return NULL;
+}
+
+v4sf selectVector(v4si mask, v4sf a, v4sf b)
+{
+  return (v4sf)((mask & (v4si)a) | (~mask & (v4si)b));
+}
+
+v4sf log2Vector(v4sf x)
+{
+  v4si bits = (v4si)x;
+  v4sf exponent = __builtin_convertvector(((bits >> 23) & 0xFF) - 127, v4sf);
+  v4sf t = (v4sf)((bits & 0x007FFFFF) | 0x3F800000) - 1.0f;
+
+  return exponent + (0.00020372331f + t * (1.4361024f + t * (-0.66952725f +
+                     t * (0.31222615f - t * 0.079153834f))));
+}
+
+void weighParticles(struct Worker* worker, const struct APMapEntry* ap, f32_t rssi)
+{
+  u32_t i;
+  f32_t sigma = (ap->sigma > 1.0f) ? ap->sigma : 1.0f;
+  v4sf dx, dy, d2, residual, log_likelihood;
+  const v4sf zero = { 0 };
+  const v4sf min_d2 = zero + AP_MAP_MIN_DISTANCE * AP_MAP_MIN_DISTANCE;
+  const v4sf floor = zero + LOCALIZER_MIN_LOG_LIKELIHOOD;
+  const v4sf ap_x = zero + ap->x, ap_y = zero + ap->y;
+  const v4sf offset = zero + (rssi - ap->rssi_1m);
+  const v4sf slope = zero + 5.0f * ap->path_loss * 0.30103f;
+  const v4sf scale = zero + -0.5f / (sigma * sigma);
+
+  for (i = worker->first; i < worker->first + worker->num; i += VECTOR_WIDTH)
+  {
+    dx = *(v4sf*)&particle_x[i] - ap_x;
+    dy = *(v4sf*)&particle_y[i] - ap_y;
+
+    /* Closer than the min distance counts as the min distance */
+    d2 = dx * dx + dy * dy;
+    d2 = selectVector(d2 < min_d2, min_d2, d2);
+
+    /* The path loss is 10 * n * log10(d) = 5 * n * log10(2) * log2(d^2) */
+    residual = offset + slope * log2Vector(d2);
+    log_likelihood = scale * residual * residual;
+
+    *(v4sf*)&particle_w[i] += selectVector(log_likelihood < floor, floor, log_likelihood);
+  }
+}
+
+void updateSlice(struct Worker* worker)
+{
+  u32_t i;
+  f32_t max_weight = -INFINITY;
+
+  for (i = worker->first; i < worker->first + worker->num; i++)
+  {
+    particle_x[i] += job.motion * nextGaussian(&worker->random);
+    particle_y[i] += job.motion * nextGaussian(&worker->random);
+  }
+
+  for (i = 0; i < job.num; i++)
+    weighParticles(worker, job.aps[i], job.rssi[i]);
+
+  for (i = worker->first; i < worker->first + worker->num; i++)
+  {
+    if (particle_w[i] > max_weight)
+      max_weight = particle_w[i];
+  }
+
+  worker->max_weight = max_weight;
+}
+
+void* workerLoop(void* arg)
+{
+  struct Worker* worker = arg;
+
+  while (1)
+  {
+    pthread_barrier_wait(&start_barrier);
+
+    if (stopping)
+      break;
+
+    updateSlice(worker);
+
+    pthread_barrier_wait(&done_barrier);
+  }
+
+  return NULL;
+}
+
+void pinToCPU(pthread_t thread, u32_t index)
+{
+  cpu_set_t mask;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+  /* With a single CPU, the workers share it with the real-time tasks */
+  if (cpus <= LOCALIZER_FIRST_CPU)
+    return;
+
+  CPU_ZERO(&mask);
+  CPU_SET(LOCALIZER_FIRST_CPU + index % (cpus - LOCALIZER_FIRST_CPU), &mask);
+  pthread_setaffinity_np(thread, sizeof(mask), &mask);
+}
+
+void resampleParticles(f32_t sum)
+{
+  u32_t i, j = 0;
+  f32_t* swap;
+  f32_t step = sum / LOCALIZER_PARTICLES;
+  f32_t target = step * ((nextRandom(&workers[0].random) >> 8) / 16777216.0f);
+  f32_t cumulative = weights[0];
+
+  for (i = 0; i < LOCALIZER_PARTICLES; i++)
+  {
+    while (target > cumulative && j < LOCALIZER_PARTICLES - 1)
+      cumulative += weights[++j];
+
+    resampled_x[i] = particle_x[j];
+    resampled_y[i] = particle_y[j];
+    particle_w[i] = 0;
+
+    target += step;
+  }
+
+  swap = particle_x;
+  particle_x = resampled_x;
+  resampled_x = swap;
+
+  swap = particle_y;
+  particle_y = resampled_y;
+  resampled_y = swap;
+}
+
+void loadMap(const char* path)
+{
+  s32_t fd;
+  struct stat map_stat;
+  const struct APMapHeader* header;
+
+  if ((fd = open(path, O_RDONLY)) == -1 || fstat(fd, &map_stat) == -1)
+  {
+    perror("Could not open the AP map");
+    exit(-10);
+  }
+
+  map_size = map_stat.st_size;
+
+  if (map_size < sizeof(struct APMapHeader))
+  {
+    perror("The AP map is too small");
+    exit(-10);
+  }
+
+  map_base = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (map_base == MAP_FAILED)
+  {
+    perror("Could not map the AP map");
+    exit(-10);
+  }
+
+  header = map_base;
+
+  if (header->magic != AP_MAP_MAGIC || header->version != AP_MAP_VERSION ||
+      header->entry_size != sizeof(struct APMapEntry) || header->count == 0 ||
+      map_size < header->header_size + (u64_t)header->count * header->entry_size)
+  {
+    perror("The AP map is not valid");
+    exit(-10);
+  }
+
+  /* Only the localize task reads it, so it is left pageable */
+  addMemoryRegion("ap map", map_base, map_size);
+
+  map_entries = (const struct APMapEntry*)((const u8_t*)map_base + header->header_size);
+  map_count = header->count;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeLocalizer(const char* map_path, u32_t num_workers)
+{
+  u32_t i, slice;
+  f32_t min_x = INFINITY, max_x = -INFINITY, min_y = INFINITY, max_y = -INFINITY;
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+  loadMap(map_path);
+
+  particle_x = aligned_alloc(64, LOCALIZER_PARTICLES * sizeof(f32_t));
+  particle_y = aligned_alloc(64, LOCALIZER_PARTICLES * sizeof(f32_t));
+  particle_w = aligned_alloc(64, LOCALIZER_PARTICLES * sizeof(f32_t));
+  resampled_x = aligned_alloc(64, LOCALIZER_PARTICLES * sizeof(f32_t));
+  resampled_y = aligned_alloc(64, LOCALIZER_PARTICLES * sizeof(f32_t));
+  weights = aligned_alloc(64, LOCALIZER_PARTICLES * sizeof(f32_t));
+
+  if (particle_x == NULL || particle_y == NULL || particle_w == NULL ||
+      resampled_x == NULL || resampled_y == NULL || weights == NULL)
+  {
+    perror("Could not allocate the particles");
+    exit(-5);
+  }
+
+  /* Without a prior, the particles are spread over the whole map */
+  for (i = 0; i < map_count; i++)
+  {
+    min_x = fminf(min_x, map_entries[i].x);
+    max_x = fmaxf(max_x, map_entries[i].x);
+    min_y = fminf(min_y, map_entries[i].y);
+    max_y = fmaxf(max_y, map_entries[i].y);
+  }
+
+  if (num_workers == 0)
+    num_workers = (cpus > LOCALIZER_FIRST_CPU) ? cpus - LOCALIZER_FIRST_CPU : 1;
+  worker_num = (num_workers < LOCALIZER_MAX_WORKERS) ? num_workers : LOCALIZER_MAX_WORKERS;
+
+  workers[0].random = 2463534242u;
+
+  for (i = 0; i < LOCALIZER_PARTICLES; i++)
+  {
+    particle_x[i] = min_x - LOCALIZER_MARGIN + (max_x - min_x + 2 * LOCALIZER_MARGIN) *
+                    ((nextRandom(&workers[0].random) >> 8) / 16777216.0f);
+    particle_y[i] = min_y - LOCALIZER_MARGIN + (max_y - min_y + 2 * LOCALIZER_MARGIN) *
+                    ((nextRandom(&workers[0].random) >> 8) / 16777216.0f);
+    particle_w[i] = 0;
+  }
+
+  /* The slices are whole vectors; the last one takes the rest */
+  slice = (LOCALIZER_PARTICLES / worker_num) & ~(VECTOR_WIDTH - 1);
+
+  for (i = 0; i < worker_num; i++)
+  {
+    workers[i].first = i * slice;
+    workers[i].num = (i == worker_num - 1) ? LOCALIZER_PARTICLES - i * slice : slice;
+    workers[i].random = 2463534242u + 7919u * i;
+  }
+
+  stopping = FALSE;
+  epochs = dropped_epochs = observed = matched = resamples = 0;
+  update_time = max_update_time = 0;
+  last_timestamp = 0;
+  memset(&position, 0, sizeof(position));
+
+  if (worker_num > 1)
+  {
+    pthread_barrier_init(&start_barrier, NULL, worker_num);
+    pthread_barrier_init(&done_barrier, NULL, worker_num);
+
+    for (i = 1; i < worker_num; i++)
+    {
+      pthread_attr_init(&workers[i].attr);
+      setTaskStack(&workers[i].attr, "localize/w", LOCALIZER_STACK_SIZE, FALSE);
+
+      (void)pthread_create(&workers[i].thread, &workers[i].attr, workerLoop, &workers[i]);
+      pinToCPU(workers[i].thread, i);
+    }
+  }
+}
+
+void exitLocalizer(void)
+{
+  u32_t i;
+
+  if (worker_num > 1)
+  {
+    stopping = TRUE;
+    pthread_barrier_wait(&start_barrier);
+
+    for (i = 1; i < worker_num; i++)
+    {
+      pthread_join(workers[i].thread, NULL);
+
+      releaseTaskStack(&workers[i].attr);
+      pthread_attr_destroy(&workers[i].attr);
+    }
+
+    pthread_barrier_destroy(&start_barrier);
+    pthread_barrier_destroy(&done_barrier);
+  }
+
+  free(particle_x);
+  free(particle_y);
+  free(particle_w);
+  free(resampled_x);
+  free(resampled_y);
+  free(weights);
+
+  releaseMemoryRegion(map_base);
+  munmap(map_base, map_size);
+}
+
+void postScanEpoch(const struct Observation* observations, u32_t num, f32_t timestamp)
+{
+  pthread_mutex_lock(&pending_mutex);
+
+  if (pending_ready)
+    dropped_epochs++;
+
+  pending_num = (num < LOCALIZER_MAX_OBSERVATIONS) ? num : LOCALIZER_MAX_OBSERVATIONS;
+  memcpy(pending, observations, pending_num * sizeof(struct Observation));
+  pending_timestamp = timestamp;
+  pending_ready = TRUE;
+
+  pthread_mutex_unlock(&pending_mutex);
+  pthread_cond_signal(&pending_cond);
+}
+
+void runLocalizer(void)
+{
+  u32_t num;
+  f32_t timestamp;
+  struct Observation observations[LOCALIZER_MAX_OBSERVATIONS];
+  static u8_t pinned = FALSE;
+
+  if (!pinned)
+  {
+    pinToCPU(pthread_self(), 0);
+    pinned = TRUE;
+  }
+
+  pthread_mutex_lock(&pending_mutex);
+  while (!pending_ready)
+    pthread_cond_wait(&pending_cond, &pending_mutex);
+
+  num = pending_num;
+  memcpy(observations, pending, num * sizeof(struct Observation));
+  timestamp = pending_timestamp;
+  pending_ready = FALSE;
+
+  pthread_mutex_unlock(&pending_mutex);
+
+  localizeEpoch(observations, num, timestamp);
+}
+
+void localizeEpoch(const struct Observation* observations, u32_t num, f32_t timestamp)
+{
+  u32_t i;
+  u64_t start_time = getMonotonicTime(), elapsed;
+  u8_t resampled = FALSE;
+  f32_t max_weight = -INFINITY;
+  f64_t sum = 0, sum_squares = 0, sum_x = 0, sum_y = 0, spread = 0, dx, dy;
+  struct Position estimate;
+  const struct APMapEntry* ap;
+
+  job.num = 0;
+
+  for (i = 0; i < num && job.num < LOCALIZER_MAX_OBSERVATIONS; i++)
+  {
+    if ((ap = findAP(observations[i].bssid)) != NULL)
+    {
+      job.aps[job.num] = ap;
+      job.rssi[job.num] = observations[i].rssi;
+      job.num++;
+    }
+  }
+
+  job.motion = (epochs > 0 && timestamp > last_timestamp) ?
+               LOCALIZER_SPEED * (timestamp - last_timestamp) : 0;
+  last_timestamp = timestamp;
+
+  /* The workers update their slices in parallel */
+  if (worker_num > 1)
+    pthread_barrier_wait(&start_barrier);
+
+  updateSlice(&workers[0]);
+
+  if (worker_num > 1)
+    pthread_barrier_wait(&done_barrier);
+
+  for (i = 0; i < worker_num; i++)
+  {
+    if (workers[i].max_weight > max_weight)
+      max_weight = workers[i].max_weight;
+  }
+
+  for (i = 0; i < LOCALIZER_PARTICLES; i++)
+  {
+    weights[i] = expf(particle_w[i] - max_weight);
+    particle_w[i] -= max_weight;
+
+    sum += weights[i];
+    sum_squares += weights[i] * weights[i];
+    sum_x += weights[i] * particle_x[i];
+    sum_y += weights[i] * particle_y[i];
+  }
+
+  for (i = 0; i < LOCALIZER_PARTICLES; i++)
+  {
+    dx = particle_x[i] - sum_x / sum;
+    dy = particle_y[i] - sum_y / sum;
+    spread += weights[i] * (dx * dx + dy * dy);
+  }
+
+  estimate.x = sum_x / sum;
+  estimate.y = sum_y / sum;
+  estimate.spread = sqrt(spread / sum);
+  estimate.ess = sum * sum / sum_squares;
+  estimate.timestamp = timestamp;
+
+  /* The particles are only touched by this thread, so only the estimate is
+   * published under the lock.
+   */
+  if (estimate.ess < LOCALIZER_RESAMPLE_RATIO * LOCALIZER_PARTICLES)
+  {
+    resampleParticles(sum);
+    resampled = TRUE;
+  }
+
+  elapsed = getMonotonicTime() - start_time;
+
+  pthread_mutex_lock(&localizer_mutex);
+
+  position = estimate;
+  resamples += resampled;
+  epochs++;
+  observed += num;
+  matched += job.num;
+  update_time += elapsed;
+  if (elapsed > max_update_time)
+    max_update_time = elapsed;
+
+  pthread_mutex_unlock(&localizer_mutex);
+}
+
+void getPosition(struct Position* estimate)
+{
+  pthread_mutex_lock(&localizer_mutex);
+  *estimate = position;
+  pthread_mutex_unlock(&localizer_mutex);
+}
+
+void printLocalizerStats(FILE* file)
+{
+  u64_t dropped;
+
+  pthread_mutex_lock(&pending_mutex);
+  dropped = dropped_epochs;
+  pthread_mutex_unlock(&pending_mutex);
+
+  pthread_mutex_lock(&localizer_mutex);
+
+  fprintf(file, "map_aps         %u\n", map_count);
+  fprintf(file, "particles       %u\n", LOCALIZER_PARTICLES);
+  fprintf(file, "workers         %u\n", worker_num);
+  fprintf(file, "epochs          %llu\n", epochs);
+  fprintf(file, "dropped_epochs  %llu\n", dropped);
+  fprintf(file, "matched         %llu/%llu\n", matched, observed);
+  fprintf(file, "resamples       %llu\n", resamples);
+  fprintf(file, "ms_per_epoch    %.2f\n", epochs ? update_time / (1e6 * epochs) : 0);
+  fprintf(file, "max_ms          %.2f\n", max_update_time / 1e6);
+  fprintf(file, "position        %.1f %.1f\n", position.x, position.y);
+  fprintf(file, "spread_m        %.1f\n", position.spread);
+  fprintf(file, "ess             %.0f\n", position.ess);
+
+  pthread_mutex_unlock(&localizer_mutex);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+  * @file localizer.h
+  * @brief Contains the declarations of functions defined in localizer.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef LOCALIZER_H
+#define LOCALIZER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+#include "ap_map.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The number of particles (a multiple of the vector width, i.e. 4). */
+#define LOCALIZER_PARTICLES (10240u)
+
+/** The max number of worker threads, and the first CPU they are pinned to
+  * (the real-time tasks run on the CPUs before it).
+  */
+#define LOCALIZER_MAX_WORKERS (4u)
+#define LOCALIZER_FIRST_CPU   (1u)
+
+/** The stack size of a worker thread (as measured by the profiling mode). */
+#define LOCALIZER_STACK_SIZE (28u * 1024u)
+
+/** The max number of observations of a scan epoch. */
+#define LOCALIZER_MAX_OBSERVATIONS (128u)
+
+/** The max speed of the vehicle (m/s), that the particles diffuse with. */
+#define LOCALIZER_SPEED (15.0f)
+
+/** The margin (in meters) around the APs of the map, that the particles are
+  * spread over at first.
+  */
+#define LOCALIZER_MARGIN (100.0f)
+
+/** The min log-likelihood of an observation, so that a single outlier does
+  * not wipe out the particles that are close.
+  */
+#define LOCALIZER_MIN_LOG_LIKELIHOOD (-8.0f)
+
+/** The effective sample size (as a fraction of the particles) under which
+  * the particles are resampled.
+  */
+#define LOCALIZER_RESAMPLE_RATIO (0.5f)
+
+/***************************** Type Definitions ******************************/
+
+/** An observation of an AP by a scan. */
+struct Observation {
+  u8_t bssid[6];
+  s8_t rssi;  /* dBm */
+};
+
+/** The estimated position. */
+struct Position {
+  f32_t x, y;      /* meters, from the origin of the map */
+  f32_t spread;    /* meters */
+  f32_t ess;       /* effective sample size */
+  f32_t timestamp;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Map the AP map to memory, spread the particles over it and start
+*        the worker threads.
+* @param map_path The file of the AP map.
+* @param workers The number of threads that update the particles (0 for one
+*        per CPU that is not real-time).
+* @return Void.
+*/
+void initializeLocalizer(const char* map_path, u32_t workers);
+
+/**
+* @brief Stop the worker threads and unmap the AP map.
+* @return Void.
+*/
+void exitLocalizer(void);
+
+/**
+* @brief Hand the observations of a scan epoch to the localizer task. It does
+*        not block; an epoch that was not processed yet is replaced.
+* @param observations The observations.
+* @param num The number of observations.
+* @param timestamp The timestamp of the epoch.
+* @return Void.
+*/
+void postScanEpoch(const struct Observation* observations, u32_t num, f32_t timestamp);
+
+/**
+* @brief Wait for the next scan epoch and process it.
+* @return Void.
+*/
+void runLocalizer(void);
+
+/**
+* @brief Move the particles for the time since the last epoch, weigh them
+*        by the observations of an epoch and resample them if needed.
+* @param observations The observations.
+* @param num The number of observations.
+* @param timestamp The timestamp of the epoch.
+* @return Void.
+*/
+void localizeEpoch(const struct Observation* observations, u32_t num, f32_t timestamp);
+
+/**
+* @brief Get the estimated position.
+* @param position The position.
+* @return Void.
+*/
+void getPosition(struct Position* position);
+
+/**
+* @brief Print the estimated position and the counters of the localizer.
+* @param file The file to print to.
+* @return Void.
+*/
+void printLocalizerStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* LOCALIZER_H */
\ No newline at end of file
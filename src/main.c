@@ -15,14 +15,27 @@
 #include <stdio.h>
 #include <time.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <sched.h>
 #include <pthread.h>
-#include <sys/mman.h>
 
 #include "data_types.h"
 #include "time_helpers.h"
 #include "wifi_scanner.h"
+#include "ssid_store.h"
+#include "flash_writer.h"
+#include "metrics.h"
+#include "cyclic_executive.h"
+#include "benchmarks.h"
+#include "soak.h"
+#include "uploader.h"
+#include "localizer.h"
+#include "prefetcher.h"
+#include "replay_source.h"
+#include "task_stacks.h"
+#include "memory_regions.h"
+#include "phase_controller.h"
 
 /***************************** Macro Definitions *****************************/
 
@@ -38,26 +51,118 @@
   */
 #define TASK_PRIORITY (49u)
 
-/** This is the maximum size of the stack which
-  * is guaranteed safe access without faulting.
+/** The tasks (threads), in the order they are created. */
+#define TASK_READ     (0u)
+#define TASK_STORE    (1u)
+#define TASK_UPLOAD   (2u)
+#define TASK_LOCALIZE (3u)
+#define TASK_PREFETCH (4u)
+#define TASK_REPLAY   (5u)
+#define NUM_TASKS     (6u)
+
+/** The stack sizes of the tasks, as recommended by the profiling mode (-p),
+  * so that only the stack a task needs is prefaulted and locked, instead of
+  * the default 8 MB.
   */
-#define MAX_SAFE_STACK (128u * 1024u)
+#define READ_STACK_SIZE     (28u * 1024u)
+#define STORE_STACK_SIZE    (32u * 1024u)
+#define UPLOAD_STACK_SIZE   (24u * 1024u)
+#define LOCALIZE_STACK_SIZE (28u * 1024u)
+#define PREFETCH_STACK_SIZE (32u * 1024u)
+#define REPLAY_STACK_SIZE   (24u * 1024u)
+
+/** The activities of the read task and their budgets (in msecs). The cycle
+  * time is the minor frame, so it has to fit the budgets of every frame.
+  */
+#define ACTIVITY_SCAN     (0u)
+#define ACTIVITY_FLUSH    (1u)
+#define ACTIVITY_METRICS  (2u)
+#define ACTIVITY_WATCHDOG (3u)
+#define NUM_ACTIVITIES    (4u)
+
+#define SCAN_BUDGET     (3000u)
+#define FLUSH_BUDGET    (100u)
+#define METRICS_BUDGET  (20u)
+#define WATCHDOG_BUDGET (1u)
+
+/** The number of minor frames in a major frame. */
+#define NUM_FRAMES (4u)
+
+/***************************** Type Definitions ******************************/
+
+/** A task: its entry, whether it is real-time (or runs only when the
+  * real-time tasks are idle), the size of its stack, and its thread.
+  */
+struct TaskConfig {
+  const char* name;
+  void* (*entry)(void*);
+  u8_t realtime;
+  u32_t stack_size;
+  u8_t enabled;
+  pthread_t thread;
+};
 
 /***************************** Static Variables ******************************/
 
 /** The cycle time between the task calls. */
 static u64_t read_cycle_time;
 
+/** The collector the segments are uploaded to, if they are. */
+static const char* collector = NULL;
+
+/** The directory of the log segments and of the checkpoint of the queue. */
+static const char* log_dir = LOG_DIR;
+
+/** The AP map, if the position is estimated. */
+static const char* ap_map = NULL;
+
+/** The cold tier file, if the evicted SSIDs are spilled and prefetched. */
+static const char* cold_tier = NULL;
+
+/** The directory of the segments (e.g. of an imported legacy archive), if
+  * their scans are replayed in place of the scans.
+  */
+static const char* replay = NULL;
+
+/** Whether the task stacks are profiled. */
+static u8_t profile_stacks = FALSE;
+
+/** The percentile of the scan duration that completes before the end of the
+  * cycle (0 starts the scans at the start of the cycle).
+  */
+static f64_t phase_percentile = PHASE_PERCENTILE;
+
 /** The timers of the tasks. */
 static struct timespec task_timer;
 
+/** The activities of the read task. */
+static struct Activity activities[NUM_ACTIVITIES] = {
+  { "scan",     readSSID,        SCAN_BUDGET * 1000000ull,     TRUE },
+  { "flush",    flushLog,        FLUSH_BUDGET * 1000000ull,    FALSE },
+  { "metrics",  writeMetrics,    METRICS_BUDGET * 1000000ull,  FALSE },
+  { "watchdog", checkWatchdog,   WATCHDOG_BUDGET * 1000000ull, FALSE }
+};
+
+/** The frame table of the read task. Every minor frame scans, last, at the
+  * phase offset that completes it just before the end of the frame; the log
+  * (of the previous scan) is flushed and the metrics are sampled every other
+  * frame, and the store task is checked once per major frame.
+  */
+static const struct MinorFrame frame_table[NUM_FRAMES] = {
+  { { ACTIVITY_FLUSH, ACTIVITY_SCAN }, 2 },
+  { { ACTIVITY_METRICS, ACTIVITY_SCAN }, 2 },
+  { { ACTIVITY_FLUSH, ACTIVITY_SCAN }, 2 },
+  { { ACTIVITY_WATCHDOG, ACTIVITY_METRICS, ACTIVITY_SCAN }, 3 }
+};
+
 /******************** Static General Function Prototypes *********************/
 
 /**
- * @brief Prefault the stack segment that belongs to this process.
+ * @brief Create the thread of a task, with its stack and its policy.
+ * @param task The task.
  * @return Void.
  */
-static void prefaultStack(void);
+static void createTask(struct TaskConfig* task);
 
 /********************* Static Task Function Prototypes *********************/
 
@@ -68,7 +173,8 @@ static void prefaultStack(void);
 static void INIT_TASK(int argc, char** argv);
 
 /**
- * @brief The read task scans for wifi.
+ * @brief The read task scans for wifi, and runs the periodic activities
+ *        (log flushes, metrics and watchdog) in between.
  * @return Void.
  */
 static void* READ_TASK(void* ptr);
@@ -79,36 +185,223 @@ static void* READ_TASK(void* ptr);
  */
 static void* STORE_TASK(void* ptr);
 
+/**
+ * @brief The upload task streams the sealed log segments to a collector.
+ *        It is not a real-time task, so it runs only when they are idle.
+ * @return Void.
+ */
+static void* UPLOAD_TASK(void* ptr);
+
+/**
+ * @brief The localize task estimates the position from each scan. It is not
+ *        a real-time task, and its workers run on the other CPUs.
+ * @return Void.
+ */
+static void* LOCALIZE_TASK(void* ptr);
+
+/**
+ * @brief The prefetch task warms the SSIDs expected along the route from the
+ *        cold tier. It is not a real-time task.
+ * @return Void.
+ */
+static void* PREFETCH_TASK(void* ptr);
+
+/**
+ * @brief The replay task maps and locks the segments ahead of the replay.
+ *        It is not a real-time task.
+ * @return Void.
+ */
+static void* REPLAY_TASK(void* ptr);
+
 /**
  * @brief The exit task is run after the threads are joined.
  * @return Void.
  */
 static void EXIT_TASK(void);
 
+/***************************** Task Configuration ****************************/
+
+/** The tasks. The read and store tasks always run, and the rest only when
+  * they are enabled by the options.
+  */
+static struct TaskConfig tasks[NUM_TASKS] = {
+  { "read",     READ_TASK,     TRUE,  READ_STACK_SIZE,     TRUE },
+  { "store",    STORE_TASK,    TRUE,  STORE_STACK_SIZE,    TRUE },
+  { "upload",   UPLOAD_TASK,   FALSE, UPLOAD_STACK_SIZE,   FALSE },
+  { "localize", LOCALIZE_TASK, FALSE, LOCALIZE_STACK_SIZE, FALSE },
+  { "prefetch", PREFETCH_TASK, FALSE, PREFETCH_STACK_SIZE, FALSE },
+  { "replay",   REPLAY_TASK,   FALSE, REPLAY_STACK_SIZE,   FALSE }
+};
+
 /************************** Static General Functions *************************/
 
-void prefaultStack(void)
+void createTask(struct TaskConfig* task)
 {
-  unsigned char dummy[MAX_SAFE_STACK];
+  pthread_attr_t attr;
+  struct sched_param param;
+
+  pthread_attr_init(&attr);
+  setTaskStack(&attr, task->name, task->stack_size, task->realtime);
+
+  /* The default (non real-time) policy is kept for the rest */
+  if (task->realtime)
+  {
+    pthread_attr_getschedparam(&attr, &param);
+    param.sched_priority = TASK_PRIORITY;
+    pthread_attr_setschedpolicy(&attr, SCHED_RR);
+    pthread_attr_setschedparam(&attr, &param);
+  }
+
+  (void)pthread_create(&task->thread, &attr, task->entry, (void*)NULL);
 
-  memset(dummy, 0, MAX_SAFE_STACK);
+  if (task->realtime)
+    pthread_setschedparam(task->thread, SCHED_RR, &param);
 
-  return;
+  pthread_attr_destroy(&attr);
 }
 
 /************************** Static Task Functions ****************************/
 
 void INIT_TASK(int argc, char** argv)
 {
-  if (argc != 2)
+  s32_t option;
+  u8_t scan_mode = SCAN_MODE_FULL;
+  u8_t store_policy = STORE_POLICY_TINYLFU;
+  u32_t soak_days = 0;
+
+  /* The benchmarks run while the options are parsed, so it is first */
+  initializeTimeSource();
+
+  while ((option = getopt(argc, argv, "m:e:b:s:u:o:l:c:r:pd:")) != -1)
+  {
+    switch (option)
+    {
+      case 'm':
+        if (!strcmp(optarg, "full"))
+          scan_mode = SCAN_MODE_FULL;
+        else if (!strcmp(optarg, "subset"))
+          scan_mode = SCAN_MODE_SUBSET;
+        else if (!strcmp(optarg, "adaptive"))
+          scan_mode = SCAN_MODE_ADAPTIVE;
+        else
+        {
+          perror("Unknown scan mode");
+          exit(-4);
+        }
+        break;
+
+      case 'e':
+        if (!strcmp(optarg, "lru"))
+          store_policy = STORE_POLICY_LRU;
+        else if (!strcmp(optarg, "tinylfu"))
+          store_policy = STORE_POLICY_TINYLFU;
+        else
+        {
+          perror("Unknown eviction policy");
+          exit(-4);
+        }
+        break;
+
+      case 'b':
+        if (!runBenchmark(optarg))
+        {
+          perror("Unknown benchmark");
+          exit(-4);
+        }
+        exit(0);
+
+      case 's':
+        soak_days = strtoul(optarg, NULL, 0);
+        if (soak_days < SOAK_MIN_DAYS || soak_days > SOAK_MAX_DAYS)
+        {
+          perror("Wrong number of soak days");
+          exit(-4);
+        }
+        break;
+
+      case 'u':
+        collector = optarg;
+        break;
+
+      case 'o':
+        log_dir = optarg;
+        break;
+
+      case 'l':
+        ap_map = optarg;
+        break;
+
+      case 'c':
+        cold_tier = optarg;
+        break;
+
+      case 'r':
+        replay = optarg;
+        break;
+
+      case 'p':
+        profile_stacks = TRUE;
+        break;
+
+      case 'd':
+        phase_percentile = strtod(optarg, NULL);
+        break;
+
+      default:
+        perror("Unknown option");
+        exit(-4);
+    }
+  }
+
+  /* The soak runs in virtual time, so it needs no cycle time */
+  if (soak_days)
+    exit(runSoak(soak_days, store_policy) ? 0 : -9);
+
+  if (argc - optind != 1)
   {
     perror("Wrong number of arguments");
     exit(-4);
   }
 
-  read_cycle_time = strtoul(argv[1], NULL, 0) * NSEC_PER_SEC;
+  read_cycle_time = strtoul(argv[optind], NULL, 0) * NSEC_PER_SEC;
+
+  /* The code and the static data the real-time tasks run, before the rest
+   * of the process (that stays pageable) is allocated.
+   */
+  lockProgramImage();
+
+  /* The localizer creates its workers while it is initialized */
+  initializeTaskStacks(profile_stacks);
+
+  initializeWifiScanner(scan_mode, store_policy, ap_map, cold_tier, log_dir,
+                        STAGING_FILE, QUEUE_STAGING_FILE);
+
+  initializeCyclicExecutive(activities, NUM_ACTIVITIES, frame_table, NUM_FRAMES,
+                            read_cycle_time);
+  initializePhaseController(read_cycle_time, phase_percentile);
+
+  registerMetricsSource("executive", printExecutiveStats);
+  registerMetricsSource("time", printTimeSourceStats);
+  registerMetricsSource("phase", printPhaseStats);
+  registerMetricsSource("stacks", printTaskStackStats);
+  registerMetricsSource("memory", printMemoryRegionStats);
 
-  initializeWifiScanner();
+  tasks[TASK_UPLOAD].enabled = (collector != NULL);
+  tasks[TASK_LOCALIZE].enabled = (ap_map != NULL);
+  tasks[TASK_PREFETCH].enabled = (cold_tier != NULL);
+  tasks[TASK_REPLAY].enabled = (replay != NULL);
+
+  if (collector != NULL)
+  {
+    initializeUploader(collector, log_dir);
+    registerMetricsSource("upload", printUploaderStats);
+  }
+
+  if (replay != NULL)
+  {
+    initializeReplaySource(replay);
+    registerMetricsSource("replay", printReplayStats);
+  }
 }
 
 void* READ_TASK(void* ptr)
@@ -116,25 +409,57 @@ void* READ_TASK(void* ptr)
   /* Synchronize tasks's timer. */
   clock_gettime(CLOCK_MONOTONIC, &task_timer);
 
+  /* Run the frame table, one minor frame per cycle */
+  runCyclicExecutive(&task_timer);
+
+  return (void*)NULL;
+}
+
+void* STORE_TASK(void* ptr)
+{
   while(1)
   {
-    /* Calculate next shot */
-    updateInterval(&task_timer, read_cycle_time);
+    storeSSIDs();
+  }
 
-    readSSID();
+  return (void*)NULL;
+}
 
-    /* Sleep for the remaining duration */
-    (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &task_timer, NULL);
+void* UPLOAD_TASK(void* ptr)
+{
+  while(1)
+  {
+    uploadSegments();
   }
 
   return (void*)NULL;
 }
 
-void* STORE_TASK(void* ptr)
+void* LOCALIZE_TASK(void* ptr)
 {
   while(1)
   {
-    storeSSIDs();
+    runLocalizer();
+  }
+
+  return (void*)NULL;
+}
+
+void* PREFETCH_TASK(void* ptr)
+{
+  while(1)
+  {
+    runPrefetcher();
+  }
+
+  return (void*)NULL;
+}
+
+void* REPLAY_TASK(void* ptr)
+{
+  while(1)
+  {
+    runReplaySource();
   }
 
   return (void*)NULL;
@@ -149,27 +474,11 @@ void EXIT_TASK(void)
 
 s32_t main(int argc, char** argv)
 {
+  u32_t i;
   cpu_set_t mask;
 
-  pthread_t thread_1;
-  pthread_attr_t attr_1;
-  struct sched_param param_1;
-
-  pthread_t thread_2;
-  pthread_attr_t attr_2;
-  struct sched_param param_2;
-
   /***********************************/
 
-  /* Lock memory. */
-  if(mlockall(MCL_CURRENT|MCL_FUTURE) == -1)
-  {
-    perror("mlockall failed");
-    exit(-2);
-  }
-
-  prefaultStack();
-
   CPU_ZERO(&mask);
   CPU_SET(NUM_CPUS, &mask);
   if (sched_setaffinity(0, sizeof(mask), &mask) == -1)
@@ -184,30 +493,19 @@ s32_t main(int argc, char** argv)
 
   /***********************************/
 
-  pthread_attr_init(&attr_1);
-  pthread_attr_getschedparam(&attr_1, &param_1);
-  param_1.sched_priority = TASK_PRIORITY;
-  pthread_attr_setschedpolicy(&attr_1, SCHED_RR);
-  pthread_attr_setschedparam(&attr_1, &param_1);
-
-  (void)pthread_create(&thread_1, &attr_1, (void*)READ_TASK, (void*)NULL);
-  pthread_setschedparam(thread_1, SCHED_RR, &param_1);
-
-  /***********************************/
-
-  pthread_attr_init(&attr_2);
-  pthread_attr_getschedparam(&attr_2, &param_2);
-  param_2.sched_priority = TASK_PRIORITY;
-  pthread_attr_setschedpolicy(&attr_2, SCHED_RR);
-  pthread_attr_setschedparam(&attr_2, &param_2);
-
-  (void)pthread_create(&thread_2, &attr_2, (void*)STORE_TASK, (void*)NULL);
-  pthread_setschedparam(thread_2, SCHED_RR, &param_2);
+  for (i = 0; i < NUM_TASKS; i++)
+  {
+    if (tasks[i].enabled)
+      createTask(&tasks[i]);
+  }
 
   /***********************************/
 
-  pthread_join(thread_1, NULL);
-  pthread_join(thread_2, NULL);
+  for (i = 0; i < NUM_TASKS; i++)
+  {
+    if (tasks[i].enabled)
+      pthread_join(tasks[i].thread, NULL);
+  }
 
   EXIT_TASK();
 
@@ -0,0 +1,333 @@
+/**
+  * @file memory_regions.c
+  * @brief Implements the memory regions, i.e. the selective locking of the
+  *        memory that the real-time tasks access (instead of locking every
+  *        page the process ever touches), and the report of the locked and
+  *        the pageable footprint.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "memory_regions.h"
+
+/***************************** Type Definitions ******************************/
+
+/** A region of memory. */
+struct MemoryRegion {
+  const char* name;
+  void* addr;
+  u64_t size;  /* in whole pages */
+  u8_t locked;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The regions. */
+static struct MemoryRegion regions[MAX_MEMORY_REGIONS];
+static u32_t region_num;
+static pthread_mutex_t regions_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Add a region to the report.
+ * @param name The name of the region.
+ * @param addr The start of the region.
+ * @param size The size of the region (in bytes).
+ * @param locked Whether the region is locked.
+ * @return Void.
+ */
+static void addRegion(const char* name, void* addr, u64_t size, u8_t locked);
+
+/**
+ * @brief Read a footprint of the process from /proc/self/status.
+ * @param field The field (e.g. "VmLck:").
+ * @return The footprint (in KB), 0 if it could not be read.
+ */
+static u64_t readProcessFootprint(const char* field);
+
+/**
+ * @brief Get the name of a mapping of the image of the program.
+ * @param library Whether the mapping is of libc (or of the executable).
+ * @param perms The permissions of the mapping (as in /proc/self/maps).
+ * @return The name of the region.
+ */
+static const char* imageRegionName(u8_t library, const char* perms);
+
+/**
+ * @brief Get the size of the union of the regions that are (or are not)
+ *        locked, since a region may be part of another.
+ * @param locked Whether the locked regions are summed.
+ * @return The size (in bytes).
+ */
+static u64_t sumRegions(u8_t locked);
+
+/**
+ * @brief Check whether a page is part of a locked region.
+ * @param page_start The start of the page.
+ * @return TRUE if the page is locked by a region, FALSE otherwise.
+ */
+static u8_t isPageLocked(u64_t page_start);
+
+/**
+ * @brief Unlock the pages of a released region that no other locked region
+ *        touches, since mlock is not counted (e.g. a static region is also
+ *        part of the locked bss, and a page may be shared by two buffers).
+ * @param start The start of the region (page aligned).
+ * @param size The size of the region (in whole pages).
+ * @return Void.
+ */
+static void unlockPages(u64_t start, u64_t size);
+
+/***************************** Static Functions ******************************/
+
+void addRegion(const char* name, void* addr, u64_t size, u8_t locked)
+{
+  u64_t page = sysconf(_SC_PAGESIZE);
+
+  /* The pages the region touches, since that is what is locked */
+  size = ((u64_t)addr + size + page - 1) / page * page - (u64_t)addr / page * page;
+
+  pthread_mutex_lock(&regions_mutex);
+
+  if (region_num < MAX_MEMORY_REGIONS)
+  {
+    regions[region_num].name = name;
+    regions[region_num].addr = addr;
+    regions[region_num].size = size;
+    regions[region_num].locked = locked;
+    region_num++;
+  }
+
+  pthread_mutex_unlock(&regions_mutex);
+}
+
+u64_t readProcessFootprint(const char* field)
+{
+  u64_t footprint = 0;
+  char line[128];
+  FILE* file = fopen("/proc/self/status", "r");
+
+  if (file == NULL)
+    return 0;
+
+  while (fgets(line, sizeof(line), file) != NULL)
+  {
+    if (!strncmp(line, field, strlen(field)))
+    {
+      footprint = strtoull(line + strlen(field), NULL, 10);
+      break;
+    }
+  }
+
+  fclose(file);
+
+  return footprint;
+}
+
+const char* imageRegionName(u8_t library, const char* perms)
+{
+  if (perms[2] == 'x')
+    return library ? "libc text" : "exe text";
+  if (perms[1] == 'w')
+    return library ? "libc data" : "exe data";
+
+  return library ? "libc rodata" : "exe rodata";
+}
+
+u64_t sumRegions(u8_t locked)
+{
+  u32_t i, j, num = 0;
+  u64_t start, end, covered = 0, total = 0;
+  u64_t page = sysconf(_SC_PAGESIZE);
+  struct MemoryRegion sorted[MAX_MEMORY_REGIONS], swap;
+
+  for (i = 0; i < region_num; i++)
+  {
+    if (regions[i].locked == locked)
+      sorted[num++] = regions[i];
+  }
+
+  /* By start (an insertion sort, since there are few) */
+  for (i = 1; i < num; i++)
+  {
+    for (j = i; j > 0 && sorted[j - 1].addr > sorted[j].addr; j--)
+    {
+      swap = sorted[j];
+      sorted[j] = sorted[j - 1];
+      sorted[j - 1] = swap;
+    }
+  }
+
+  for (i = 0; i < num; i++)
+  {
+    start = (u64_t)sorted[i].addr / page * page;
+    end = start + sorted[i].size;
+
+    if (start < covered)
+      start = covered;
+    if (end > start)
+      total += end - start;
+    if (end > covered)
+      covered = end;
+  }
+
+  return total;
+}
+
+u8_t isPageLocked(u64_t page_start)
+{
+  u32_t i;
+  u64_t page = sysconf(_SC_PAGESIZE), start;
+
+  for (i = 0; i < region_num; i++)
+  {
+    start = (u64_t)regions[i].addr / page * page;
+
+    if (regions[i].locked && page_start >= start && page_start < start + regions[i].size)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+void unlockPages(u64_t start, u64_t size)
+{
+  u64_t page = sysconf(_SC_PAGESIZE), address, run = start;
+
+  for (address = start; address <= start + size; address += page)
+  {
+    /* Unlock every run of pages that are no longer locked by any region */
+    if (address == start + size || isPageLocked(address))
+    {
+      if (address > run)
+        munlock((void*)run, address - run);
+
+      run = address + page;
+    }
+  }
+}
+
+/***************************** Public Functions ******************************/
+
+void lockMemoryRegion(const char* name, void* addr, u64_t size)
+{
+  /* mlock faults all of the pages in, so they are prefaulted too */
+  if (mlock(addr, size) == -1)
+  {
+    perror("mlock failed");
+    exit(-2);
+  }
+
+  addRegion(name, addr, size, TRUE);
+}
+
+void lockProgramImage(void)
+{
+  extern char end;  /* the end of the bss (set by the linker) */
+  u64_t start, stop, image_end = 0;
+  u8_t library;
+  char line[PATH_MAX + 128], perms[8], path[PATH_MAX], exe[PATH_MAX];
+  ssize_t length;
+  FILE* maps;
+
+  if ((length = readlink("/proc/self/exe", exe, sizeof(exe) - 1)) == -1 ||
+      (maps = fopen("/proc/self/maps", "r")) == NULL)
+  {
+    perror("Could not find the image of the program");
+    exit(-2);
+  }
+
+  exe[length] = '\0';
+
+  while (fgets(line, sizeof(line), maps) != NULL)
+  {
+    if (sscanf(line, "%llx-%llx %7s %*s %*s %*s %4095s", &start, &stop, perms, path) != 4)
+      continue;
+
+    library = (strstr(path, "/" MEMORY_LIBC_NAME) != NULL);
+
+    if (!library && strcmp(path, exe))
+      continue;
+
+    lockMemoryRegion(imageRegionName(library, perms), (void*)start, stop - start);
+
+    if (!library && stop > image_end)
+      image_end = stop;
+  }
+
+  fclose(maps);
+
+  /* The bss past the last page of the data is mapped anonymously */
+  if ((u64_t)&end > image_end && image_end)
+    lockMemoryRegion("exe bss", (void*)image_end, (u64_t)&end - image_end);
+}
+
+void addMemoryRegion(const char* name, void* addr, u64_t size)
+{
+  addRegion(name, addr, size, FALSE);
+}
+
+void releaseMemoryRegion(void* addr)
+{
+  u32_t i;
+  u64_t page = sysconf(_SC_PAGESIZE);
+  struct MemoryRegion released;
+
+  pthread_mutex_lock(&regions_mutex);
+
+  for (i = 0; i < region_num; i++)
+  {
+    if (regions[i].addr == addr)
+    {
+      released = regions[i];
+      regions[i] = regions[--region_num];
+
+      if (released.locked)
+        unlockPages((u64_t)addr / page * page, released.size);
+
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&regions_mutex);
+}
+
+void printMemoryRegionStats(FILE* file)
+{
+  u32_t i;
+  u64_t locked, pageable;
+
+  pthread_mutex_lock(&regions_mutex);
+
+  fprintf(file, "region       size_kb  locked\n");
+
+  for (i = 0; i < region_num; i++)
+  {
+    fprintf(file, "%-12s %-8llu %s\n", regions[i].name, regions[i].size / 1024,
+            regions[i].locked ? "yes" : "no");
+  }
+
+  locked = sumRegions(TRUE);
+  pageable = sumRegions(FALSE);
+
+  pthread_mutex_unlock(&regions_mutex);
+
+  fprintf(file, "locked_kb    %llu\n", locked / 1024);
+  fprintf(file, "pageable_kb  %llu\n", pageable / 1024);
+
+  /* The rest of the process (heap, libraries, mapped segments) is pageable */
+  fprintf(file, "process_locked_kb  %llu\n", readProcessFootprint("VmLck:"));
+  fprintf(file, "process_rss_kb     %llu\n", readProcessFootprint("VmRSS:"));
+}
\ No newline at end of file
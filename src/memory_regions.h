@@ -0,0 +1,87 @@
+/**
+  * @file memory_regions.h
+  * @brief Contains the declarations of functions defined in memory_regions.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef MEMORY_REGIONS_H
+#define MEMORY_REGIONS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max number of regions that are reported. */
+#define MAX_MEMORY_REGIONS (48u)
+
+/** The shared library whose code and data the real-time tasks run, and that
+  * is locked along with the executable.
+  */
+#define MEMORY_LIBC_NAME "libc.so"
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Lock a region that the real-time tasks access (so that they never
+*        fault on it), prefaulting all of its pages, and report it.
+* @param name The name of the region.
+* @param addr The start of the region.
+* @param size The size of the region (in bytes).
+* @return Void.
+*/
+void lockMemoryRegion(const char* name, void* addr, u64_t size);
+
+/**
+* @brief Lock the image of the program (the code, the static data and the
+*        bss of the executable, and the mappings of libc), as found in
+*        /proc/self/maps, and report every mapping as a region. Unlike
+*        mlockall, the memory allocated later is not locked.
+* @return Void.
+*/
+void lockProgramImage(void);
+
+/**
+* @brief Report a region that is left pageable, since only the non real-time
+*        tasks access it.
+* @param name The name of the region.
+* @param addr The start of the region.
+* @param size The size of the region (in bytes).
+* @return Void.
+*/
+void addMemoryRegion(const char* name, void* addr, u64_t size);
+
+/**
+* @brief Unlock a region (if it is locked) and stop reporting it, before it
+*        is freed. The pages that another locked region touches (e.g. the
+*        image of the program) are left locked.
+* @param addr The start of the region.
+* @return Void.
+*/
+void releaseMemoryRegion(void* addr);
+
+/**
+* @brief Print the regions, the locked and the pageable footprint (of the
+*        union of the regions, since the static ones are in the bss), and
+*        those of the whole process.
+* @param file The file to print the stats to.
+* @return Void.
+*/
+void printMemoryRegionStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* MEMORY_REGIONS_H */
\ No newline at end of file
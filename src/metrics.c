@@ -0,0 +1,73 @@
+/**
+  * @file metrics.c
+  * @brief Implements a registry of metrics that the modules expose to a file.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <pthread.h>
+
+#include "flash_writer.h"
+
+#include "metrics.h"
+
+/***************************** Type Definitions ******************************/
+
+/** A module that exposes its metrics. */
+struct MetricsSource {
+  const char* name;
+  MetricsWriter writer;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The registered modules. */
+static struct MetricsSource sources[MAX_METRICS_SOURCES];
+static u32_t source_num = 0;
+
+/** Guards the registry, since the sources are registered and written from
+  * different tasks.
+  */
+static pthread_mutex_t metrics_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/***************************** Public Functions ******************************/
+
+void registerMetricsSource(const char* name, MetricsWriter writer)
+{
+  pthread_mutex_lock(&metrics_mutex);
+
+  if (source_num < MAX_METRICS_SOURCES)
+  {
+    sources[source_num].name = name;
+    sources[source_num].writer = writer;
+    source_num++;
+  }
+
+  pthread_mutex_unlock(&metrics_mutex);
+}
+
+void writeMetrics(void)
+{
+  u32_t i;
+
+  FILE *file = fopen(STAGING_DIR "/" METRICS_FILE, "w");
+
+  if (file != NULL)
+  {
+    pthread_mutex_lock(&metrics_mutex);
+
+    for (i = 0; i < source_num; i++)
+    {
+      fprintf(file, "[%s]\n", sources[i].name);
+      sources[i].writer(file);
+      fprintf(file, "\n");
+    }
+
+    pthread_mutex_unlock(&metrics_mutex);
+
+    fclose(file);
+  }
+}
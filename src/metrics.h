@@ -0,0 +1,59 @@
+/**
+  * @file metrics.h
+  * @brief Contains the declarations of functions defined in metrics.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The file that the metrics are written to (in the staging directory,
+  * since it is rewritten often).
+  */
+#define METRICS_FILE "metrics.txt"
+
+/** The max number of modules that can register their metrics. */
+#define MAX_METRICS_SOURCES (16u)
+
+/***************************** Type Definitions ******************************/
+
+/** The callback a module provides to print its metrics to a file. */
+typedef void (*MetricsWriter)(FILE* file);
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Register a module's metrics, to be written along with the others.
+* @param name The name of the section the metrics are written under.
+* @param writer The callback that prints the metrics.
+* @return Void.
+*/
+void registerMetricsSource(const char* name, MetricsWriter writer);
+
+/**
+* @brief Write the metrics of all the registered modules to the metrics file.
+* @return Void.
+*/
+void writeMetrics(void);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* METRICS_H */
@@ -0,0 +1,178 @@
+/**
+  * @file phase_controller.c
+  * @brief Implements the phase controller of the scans, i.e. it learns the
+  *        distribution of the scan duration, and starts each scan at an
+  *        offset into its cycle, so that it completes just before the end
+  *        of the cycle (when its data is consumed) instead of right after
+  *        its start, which keeps the data fresh.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "time_helpers.h"
+
+#include "phase_controller.h"
+
+/***************************** Static Variables ******************************/
+
+/** The cycle and the percentile of the scan duration that has to fit. */
+static u64_t cycle_length;
+static f64_t phase_percentile;
+
+/** The durations of the latest scans (a ring), and the offset they give.
+  * They are only accessed by the read task, which also writes the metrics.
+  */
+static u64_t durations[PHASE_WINDOW];
+static u64_t scans;
+static u64_t offset;
+
+/** The age of the data of the latest scans (a ring) when it is consumed, its
+  * sum over all the scans, and the scans that completed after the end of
+  * their cycle.
+  */
+static u64_t ages[PHASE_WINDOW];
+static f64_t age_sum;
+static u64_t late_scans;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Update the offset from the learned durations.
+ * @return Void.
+ */
+static void updateOffset(void);
+
+/**
+ * @brief Sort the latest values of a ring.
+ * @param ring The ring.
+ * @param sorted The sorted values.
+ * @return The number of values.
+ */
+static u32_t sortWindow(const u64_t* ring, u64_t* sorted);
+
+/**
+ * @brief Compare two durations (for qsort).
+ * @param a The first duration.
+ * @param b The second duration.
+ * @return The order of the durations.
+ */
+static int compareDurations(const void* a, const void* b);
+
+/***************************** Static Functions ******************************/
+
+void updateOffset(void)
+{
+  u32_t num, index;
+  u64_t expected, sorted[PHASE_WINDOW];
+
+  if (phase_percentile <= 0 || scans < PHASE_MIN_SCANS)
+  {
+    offset = 0;
+    return;
+  }
+
+  num = sortWindow(durations, sorted);
+
+  index = (u32_t)(phase_percentile / 100.0 * num);
+  expected = sorted[(index < num) ? index : num - 1] + PHASE_GUARD * 1000000ull;
+
+  offset = (expected < cycle_length) ? cycle_length - expected : 0;
+}
+
+u32_t sortWindow(const u64_t* ring, u64_t* sorted)
+{
+  u32_t num = (scans < PHASE_WINDOW) ? scans : PHASE_WINDOW;
+
+  memcpy(sorted, ring, num * sizeof(u64_t));
+  qsort(sorted, num, sizeof(u64_t), compareDurations);
+
+  return num;
+}
+
+int compareDurations(const void* a, const void* b)
+{
+  u64_t x = *(const u64_t*)a, y = *(const u64_t*)b;
+
+  return (x > y) - (x < y);
+}
+
+/***************************** Public Functions ******************************/
+
+void initializePhaseController(u64_t cycle, f64_t percentile)
+{
+  cycle_length = cycle;
+  phase_percentile = (percentile > 100.0) ? 100.0 : percentile;
+
+  scans = 0;
+  offset = 0;
+  age_sum = 0;
+  late_scans = 0;
+}
+
+u64_t getPhaseOffset(void)
+{
+  return offset;
+}
+
+void waitForPhase(const struct timespec* cycle_start)
+{
+  struct timespec phase_time = *cycle_start;
+
+  if (offset == 0)
+    return;
+
+  updateInterval(&phase_time, offset);
+
+  /* An absolute sleep, so that the activities before the scan do not shift it */
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &phase_time, NULL) == EINTR)
+    ;
+}
+
+void recordPhasedScan(const struct timespec* cycle_start, u64_t start, u64_t end)
+{
+  u64_t cycle_end = (u64_t)cycle_start->tv_sec * NSEC_PER_SEC + cycle_start->tv_nsec +
+                    cycle_length;
+
+  /* A late scan is only consumed at the end of the next cycle */
+  if (end > cycle_end)
+  {
+    late_scans++;
+
+    while (end > cycle_end)
+      cycle_end += cycle_length;
+  }
+
+  durations[scans % PHASE_WINDOW] = end - start;
+  ages[scans % PHASE_WINDOW] = cycle_end - start;
+  age_sum += (cycle_end - start) / 1e6;
+  scans++;
+
+  updateOffset();
+}
+
+void printPhaseStats(FILE* file)
+{
+  u32_t num;
+  u64_t sorted[PHASE_WINDOW];
+
+  fprintf(file, "percentile    %.1f\n", phase_percentile);
+  fprintf(file, "offset_ms     %.1f\n", offset / 1e6);
+
+  num = sortWindow(durations, sorted);
+  fprintf(file, "scan_p50_ms   %.1f\n", num ? sorted[num / 2] / 1e6 : 0.0);
+  fprintf(file, "scan_max_ms   %.1f\n", num ? sorted[num - 1] / 1e6 : 0.0);
+
+  /* The age is from the start of the scan, i.e. of its oldest sighting */
+  num = sortWindow(ages, sorted);
+  fprintf(file, "age_p50_ms    %.1f\n", num ? sorted[num / 2] / 1e6 : 0.0);
+  fprintf(file, "age_max_ms    %.1f\n", num ? sorted[num - 1] / 1e6 : 0.0);
+  fprintf(file, "age_mean_ms   %.1f\n", scans ? age_sum / scans : 0.0);
+  fprintf(file, "late_scans    %llu\n", late_scans);
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+  * @file phase_controller.h
+  * @brief Contains the declarations of functions defined in phase_controller.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef PHASE_CONTROLLER_H
+#define PHASE_CONTROLLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The default percentile of the scan duration that has to complete before
+  * the end of the cycle.
+  */
+#define PHASE_PERCENTILE (99.0)
+
+/** The number of the latest scans whose durations are learned, so that the
+  * offset follows the conditions (e.g. the number of APs around).
+  */
+#define PHASE_WINDOW (64u)
+
+/** The scans that are learned before the scans are delayed at all. */
+#define PHASE_MIN_SCANS (8u)
+
+/** The margin (in msecs) between the end of a scan and the end of the cycle,
+  * for the activities of the frame that run after it.
+  */
+#define PHASE_GUARD (50u)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the controller.
+* @param cycle The cycle (the minor frame) the scans are aligned to (in nsecs).
+* @param percentile The percentile of the scan duration that has to complete
+*        before the end of the cycle (0 to 100), or 0 to start every scan at
+*        the start of its cycle.
+* @return Void.
+*/
+void initializePhaseController(u64_t cycle, f64_t percentile);
+
+/**
+* @brief Get the offset of the scans from the start of their cycle.
+* @return The offset (in nsecs).
+*/
+u64_t getPhaseOffset(void);
+
+/**
+* @brief Sleep until the offset of the scan of a cycle.
+* @param cycle_start The start of the cycle.
+* @return Void.
+*/
+void waitForPhase(const struct timespec* cycle_start);
+
+/**
+* @brief Learn the duration of a scan, and account the age of its data at the
+*        end of its cycle, when it is consumed.
+* @param cycle_start The start of the cycle.
+* @param start The start of the scan (monotonic, in nsecs).
+* @param end The end of the scan (monotonic, in nsecs).
+* @return Void.
+*/
+void recordPhasedScan(const struct timespec* cycle_start, u64_t start, u64_t end);
+
+/**
+* @brief Print the offset, the scan durations and the age of the data.
+* @param file The file to print the stats to.
+* @return Void.
+*/
+void printPhaseStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* PHASE_CONTROLLER_H */
\ No newline at end of file
@@ -0,0 +1,420 @@
+/**
+  * @file prefetcher.c
+  * @brief Implements a route-aware prefetcher: it learns which SSIDs
+  *        usually appear after the ones that appear in a scan, and warms
+  *        them from the cold tier before they are sighted.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include "ssid_store.h"
+#include "cold_tier.h"
+
+#include "prefetcher.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max number of SSIDs that are scored as candidates for a prefetch. */
+#define MAX_CANDIDATES (PREFETCH_MAX_SCAN * PREFETCH_SUCCESSORS)
+
+/***************************** Type Definitions ******************************/
+
+/** An SSID that appeared after another one, and how often it did. */
+struct Successor {
+  u32_t hash;
+  u16_t count;
+};
+
+/** The SSIDs that appeared after an SSID (the most frequent ones are kept
+  * with the Misra-Gries algorithm).
+  */
+struct Transitions {
+  u32_t hash;
+  u32_t last_epoch;
+  u8_t valid;
+  u8_t num;
+  struct Successor successors[PREFETCH_SUCCESSORS];
+};
+
+/** An SSID that may be prefetched, scored by the transitions into it. */
+struct Candidate {
+  u32_t hash;
+  u32_t score;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The transition table. */
+static struct Transitions table[PREFETCH_SETS][PREFETCH_WAYS];
+
+/** The known SSIDs of the last epochs, and the ones that appeared in the
+  * last epoch that any did.
+  */
+static u32_t window[PREFETCH_WINDOW][PREFETCH_MAX_SCAN];
+static u32_t window_num[PREFETCH_WINDOW];
+static u32_t window_next;
+static u32_t last_appeared[PREFETCH_MAX_SCAN];
+static u32_t last_appeared_num;
+static u32_t epoch;
+
+/** The epoch handed over by the store task. */
+static struct SightedSSID pending[PREFETCH_MAX_SCAN];
+static u32_t pending_num;
+static u8_t pending_ready;
+static pthread_cond_t pending_cond = PTHREAD_COND_INITIALIZER;
+
+/** The counters of the prefetcher. */
+static u64_t epochs, dropped_epochs, appeared, learned, predicted, loaded;
+
+/** Guards the pending epoch and the counters. */
+static pthread_mutex_t prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Check whether a list of hashes contains a hash.
+ * @param hashes The hashes.
+ * @param num The number of hashes.
+ * @param hash The hash.
+ * @return TRUE if it does, FALSE otherwise.
+ */
+static u8_t containsHash(const u32_t* hashes, u32_t num, u32_t hash);
+
+/**
+ * @brief Find the transitions of an SSID.
+ * @param hash The hash of the SSID.
+ * @param create Whether they are created if they are not found.
+ * @return The transitions, or NULL.
+ */
+static struct Transitions* findTransitions(u32_t hash, u8_t create);
+
+/**
+ * @brief Count a transition between two SSIDs.
+ * @param from The hash of the SSID that appeared first.
+ * @param to The hash of the SSID that appeared after it.
+ * @return Void.
+ */
+static void learnTransition(u32_t from, u32_t to);
+
+/**
+ * @brief Add to the score of a candidate.
+ * @param candidates The candidates.
+ * @param num The number of candidates.
+ * @param hash The hash of the candidate.
+ * @param score The score to add.
+ * @return The new number of candidates.
+ */
+static u32_t scoreCandidate(struct Candidate* candidates, u32_t num, u32_t hash, u32_t score);
+
+/**
+ * @brief Predict the SSIDs that will appear next.
+ * @param appeared The SSIDs that appeared in the epoch.
+ * @param num The number of SSIDs that appeared.
+ * @param known The known SSIDs of the epoch (that are not predicted).
+ * @param known_num The number of known SSIDs.
+ * @param predictions The predicted SSIDs, most likely first.
+ * @return The number of predicted SSIDs (up to PREFETCH_DEPTH).
+ */
+static u32_t predictSSIDs(const u32_t* appeared, u32_t num, const u32_t* known,
+                          u32_t known_num, u32_t* predictions);
+
+/***************************** Static Functions ******************************/
+
+u8_t containsHash(const u32_t* hashes, u32_t num, u32_t hash)
+{
+  u32_t i;
+
+  for (i = 0; i < num; i++)
+  {
+    if (hashes[i] == hash)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+struct Transitions* findTransitions(u32_t hash, u8_t create)
+{
+  u32_t way, victim = 0;
+  struct Transitions* set = table[hash % PREFETCH_SETS];
+
+  for (way = 0; way < PREFETCH_WAYS; way++)
+  {
+    if (set[way].valid && set[way].hash == hash)
+      return &set[way];
+  }
+
+  if (!create)
+    return NULL;
+
+  for (way = 0; way < PREFETCH_WAYS; way++)
+  {
+    if (!set[way].valid)
+    {
+      victim = way;
+      break;
+    }
+
+    if (set[way].last_epoch < set[victim].last_epoch)
+      victim = way;
+  }
+
+  memset(&set[victim], 0, sizeof(struct Transitions));
+  set[victim].hash = hash;
+  set[victim].valid = TRUE;
+
+  return &set[victim];
+}
+
+void learnTransition(u32_t from, u32_t to)
+{
+  u32_t i, j;
+  struct Transitions* transitions = findTransitions(from, TRUE);
+
+  transitions->last_epoch = epoch;
+
+  for (i = 0; i < transitions->num; i++)
+  {
+    if (transitions->successors[i].hash == to)
+    {
+      if (++transitions->successors[i].count == U16_MAX)
+      {
+        for (j = 0; j < transitions->num; j++)
+          transitions->successors[j].count /= 2;
+      }
+
+      return;
+    }
+  }
+
+  if (transitions->num < PREFETCH_SUCCESSORS)
+  {
+    transitions->successors[transitions->num].hash = to;
+    transitions->successors[transitions->num].count = 1;
+    transitions->num++;
+    return;
+  }
+
+  /* Misra-Gries: a new successor decrements all the others, and the ones
+   * that reach zero make room.
+   */
+  for (i = 0, j = 0; i < transitions->num; i++)
+  {
+    if (--transitions->successors[i].count)
+      transitions->successors[j++] = transitions->successors[i];
+  }
+
+  transitions->num = j;
+}
+
+u32_t scoreCandidate(struct Candidate* candidates, u32_t num, u32_t hash, u32_t score)
+{
+  u32_t i;
+
+  for (i = 0; i < num; i++)
+  {
+    if (candidates[i].hash == hash)
+    {
+      candidates[i].score += score;
+      return num;
+    }
+  }
+
+  if (num < MAX_CANDIDATES)
+  {
+    candidates[num].hash = hash;
+    candidates[num].score = score;
+    num++;
+  }
+
+  return num;
+}
+
+u32_t predictSSIDs(const u32_t* appeared, u32_t num, const u32_t* known,
+                   u32_t known_num, u32_t* predictions)
+{
+  u32_t i, j, hop, best, first = 0, last = 0, candidate_num = 0, prediction_num = 0;
+  struct Transitions* transitions;
+  struct Candidate candidates[MAX_CANDIDATES];
+  struct Candidate swap;
+
+  for (hop = 0; hop < PREFETCH_HOPS; hop++)
+  {
+    /* The first hop follows the SSIDs that appeared, and the next ones the
+     * candidates of the previous hop, at half the weight each time.
+     */
+    for (i = first; i < ((hop == 0) ? num : last); i++)
+    {
+      transitions = findTransitions((hop == 0) ? appeared[i] : candidates[i].hash, FALSE);
+
+      if (transitions == NULL)
+        continue;
+
+      for (j = 0; j < transitions->num; j++)
+      {
+        if (transitions->successors[j].count >= PREFETCH_MIN_COUNT &&
+            !containsHash(known, known_num, transitions->successors[j].hash))
+          candidate_num = scoreCandidate(candidates, candidate_num, transitions->successors[j].hash,
+                                         transitions->successors[j].count >> hop);
+      }
+    }
+
+    first = (hop == 0) ? 0 : last;
+    last = candidate_num;
+  }
+
+  /* Selection of the best candidates */
+  for (i = 0; i < candidate_num && prediction_num < PREFETCH_DEPTH; i++)
+  {
+    for (best = i, j = i + 1; j < candidate_num; j++)
+    {
+      if (candidates[j].score > candidates[best].score)
+        best = j;
+    }
+
+    swap = candidates[i];
+    candidates[i] = candidates[best];
+    candidates[best] = swap;
+
+    if (candidates[i].score > 0)
+      predictions[prediction_num++] = candidates[i].hash;
+  }
+
+  return prediction_num;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializePrefetcher(void)
+{
+  memset(table, 0, sizeof(table));
+  memset(window_num, 0, sizeof(window_num));
+  window_next = 0;
+  last_appeared_num = 0;
+  epoch = 0;
+
+  pending_ready = FALSE;
+  epochs = dropped_epochs = appeared = learned = predicted = loaded = 0;
+}
+
+void postStoredEpoch(const struct SightedSSID* ssids, u32_t num)
+{
+  pthread_mutex_lock(&prefetch_mutex);
+
+  if (pending_ready)
+    dropped_epochs++;
+
+  pending_num = (num < PREFETCH_MAX_SCAN) ? num : PREFETCH_MAX_SCAN;
+  memcpy(pending, ssids, pending_num * sizeof(struct SightedSSID));
+  pending_ready = TRUE;
+
+  pthread_mutex_unlock(&prefetch_mutex);
+  pthread_cond_signal(&pending_cond);
+}
+
+void runPrefetcher(void)
+{
+  u32_t num;
+  struct SightedSSID ssids[PREFETCH_MAX_SCAN];
+
+  pthread_mutex_lock(&prefetch_mutex);
+  while (!pending_ready)
+    pthread_cond_wait(&pending_cond, &prefetch_mutex);
+
+  num = pending_num;
+  memcpy(ssids, pending, num * sizeof(struct SightedSSID));
+  pending_ready = FALSE;
+
+  pthread_mutex_unlock(&prefetch_mutex);
+
+  /* The file I/O of the cold tier that the store task queued */
+  serviceColdTier();
+
+  prefetchEpoch(ssids, num);
+}
+
+void prefetchEpoch(const struct SightedSSID* ssids, u32_t num)
+{
+  u32_t i, j, w, known_num = 0, appeared_num = 0, prediction_num, epoch_loaded = 0, epoch_learned = 0;
+  u32_t known[PREFETCH_MAX_SCAN];
+  u32_t appeared_now[PREFETCH_MAX_SCAN];
+  u32_t predictions[PREFETCH_DEPTH];
+  u8_t seen;
+
+  epoch++;
+
+  /* Only the known SSIDs are followed, since a new one (like a roadside AP
+   * passed once) tells nothing about the route.
+   */
+  for (i = 0; i < num && i < PREFETCH_MAX_SCAN; i++)
+  {
+    if (ssids[i].tier == STORE_TIER_NEW || containsHash(known, known_num, ssids[i].hash))
+      continue;
+
+    known[known_num++] = ssids[i].hash;
+
+    for (w = 0, seen = FALSE; w < PREFETCH_WINDOW && !seen; w++)
+      seen = containsHash(window[w], window_num[w], ssids[i].hash);
+
+    if (!seen)
+      appeared_now[appeared_num++] = ssids[i].hash;
+  }
+
+  memcpy(window[window_next], known, known_num * sizeof(u32_t));
+  window_num[window_next] = known_num;
+  window_next = (window_next + 1) % PREFETCH_WINDOW;
+
+  if (appeared_num == 0)
+  {
+    pthread_mutex_lock(&prefetch_mutex);
+    epochs++;
+    pthread_mutex_unlock(&prefetch_mutex);
+    return;
+  }
+
+  for (i = 0; i < last_appeared_num; i++)
+  {
+    for (j = 0; j < appeared_num; j++)
+      learnTransition(last_appeared[i], appeared_now[j]);
+  }
+
+  epoch_learned = last_appeared_num * appeared_num;
+
+  memcpy(last_appeared, appeared_now, appeared_num * sizeof(u32_t));
+  last_appeared_num = appeared_num;
+
+  prediction_num = predictSSIDs(appeared_now, appeared_num, known, known_num, predictions);
+
+  for (i = 0; i < prediction_num; i++)
+    epoch_loaded += prefetchColdEntry(predictions[i]);
+
+  pthread_mutex_lock(&prefetch_mutex);
+  epochs++;
+  appeared += appeared_num;
+  learned += epoch_learned;
+  predicted += prediction_num;
+  loaded += epoch_loaded;
+  pthread_mutex_unlock(&prefetch_mutex);
+}
+
+void printPrefetcherStats(FILE* file)
+{
+  pthread_mutex_lock(&prefetch_mutex);
+
+  fprintf(file, "epochs      %llu\n", epochs);
+  fprintf(file, "dropped     %llu\n", dropped_epochs);
+  fprintf(file, "appeared    %llu\n", appeared);
+  fprintf(file, "transitions %llu\n", learned);
+  fprintf(file, "predicted   %llu\n", predicted);
+  fprintf(file, "loaded      %llu\n", loaded);
+
+  pthread_mutex_unlock(&prefetch_mutex);
+}
\ No newline at end of file
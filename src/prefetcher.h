@@ -0,0 +1,103 @@
+/**
+  * @file prefetcher.h
+  * @brief Contains the declarations of functions defined in prefetcher.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max number of SSIDs of a scan epoch that are considered. */
+#define PREFETCH_MAX_SCAN (128u)
+
+/** The transition table: for each SSID, the SSIDs that usually appear after
+  * it, i.e. in the next epoch that any known SSID appears in. It is a
+  * set-associative table, replaced by the SSID that appeared the longest ago.
+  */
+#define PREFETCH_SETS       (1024u)
+#define PREFETCH_WAYS       (4u)
+#define PREFETCH_SUCCESSORS (8u)
+
+/** The number of past epochs that an SSID must be missing from, to count as
+  * appearing (so that an AP missed by a single scan is not counted).
+  */
+#define PREFETCH_WINDOW (3u)
+
+/** The times a transition has to be seen before it is used. */
+#define PREFETCH_MIN_COUNT (2u)
+
+/** The max number of SSIDs prefetched per epoch, and the number of
+  * transitions followed ahead (the second one at half the weight).
+  */
+#define PREFETCH_DEPTH (16u)
+#define PREFETCH_HOPS  (2u)
+
+/***************************** Type Definitions ******************************/
+
+/** An SSID of a stored epoch, and where it was found when it was stored. */
+struct SightedSSID {
+  u32_t hash;
+  u8_t tier;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module, with an empty transition table.
+* @return Void.
+*/
+void initializePrefetcher(void);
+
+/**
+* @brief Hand the SSIDs of a stored epoch to the prefetch task. It does not
+*        block; an epoch that was not processed yet is replaced.
+* @param ssids The SSIDs.
+* @param num The number of SSIDs.
+* @return Void.
+*/
+void postStoredEpoch(const struct SightedSSID* ssids, u32_t num);
+
+/**
+* @brief Wait for the next stored epoch and process it.
+* @return Void.
+*/
+void runPrefetcher(void);
+
+/**
+* @brief Learn the transitions into the SSIDs that appeared in an epoch, and
+*        prefetch the SSIDs that are expected to appear next from the cold
+*        tier.
+* @param ssids The SSIDs.
+* @param num The number of SSIDs.
+* @return Void.
+*/
+void prefetchEpoch(const struct SightedSSID* ssids, u32_t num);
+
+/**
+* @brief Print the counters of the prefetcher.
+* @param file The file to print to.
+* @return Void.
+*/
+void printPrefetcherStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* PREFETCHER_H */
\ No newline at end of file
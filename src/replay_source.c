@@ -0,0 +1,465 @@
+/**
+  * @file replay_source.c
+  * @brief Implements a scan source that replays the scan epochs of the log
+  *        segments (e.g. of a legacy archive), so that the recorded data can
+  *        drive the tasks. The segments are streamed through a window that is
+  *        mapped and locked ahead of the replay, so that any size of archive
+  *        can be replayed in a fixed amount of memory.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "memory_regions.h"
+#include "flash_writer.h"
+
+#include "replay_source.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max size of a replayed SSID (with the trailing newline and NUL). */
+#define REPLAY_SSID_SIZE (255u + 2u)
+
+/** The size of the BSSID and the RSSI of a record (from version 2 on). */
+#define RADIO_SIZE (6u + 1u)
+
+/***************************** Type Definitions ******************************/
+
+/** A mapped segment, along with the window of it that is locked. */
+struct ReplaySegment {
+  u8_t* data;  /* NULL if it is not mapped */
+  u64_t size;
+  u64_t start;  /* the offset of the first record */
+  u32_t index;
+  u32_t version;
+  u64_t window_start, window_end;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The directory and the ids (in order) of the segments, and whether they
+  * are replayed.
+  */
+static char segment_dir[PATH_MAX];
+static u32_t* segment_ids;
+static u32_t segment_num;
+static u8_t replay_open = FALSE;
+
+/** The segment that is replayed and the offset of its next record, the next
+  * segment (mapped ahead) and the last one (to be unmapped).
+  */
+static struct ReplaySegment current, next, retired;
+static u64_t offset;
+
+/** Whether the replay task has to move on. Guards the segments, though the
+  * file I/O is done outside of it, so that the read task never waits on it.
+  */
+static u8_t service_needed;
+static pthread_mutex_t replay_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t replay_cond = PTHREAD_COND_INITIALIZER;
+
+/** The SSIDs of the replayed scan (of the read task). */
+static char scan_ssids[REPLAY_MAX_SCAN][REPLAY_SSID_SIZE];
+
+/** The counters of the replay. */
+static u64_t replayed_scans, replayed_ssids, truncated_scans, rewinds;
+static u64_t mapped_segments, invalid_segments, stalls, unlocked_reads;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Compare two segment ids.
+ * @return The order of the ids.
+ */
+static int compareIds(const void* a, const void* b);
+
+/**
+ * @brief Map a segment and check its header.
+ * @param segment The segment.
+ * @param index The index of the segment.
+ * @return TRUE if the segment is valid, FALSE otherwise.
+ */
+static u8_t mapSegment(struct ReplaySegment* segment, u32_t index);
+
+/**
+ * @brief Map the next valid segment after one (the first one after the last).
+ * @param segment The segment.
+ * @param index The index of the segment it comes after.
+ * @return TRUE if a segment was mapped, FALSE otherwise.
+ */
+static u8_t mapNextSegment(struct ReplaySegment* segment, u32_t index);
+
+/**
+ * @brief Unlock and unmap a segment.
+ * @param segment The segment.
+ * @return Void.
+ */
+static void unmapSegment(struct ReplaySegment* segment);
+
+/**
+ * @brief Move the locked window of a segment to a position. The new window
+ *        is locked before the old one is released, so that the pages both
+ *        of them have stay locked.
+ * @param segment The segment.
+ * @param position The position (the window starts at the window before it).
+ * @return Void.
+ */
+static void lockWindow(struct ReplaySegment* segment, u64_t position);
+
+/***************************** Static Functions ******************************/
+
+int compareIds(const void* a, const void* b)
+{
+  u32_t x = *(const u32_t*)a;
+  u32_t y = *(const u32_t*)b;
+
+  return (x > y) - (x < y);
+}
+
+u8_t mapSegment(struct ReplaySegment* segment, u32_t index)
+{
+  s32_t fd;
+  char path[PATH_MAX + 32];
+  struct stat info;
+  struct SegmentHeader header;
+
+  memset(segment, 0, sizeof(*segment));
+  segment->index = index;
+
+  snprintf(path, sizeof(path), "%s/ssids_%08u.seg", segment_dir, segment_ids[index]);
+
+  if ((fd = open(path, O_RDONLY)) == -1)
+    return FALSE;
+
+  if (fstat(fd, &info) == -1 || (u64_t)info.st_size < sizeof(header))
+  {
+    close(fd);
+    return FALSE;
+  }
+
+  segment->data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (segment->data == MAP_FAILED)
+  {
+    segment->data = NULL;
+    return FALSE;
+  }
+
+  segment->size = info.st_size;
+  madvise(segment->data, segment->size, MADV_SEQUENTIAL);
+
+  memcpy(&header, segment->data, sizeof(header));
+
+  if (header.magic != SEGMENT_MAGIC || header.version == 0 || header.version > SEGMENT_VERSION ||
+      header.header_size < sizeof(header) || header.header_size > segment->size)
+  {
+    munmap(segment->data, segment->size);
+    segment->data = NULL;
+    return FALSE;
+  }
+
+  segment->start = header.header_size;
+  segment->version = header.version;
+
+  return TRUE;
+}
+
+u8_t mapNextSegment(struct ReplaySegment* segment, u32_t index)
+{
+  u32_t i;
+
+  for (i = 1; i <= segment_num; i++)
+  {
+    if (mapSegment(segment, (index + i) % segment_num))
+    {
+      mapped_segments++;
+      return TRUE;
+    }
+
+    invalid_segments++;
+  }
+
+  return FALSE;
+}
+
+void unmapSegment(struct ReplaySegment* segment)
+{
+  if (segment->window_end > segment->window_start)
+    releaseMemoryRegion(segment->data + segment->window_start);
+
+  munmap(segment->data, segment->size);
+  segment->data = NULL;
+}
+
+void lockWindow(struct ReplaySegment* segment, u64_t position)
+{
+  u64_t start = position - position % REPLAY_WINDOW_SIZE;
+  u64_t end = (segment->size - start < 2 * REPLAY_WINDOW_SIZE) ? segment->size :
+              start + 2 * REPLAY_WINDOW_SIZE;
+
+  if (position >= segment->size ||
+      (start == segment->window_start && segment->window_end > segment->window_start))
+    return;
+
+  lockMemoryRegion("replay", segment->data + start, end - start);
+
+  if (segment->window_end > segment->window_start)
+    releaseMemoryRegion(segment->data + segment->window_start);
+
+  segment->window_start = start;
+  segment->window_end = end;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeReplaySource(const char* path)
+{
+  u32_t id, capacity = 64;
+  char extension[8];
+  struct dirent* entry;
+  DIR* dir;
+
+  if (realpath(path, segment_dir) == NULL || (dir = opendir(segment_dir)) == NULL)
+  {
+    perror("Could not open the replay directory");
+    exit(-12);
+  }
+
+  if ((segment_ids = malloc(capacity * sizeof(u32_t))) == NULL)
+  {
+    perror("Could not allocate the segments of the replay");
+    exit(-12);
+  }
+
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (sscanf(entry->d_name, "ssids_%08u.%7s", &id, extension) != 2 || strcmp(extension, "seg"))
+      continue;
+
+    if (segment_num == capacity)
+    {
+      capacity *= 2;
+
+      if ((segment_ids = realloc(segment_ids, capacity * sizeof(u32_t))) == NULL)
+      {
+        perror("Could not allocate the segments of the replay");
+        exit(-12);
+      }
+    }
+
+    segment_ids[segment_num++] = id;
+  }
+
+  closedir(dir);
+
+  qsort(segment_ids, segment_num, sizeof(u32_t), compareIds);
+
+  /* The first segment, and the one after it, are ready before the replay */
+  if (segment_num == 0 || !mapNextSegment(&current, segment_num - 1))
+  {
+    perror("The replay has no segments");
+    exit(-12);
+  }
+
+  offset = current.start;
+  lockWindow(&current, offset);
+
+  mapNextSegment(&next, current.index);
+  lockWindow(&next, next.start);
+
+  replay_open = TRUE;
+}
+
+u8_t isReplaySourceOpen(void)
+{
+  return replay_open;
+}
+
+u32_t nextReplayScan(const char** ssids, u32_t max)
+{
+  u8_t stalled, truncated = FALSE;
+  u32_t num = 0, length, radio;
+  u64_t position, size, window_end, records = 0;
+  f32_t timestamp, last = 0;
+  const u8_t* data;
+
+  pthread_mutex_lock(&replay_mutex);
+
+  /* The next segment takes over (with its head locked) once this one ends */
+  if (offset >= current.size && next.data != NULL && retired.data == NULL)
+  {
+    retired = current;
+    current = next;
+    next.data = NULL;
+    offset = current.start;
+
+    if (current.index <= retired.index)
+      rewinds++;
+  }
+
+  data = current.data;
+  size = current.size;
+  position = offset;
+  window_end = current.window_end;
+  radio = (current.version >= 2) ? RADIO_SIZE : 0;
+
+  pthread_mutex_unlock(&replay_mutex);
+
+  if (max > REPLAY_MAX_SCAN)
+    max = REPLAY_MAX_SCAN;
+
+  stalled = (position >= size);
+
+  while (position < size)
+  {
+    length = data[position];
+
+    /* A 0 length is padding */
+    if (length == 0)
+    {
+      position++;
+      continue;
+    }
+
+    if (position + 1 + length + radio + 2 * sizeof(f32_t) > size)
+    {
+      position = size;
+      break;
+    }
+
+    memcpy(&timestamp, &data[position + 1 + length + radio], sizeof(f32_t));
+
+    if (records > 0 && (timestamp < last || timestamp - last > REPLAY_EPOCH_GAP))
+      break;
+
+    if (num < max)
+    {
+      memcpy(scan_ssids[num], &data[position + 1], length);
+      scan_ssids[num][length] = '\n';
+      scan_ssids[num][length + 1] = '\0';
+      ssids[num] = scan_ssids[num];
+      num++;
+    }
+    else
+      truncated = TRUE;
+
+    records++;
+    last = timestamp;
+    position += 1 + length + radio + 2 * sizeof(f32_t);
+  }
+
+  pthread_mutex_lock(&replay_mutex);
+
+  offset = position;
+
+  /* The replay task moves the window once the replay is past half of it */
+  if (position >= current.window_start + REPLAY_WINDOW_SIZE || next.data == NULL ||
+      retired.data != NULL)
+  {
+    service_needed = TRUE;
+    pthread_cond_signal(&replay_cond);
+  }
+
+  if (records > 0)
+  {
+    replayed_scans++;
+    replayed_ssids += num;
+    truncated_scans += truncated;
+  }
+
+  stalls += stalled;
+  unlocked_reads += (position > window_end);
+
+  pthread_mutex_unlock(&replay_mutex);
+
+  return num;
+}
+
+void runReplaySource(void)
+{
+  u8_t mapped = FALSE, unmapped = FALSE;
+  u64_t position;
+  struct ReplaySegment segment, ahead, done;
+
+  pthread_mutex_lock(&replay_mutex);
+  while (!service_needed)
+    pthread_cond_wait(&replay_cond, &replay_mutex);
+
+  service_needed = FALSE;
+  segment = current;
+  ahead = next;
+  done = retired;
+  position = offset;
+
+  pthread_mutex_unlock(&replay_mutex);
+
+  /* The read task moves on to the next segment only when there is one and
+   * the last one is unmapped, so it may have done so only if both are set.
+   */
+  if (done.data != NULL)
+  {
+    unmapSegment(&done);
+    unmapped = TRUE;
+  }
+
+  lockWindow(&segment, position);
+
+  if (ahead.data == NULL && (mapped = mapNextSegment(&ahead, segment.index)))
+    lockWindow(&ahead, ahead.start);
+
+  pthread_mutex_lock(&replay_mutex);
+
+  if (current.data == segment.data)
+  {
+    current.window_start = segment.window_start;
+    current.window_end = segment.window_end;
+  }
+  else
+  {
+    retired.window_start = segment.window_start;
+    retired.window_end = segment.window_end;
+  }
+
+  if (unmapped)
+    retired.data = NULL;
+
+  if (mapped)
+    next = ahead;
+
+  if (retired.data != NULL)
+    service_needed = TRUE;
+
+  pthread_mutex_unlock(&replay_mutex);
+}
+
+void printReplayStats(FILE* file)
+{
+  pthread_mutex_lock(&replay_mutex);
+
+  fprintf(file, "segments    %u (%s)\n", segment_num, segment_dir);
+  fprintf(file, "mapped      %llu\n", mapped_segments);
+  fprintf(file, "invalid     %llu\n", invalid_segments);
+  fprintf(file, "window_kb   %u\n", 2 * REPLAY_WINDOW_SIZE / 1024);
+  fprintf(file, "scans       %llu\n", replayed_scans);
+  fprintf(file, "replayed    %llu\n", replayed_ssids);
+  fprintf(file, "truncated   %llu\n", truncated_scans);
+  fprintf(file, "rewinds     %llu\n", rewinds);
+  fprintf(file, "stalls      %llu\n", stalls);
+  fprintf(file, "unlocked    %llu\n", unlocked_reads);
+
+  pthread_mutex_unlock(&replay_mutex);
+}
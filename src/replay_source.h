@@ -0,0 +1,87 @@
+/**
+  * @file replay_source.h
+  * @brief Contains the declarations of functions defined in replay_source.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef REPLAY_SOURCE_H
+#define REPLAY_SOURCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max number of SSIDs of a replayed scan. */
+#define REPLAY_MAX_SCAN (256u)
+
+/** The max time (in secs) between two records of the same scan epoch. The
+  * imported records of an epoch share its timestamp, and the live ones are
+  * msecs apart, while the scans are seconds apart.
+  */
+#define REPLAY_EPOCH_GAP (0.5f)
+
+/** The window of a segment that is mapped, prefaulted and locked ahead of the
+  * replay (twice the size, from the start of the window of the replay), so
+  * that the read task never faults on the segments.
+  */
+#define REPLAY_WINDOW_SIZE (256u * 1024u)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Find the sealed log segments of a directory (e.g. a legacy archive,
+*        as imported by legacy_import), whose scan epochs are replayed in
+*        place of the scans, and map the first ones.
+* @param path The directory of the segments.
+* @return Void.
+*/
+void initializeReplaySource(const char* path);
+
+/**
+* @brief Check whether the scans are replayed.
+* @return TRUE if there is a replay source, FALSE otherwise.
+*/
+u8_t isReplaySourceOpen(void);
+
+/**
+* @brief Get the SSIDs of the next epoch of the segments, from the window
+*        that the replay task has locked. The segments are replayed from the
+*        start when they end.
+* @param ssids The SSIDs (with the trailing newline).
+* @param max The max number of SSIDs.
+* @return The number of SSIDs (0 if the next segment is not mapped yet).
+*/
+u32_t nextReplayScan(const char** ssids, u32_t max);
+
+/**
+* @brief Wait until the replay moves on, then move the locked window along
+*        with it, map the next segment and unmap the last one (i.e. the file
+*        I/O of the replay, off the read task).
+* @return Void.
+*/
+void runReplaySource(void);
+
+/**
+* @brief Print the replay's stats.
+* @param file The file to print the stats to.
+* @return Void.
+*/
+void printReplayStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* REPLAY_SOURCE_H */
@@ -1,2 +1,7 @@
 #!/bin/bash
-iw dev wlp8s0 scan | grep SSID | while read line; do echo ${line/SSID: /}; done
\ No newline at end of file
+# Usage: searchWifi.sh [freq] (scans all the channels if no frequency is given)
+# Prints a line per AP: its BSSID, its signal (dBm) and its SSID.
+iw dev wlp8s0 scan ${1:+freq $1} | awk '
+  /^BSS /        { bssid = substr($2, 1, 17) }
+  /signal:/      { signal = $2 }
+  /^[ \t]+SSID:/ { sub(/^[ \t]*SSID: ?/, ""); gsub(/\\/, ""); print bssid, signal, $0 }'
\ No newline at end of file
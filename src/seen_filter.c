@@ -0,0 +1,67 @@
+/**
+  * @file seen_filter.c
+  * @brief Implements a small filter of the recently seen SSIDs, made up of
+  *        two generations of direct-mapped SSID hashes.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <string.h>
+
+#include "memory_regions.h"
+
+#include "seen_filter.h"
+
+/***************************** Static Variables ******************************/
+
+/** The hashes of the current and the previous generation (0 is empty). A
+  * collision evicts the older hash, so an SSID may be considered novel
+  * again, but never the opposite (short of a 32-bit hash collision).
+  */
+static u32_t generations[2][SEEN_FILTER_SIZE];
+static u8_t current;
+static u32_t scans;
+
+/***************************** Public Functions ******************************/
+
+void initializeSeenFilter(void)
+{
+  memset(generations, 0, sizeof(generations));
+  lockMemoryRegion("seen filter", generations, sizeof(generations));
+  current = 0;
+  scans = 0;
+}
+
+u8_t checkSeen(u32_t hash)
+{
+  u32_t slot = hash & (SEEN_FILTER_SIZE - 1);
+
+  if (hash == 0)
+    hash = 1;
+
+  return (generations[current][slot] == hash || generations[!current][slot] == hash);
+}
+
+void markSeen(u32_t hash)
+{
+  u32_t slot = hash & (SEEN_FILTER_SIZE - 1);
+
+  if (hash == 0)
+    hash = 1;
+
+  generations[current][slot] = hash;
+}
+
+void advanceSeenFilter(void)
+{
+  if (++scans < SEEN_FILTER_SCANS)
+    return;
+
+  scans = 0;
+  current = !current;
+
+  memset(generations[current], 0, sizeof(generations[current]));
+}
@@ -0,0 +1,64 @@
+/**
+  * @file seen_filter.h
+  * @brief Contains the declarations of functions defined in seen_filter.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef SEEN_FILTER_H
+#define SEEN_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The number of SSIDs a generation of the filter holds (power of 2). */
+#define SEEN_FILTER_SIZE (1024u)
+
+/** The number of scans after which the filter moves to a new generation.
+  * An SSID is considered recently seen for one to two generations.
+  */
+#define SEEN_FILTER_SCANS (12u)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module.
+* @return Void.
+*/
+void initializeSeenFilter(void);
+
+/**
+* @brief Check whether an SSID has been seen recently.
+* @param hash The hash of the SSID.
+* @return TRUE if the SSID has been seen recently, FALSE otherwise.
+*/
+u8_t checkSeen(u32_t hash);
+
+/**
+* @brief Mark an SSID as seen (once it has been queued).
+* @param hash The hash of the SSID.
+* @return Void.
+*/
+void markSeen(u32_t hash);
+
+/**
+* @brief Count a scan, moving to a new generation every SEEN_FILTER_SCANS.
+* @return Void.
+*/
+void advanceSeenFilter(void);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* SEEN_FILTER_H */
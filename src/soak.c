@@ -0,0 +1,274 @@
+/**
+  * @file soak.c
+  * @brief Implements a soak test, that replays days of the workload through
+  *        the pipeline (the queue file, the store, the cold tier and the
+  *        prefetcher, the log and the metrics) in virtual time, and detects
+  *        memory and latency drift.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <malloc.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include "time_helpers.h"
+#include "ssid_store.h"
+#include "wifi_scanner.h"
+#include "flash_writer.h"
+#include "prefetcher.h"
+#include "metrics.h"
+#include "latency_stats.h"
+#include "workload.h"
+
+#include "soak.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The number of samples per day, and the max number of a soak. */
+#define SAMPLES_PER_DAY (86400u / SOAK_SAMPLE_PERIOD)
+#define MAX_SAMPLES     (SOAK_MAX_DAYS * SAMPLES_PER_DAY)
+
+/** The soak runs in a directory of its own (with the checkpoint of the queue,
+  * the log segments and the cold tier), with a staging and a queue file of its
+  * own.
+  */
+#define SOAK_DIR          "/var/tmp/soak_XXXXXX"
+#define SOAK_COLD_FILE    "ssid_cold.dat"
+#define SOAK_STAGING_FILE STAGING_DIR "/ssid_staging_soak.dat"
+#define SOAK_QUEUE_FILE   STAGING_DIR "/ssid_queue_soak.dat"
+
+/***************************** Type Definitions ******************************/
+
+/** A sample of the soak. */
+struct SoakSample {
+  f64_t day;
+  f64_t rss;          /* bytes */
+  f64_t heap;         /* bytes */
+  f64_t load_factor;
+  f64_t p50, p99;     /* secs */
+};
+
+/***************************** Static Variables ******************************/
+
+/** The samples of the soak. */
+static struct SoakSample samples[MAX_SAMPLES];
+
+/** The latency of the scans since the last sample. */
+static struct LatencyHistogram scan_latency;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Run a scan through the steps of the read, store and prefetch tasks,
+ *        and the flush in the quiet window after it.
+ * @param records The records of the scan.
+ * @param num The number of records.
+ * @param time The virtual time of the scan.
+ * @return Void.
+ */
+static void processScan(struct SSIDRecord* records, u32_t num, f32_t time);
+
+/**
+ * @brief Drop the files of the directory of the soak.
+ * @param sealed_only Whether only the sealed segments are dropped (as the
+ *        upload task would), or all of the files.
+ * @return Void.
+ */
+static void dropSoakFiles(u8_t sealed_only);
+
+/**
+ * @brief Sample the memory, the index and the latency.
+ * @param sample The sample.
+ * @param day The virtual day of the sample.
+ * @return Void.
+ */
+static void takeSample(struct SoakSample* sample, f64_t day);
+
+/**
+ * @brief Fit a line to a field of the samples (least squares).
+ * @param first The first sample.
+ * @param num The number of samples.
+ * @param field The offset of the field in a sample.
+ * @param mean The mean of the field.
+ * @return The slope of the line (per day).
+ */
+static f64_t fitSlope(const struct SoakSample* first, u32_t num, u32_t field, f64_t* mean);
+
+/***************************** Static Functions ******************************/
+
+void processScan(struct SSIDRecord* records, u32_t num, f32_t time)
+{
+  u64_t start_time = getMonotonicTime();
+
+  /* The whole scan is published at once, so it is stored by a single call */
+  readRecords(records, num, time);
+  storeSSIDs();
+  runPrefetcher();
+
+  pollLog(TRUE);
+
+  recordLatency(&scan_latency, (getMonotonicTime() - start_time) / (f64_t)NSEC_PER_SEC);
+}
+
+void dropSoakFiles(u8_t sealed_only)
+{
+  struct dirent* entry;
+  DIR* dir = opendir(".");
+
+  if (dir == NULL)
+    return;
+
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (entry->d_name[0] == '.')
+      continue;
+
+    if (!sealed_only || strstr(entry->d_name, ".seg") != NULL)
+      unlink(entry->d_name);
+  }
+
+  closedir(dir);
+}
+
+void takeSample(struct SoakSample* sample, f64_t day)
+{
+  unsigned long size, resident = 0;
+  struct mallinfo2 heap = mallinfo2();
+  struct StoreStats stats;
+  FILE* file = fopen("/proc/self/statm", "r");
+
+  if (file != NULL)
+  {
+    if (fscanf(file, "%lu %lu", &size, &resident) != 2)
+      resident = 0;
+
+    fclose(file);
+  }
+
+  getStoreStats(&stats);
+
+  sample->day = day;
+  sample->rss = resident * (f64_t)sysconf(_SC_PAGESIZE);
+  sample->heap = heap.uordblks + heap.hblkhd;
+  sample->load_factor = stats.load_factor;
+  sample->p50 = getLatencyPercentile(&scan_latency, 50.0);
+  sample->p99 = getLatencyPercentile(&scan_latency, 99.0);
+
+  resetLatencyHistogram(&scan_latency);
+}
+
+f64_t fitSlope(const struct SoakSample* first, u32_t num, u32_t field, f64_t* mean)
+{
+  u32_t i;
+  f64_t x, y, sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+
+  for (i = 0; i < num; i++)
+  {
+    x = first[i].day;
+    y = *(const f64_t*)((const u8_t*)&first[i] + field);
+
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+
+  *mean = sum_y / num;
+
+  return (num * sum_xy - sum_x * sum_y) / (num * sum_xx - sum_x * sum_x);
+}
+
+/***************************** Public Functions ******************************/
+
+u8_t runSoak(u32_t days, u8_t store_policy)
+{
+  u8_t passed = TRUE;
+  u32_t num, sample_num = 0, first;
+  u64_t scans, scans_per_sample = SOAK_SAMPLE_PERIOD / WORKLOAD_SCAN_PERIOD;
+  f32_t time;
+  f64_t rss_slope, heap_slope, p99_slope, rss_mean, heap_mean, p99_mean;
+  char dir[] = SOAK_DIR;
+  char cwd[256];
+  struct SSIDRecord scan[WORKLOAD_MAX_SCAN];
+  struct SoakSample* sample;
+
+  if (getcwd(cwd, sizeof(cwd)) == NULL || mkdtemp(dir) == NULL || chdir(dir) == -1)
+  {
+    perror("Could not create the soak directory");
+    return FALSE;
+  }
+
+  /* The records staged by an interrupted soak belong to its own directory */
+  unlink(SOAK_STAGING_FILE);
+  unlink(SOAK_QUEUE_FILE);
+
+  initializeWifiScanner(SCAN_MODE_FULL, store_policy, NULL, SOAK_COLD_FILE, ".",
+                        SOAK_STAGING_FILE, SOAK_QUEUE_FILE);
+  initializeWorkload(2463534242u, FALSE);
+  resetLatencyHistogram(&scan_latency);
+
+  printf("day  rss_kb   heap_kb  load_factor  p50_us   p99_us\n");
+
+  for (scans = 1; scans <= days * (u64_t)(WORKLOAD_DAY / WORKLOAD_SCAN_PERIOD); scans++)
+  {
+    num = nextWorkloadScan(scan, &time);
+    processScan(scan, num, time);
+
+    if (scans % scans_per_sample)
+      continue;
+
+    writeMetrics();
+    dropSoakFiles(TRUE);
+
+    sample = &samples[sample_num++];
+    takeSample(sample, scans * WORKLOAD_SCAN_PERIOD / WORKLOAD_DAY);
+
+    if (sample_num % SAMPLES_PER_DAY == 0)
+      printf("%-3.0f  %-7.0f  %-7.0f  %-11.3f  %-7.1f  %.1f\n", sample->day,
+             sample->rss / 1024, sample->heap / 1024, sample->load_factor,
+             sample->p50 * 1e6, sample->p99 * 1e6);
+  }
+
+  exitWifiScanner();
+
+  dropSoakFiles(FALSE);
+
+  if (chdir(cwd) == -1 || rmdir(dir) == -1)
+    perror("Could not remove the soak directory");
+
+  unlink(SOAK_STAGING_FILE);
+  unlink(SOAK_QUEUE_FILE);
+
+  /* The trends are fitted after the store and the cold tier have filled up */
+  first = SOAK_WARMUP_DAYS * SAMPLES_PER_DAY;
+
+  rss_slope = fitSlope(&samples[first], sample_num - first,
+                       offsetof(struct SoakSample, rss), &rss_mean);
+  heap_slope = fitSlope(&samples[first], sample_num - first,
+                        offsetof(struct SoakSample, heap), &heap_mean);
+  p99_slope = fitSlope(&samples[first], sample_num - first,
+                       offsetof(struct SoakSample, p99), &p99_mean);
+
+  printf("\ntrend      slope          max\n");
+  printf("rss        %-9.0f B/d  %u B/d\n", rss_slope, SOAK_MAX_RSS_SLOPE);
+  printf("heap       %-9.0f B/d  %u B/d\n", heap_slope, SOAK_MAX_HEAP_SLOPE);
+  printf("p99        %-+8.2f %%/d  %.2f %%/d\n", 100 * p99_slope / p99_mean,
+         100 * SOAK_MAX_P99_SLOPE);
+
+  if (rss_slope > SOAK_MAX_RSS_SLOPE || heap_slope > SOAK_MAX_HEAP_SLOPE ||
+      p99_slope > SOAK_MAX_P99_SLOPE * p99_mean)
+    passed = FALSE;
+
+  printf("\n%s\n", passed ? "PASS" : "FAIL");
+
+  return passed;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/**
+  * @file soak.h
+  * @brief Contains the declarations of functions defined in soak.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef SOAK_H
+#define SOAK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The min and the max number of virtual days a soak replays. A shorter soak
+  * fits too few days after the warm-up to tell a trend from the noise.
+  */
+#define SOAK_MIN_DAYS (7u)
+#define SOAK_MAX_DAYS (365u)
+
+/** The virtual time between two samples (in secs). */
+#define SOAK_SAMPLE_PERIOD (3600u)
+
+/** The virtual days the store, the histories of its SSIDs (that ssids.txt
+  * is written from after every scan) and the cold tier need to fill up, while
+  * the latency still grows with them. They are not fitted.
+  */
+#define SOAK_WARMUP_DAYS (3u)
+
+/** The max growth of the resident and the allocated memory (bytes per day),
+  * and of the p99 latency (fraction of its mean per day).
+  */
+#define SOAK_MAX_RSS_SLOPE  (64u * 1024u)
+#define SOAK_MAX_HEAP_SLOPE (16u * 1024u)
+#define SOAK_MAX_P99_SLOPE  (0.05)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Replay days of the workload through the scan and store pipeline in
+*        virtual time, sample the memory and the latency, and fit their trends.
+*        It runs in a temporary directory, that is removed at the end.
+* @param days The number of virtual days (SOAK_MIN_DAYS to SOAK_MAX_DAYS).
+* @param store_policy The eviction policy of the store.
+* @return TRUE if no trend exceeds its max slope, FALSE otherwise.
+*/
+u8_t runSoak(u32_t days, u8_t store_policy);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* SOAK_H */
\ No newline at end of file
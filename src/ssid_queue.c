@@ -0,0 +1,314 @@
+/**
+  * @file ssid_queue.c
+  * @brief Implements the SSID queue on a file-backed shared mapping, so that
+  *        the records that have not been persisted survive a crash, and its
+  *        checkpoint in the log directory, so that they survive a reboot.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "memory_regions.h"
+#include "time_helpers.h"
+
+#include "ssid_queue.h"
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the commit marker of a record.
+ * @param seq The sequence number of the record.
+ * @return The commit marker.
+ */
+static u32_t commitMarker(u64_t seq);
+
+/**
+ * @brief Drop the records after the first one that was not committed.
+ * @param lane The mapped lane of the queue file.
+ * @return Void.
+ */
+static void recoverLane(struct QueueLane* lane);
+
+/**
+ * @brief Update the full/empty flags of the queue.
+ * @param queue The queue.
+ * @return Void.
+ */
+static void updateQueueState(struct SSIDQueue* queue);
+
+/**
+ * @brief Check whether an image of the queue is of the current layout.
+ * @param image The image.
+ * @return TRUE if the image is valid, FALSE otherwise.
+ */
+static u8_t isValidImage(const struct QueueImage* image);
+
+/**
+ * @brief Restore the image of the queue from its checkpoint, or reset it if
+ *        the checkpoint is not valid.
+ * @param queue The queue.
+ * @param log_dir The directory of the log (resolved).
+ * @return Void.
+ */
+static void restoreCheckpoint(struct SSIDQueue* queue, const char* log_dir);
+
+/***************************** Static Functions ******************************/
+
+u32_t commitMarker(u64_t seq)
+{
+  return QUEUE_MAGIC ^ (u32_t)seq ^ (u32_t)(seq >> 32);
+}
+
+void recoverLane(struct QueueLane* lane)
+{
+  u64_t seq;
+  struct QueueSlot* slot;
+
+  if (lane->persisted_seq >= lane->next_seq)
+  {
+    lane->persisted_seq = 0;
+    lane->next_seq = 1;
+  }
+
+  for (seq = lane->persisted_seq + 1; seq < lane->next_seq; seq++)
+  {
+    slot = &lane->slots[seq % BUFFER_SIZE];
+
+    if (slot->seq != seq || slot->commit != commitMarker(seq))
+    {
+      lane->next_seq = seq;
+      break;
+    }
+  }
+}
+
+void updateQueueState(struct SSIDQueue* queue)
+{
+  u8_t i;
+  struct QueueLane* lane;
+
+  queue->full = TRUE;
+  queue->empty = TRUE;
+
+  for (i = 0; i < QUEUE_LANES; i++)
+  {
+    lane = &queue->image->lane[i];
+
+    queue->lane_full[i] = (lane->next_seq - lane->persisted_seq > BUFFER_SIZE);
+    queue->lane_empty[i] = (queue->read_seq[i] + 1 >= lane->next_seq);
+
+    queue->full &= queue->lane_full[i];
+    queue->empty &= queue->lane_empty[i];
+  }
+}
+
+u8_t isValidImage(const struct QueueImage* image)
+{
+  return image->magic == QUEUE_MAGIC && image->size == BUFFER_SIZE &&
+         image->lanes == QUEUE_LANES && image->slot_size == sizeof(struct QueueSlot);
+}
+
+void restoreCheckpoint(struct SSIDQueue* queue, const char* log_dir)
+{
+  if (pread(queue->checkpoint_fd, queue->image, sizeof(struct QueueImage), 0) !=
+      sizeof(struct QueueImage) || !isValidImage(queue->image))
+  {
+    memset(queue->image, 0, sizeof(struct QueueImage));
+    queue->image->magic = QUEUE_MAGIC;
+    queue->image->size = BUFFER_SIZE;
+    queue->image->lanes = QUEUE_LANES;
+    queue->image->slot_size = sizeof(struct QueueSlot);
+  }
+
+  snprintf(queue->image->log_dir, LOG_DIR_SIZE, "%s", log_dir);
+}
+
+/***************************** Public Functions ******************************/
+
+void openSSIDQueue(struct SSIDQueue* queue, const char* path, const char* log_dir)
+{
+  u8_t i;
+  s32_t fd;
+  char directory[PATH_MAX], checkpoint_path[PATH_MAX + sizeof(QUEUE_FILE)];
+
+  if (realpath(log_dir, directory) == NULL || strlen(directory) >= LOG_DIR_SIZE)
+  {
+    perror("Could not find the log directory");
+    exit(-6);
+  }
+
+  snprintf(checkpoint_path, sizeof(checkpoint_path), "%s/%s", directory, QUEUE_FILE);
+
+  if ((queue->checkpoint_fd = open(checkpoint_path, O_RDWR | O_CREAT, 0644)) == -1)
+  {
+    perror("Could not open the queue checkpoint");
+    exit(-6);
+  }
+
+  if ((queue->checkpoint = malloc(sizeof(struct QueueImage))) == NULL)
+  {
+    perror("Could not allocate the queue checkpoint");
+    exit(-5);
+  }
+
+  if ((fd = open(path, O_RDWR | O_CREAT, 0644)) == -1)
+  {
+    perror("Could not open the queue file");
+    exit(-6);
+  }
+
+  if (ftruncate(fd, sizeof(struct QueueImage)) == -1)
+  {
+    perror("Could not resize the queue file");
+    exit(-6);
+  }
+
+  queue->image = mmap(NULL, sizeof(struct QueueImage), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (queue->image == MAP_FAILED)
+  {
+    perror("Could not map the queue file");
+    exit(-6);
+  }
+
+  lockMemoryRegion("queue", queue->image, sizeof(struct QueueImage));
+
+  /* The queue file is on tmpfs, so after a reboot it is restored from the
+   * checkpoint; the file of another log directory is left to its checkpoint.
+   */
+  if (!isValidImage(queue->image) || strcmp(queue->image->log_dir, directory))
+  {
+    if (isValidImage(queue->image) && queue->image->log_dir[0])
+      fprintf(stderr, "The queue file belongs to another log directory (%s)\n",
+              queue->image->log_dir);
+
+    restoreCheckpoint(queue, directory);
+  }
+
+  queue->recovered = 0;
+  queue->old_boots = 0;
+  queue->realtime_base = getRealtimeBase();
+  queue->boot = getBootId();
+
+  for (i = 0; i < QUEUE_LANES; i++)
+  {
+    recoverLane(&queue->image->lane[i]);
+
+    /* Whatever was not persisted is popped again */
+    queue->read_seq[i] = queue->image->lane[i].persisted_seq;
+    queue->recovered += queue->image->lane[i].next_seq - 1 - queue->image->lane[i].persisted_seq;
+  }
+
+  updateQueueState(queue);
+
+  pthread_mutex_init(&queue->mutex, NULL);
+  pthread_cond_init(&queue->not_empty, NULL);
+  pthread_cond_init(&queue->not_full, NULL);
+}
+
+void closeSSIDQueue(struct SSIDQueue* queue)
+{
+  releaseMemoryRegion(queue->image);
+  munmap(queue->image, sizeof(struct QueueImage));
+
+  close(queue->checkpoint_fd);
+  free(queue->checkpoint);
+
+  pthread_mutex_destroy(&queue->mutex);
+  pthread_cond_destroy(&queue->not_empty);
+  pthread_cond_destroy(&queue->not_full);
+}
+
+void queueAdd(struct SSIDQueue* queue, u8_t lane, char* ssid, const u8_t* bssid,
+              s8_t rssi, f32_t timestamp)
+{
+  u64_t seq = queue->image->lane[lane].next_seq;
+  struct QueueSlot* slot = &queue->image->lane[lane].slots[seq % BUFFER_SIZE];
+
+  slot->seq = seq;
+  slot->realtime_base = queue->realtime_base;
+  slot->boot = queue->boot;
+  slot->timestamp = timestamp;
+  strncpy(slot->ssid, ssid, SSID_SIZE - 1);
+  slot->ssid[SSID_SIZE - 1] = '\0';
+  memcpy(slot->bssid, bssid, BSSID_SIZE);
+  slot->rssi = rssi;
+
+  /* The record must be complete before it is marked as committed */
+  __sync_synchronize();
+  slot->commit = commitMarker(seq);
+  __sync_synchronize();
+
+  queue->image->lane[lane].next_seq = seq + 1;
+
+  updateQueueState(queue);
+}
+
+u64_t queuePop(struct SSIDQueue* queue, u8_t lane, char* ssid, u8_t* bssid,
+               s8_t* rssi, f32_t* timestamp, f64_t* realtime_base)
+{
+  u64_t seq = queue->read_seq[lane] + 1;
+  struct QueueSlot* slot = &queue->image->lane[lane].slots[seq % BUFFER_SIZE];
+
+  strcpy(ssid, slot->ssid);
+  memcpy(bssid, slot->bssid, BSSID_SIZE);
+  *rssi = slot->rssi;
+  *timestamp = slot->timestamp;
+  *realtime_base = 0;
+
+  /* The boot tells a record of an earlier boot apart, since the wall-clock
+   * time of either boot may have been taken before the clock was synchronized
+   * (so the record is not moved to the time axis of this boot).
+   */
+  if (slot->boot != queue->boot)
+  {
+    *realtime_base = slot->realtime_base;
+    queue->old_boots++;
+  }
+
+  queue->read_seq[lane] = seq;
+
+  updateQueueState(queue);
+
+  return seq;
+}
+
+u32_t checkpointSSIDQueue(struct SSIDQueue* queue)
+{
+  /* A copy, so that the queue is not locked while the flash is written */
+  pthread_mutex_lock(&queue->mutex);
+  memcpy(queue->checkpoint, queue->image, sizeof(struct QueueImage));
+  pthread_mutex_unlock(&queue->mutex);
+
+  if (pwrite(queue->checkpoint_fd, queue->checkpoint, sizeof(struct QueueImage), 0) !=
+      sizeof(struct QueueImage))
+  {
+    perror("Could not write the queue checkpoint");
+    return 0;
+  }
+
+  fdatasync(queue->checkpoint_fd);
+
+  return sizeof(struct QueueImage);
+}
+
+void queueRelease(struct SSIDQueue* queue, u8_t lane, u64_t seq)
+{
+  if (seq > queue->image->lane[lane].persisted_seq)
+    queue->image->lane[lane].persisted_seq = seq;
+
+  updateQueueState(queue);
+}
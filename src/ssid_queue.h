@@ -0,0 +1,195 @@
+/**
+  * @file ssid_queue.h
+  * @brief Contains the declarations of functions defined in ssid_queue.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef SSID_QUEUE_H
+#define SSID_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <pthread.h>
+
+#include "data_types.h"
+#include "flash_writer.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max size of the SSID. */
+#define SSID_SIZE (64u)
+
+/** The size of a BSSID (the MAC address of an AP). */
+#define BSSID_SIZE (6u)
+
+/** The size of the SSID buffer. */
+#define BUFFER_SIZE (32u)
+
+/** The file that backs the queue (on tmpfs), so that it survives a crash of
+  * the process without writing to flash.
+  */
+#define QUEUE_STAGING_FILE STAGING_DIR "/ssid_queue.dat"
+
+/** The checkpoint of the queue in the log directory (on flash). It is written
+  * after every flush of the log, so that the records that were not staged at
+  * the time survive a reboot; the ones staged since are at risk along with the
+  * staging buffer.
+  */
+#define QUEUE_FILE "ssid_queue.dat"
+
+/** The magic number that identifies a valid queue file. */
+#define QUEUE_MAGIC (0x51444953u)
+
+/** The lanes of the queue: the SSIDs that have not been seen recently are
+  * put in the novel lane, which is popped first.
+  */
+#define LANE_NOVEL  (0u)
+#define LANE_REPEAT (1u)
+#define QUEUE_LANES (2u)
+
+/***************************** Type Definitions ******************************/
+
+/** A record of the queue. The commit marker is written last and is derived
+  * from the sequence number, so that a torn record is detected on recovery.
+  * The timestamp is since the boot, so the boot and its wall-clock time are
+  * kept with it, for the records that are recovered after a reboot.
+  */
+struct QueueSlot {
+  u64_t seq;
+  f64_t realtime_base;
+  u32_t boot;
+  f32_t timestamp;
+  char ssid[SSID_SIZE];
+  u8_t bssid[BSSID_SIZE];
+  s8_t rssi;  /* dBm */
+  u32_t commit;
+};
+
+/** A lane of the queue. Every record after persisted_seq and before
+  * next_seq has not reached the log yet.
+  */
+struct QueueLane {
+  u64_t next_seq;
+  u64_t persisted_seq;
+
+  struct QueueSlot slots[BUFFER_SIZE];
+};
+
+/** The layout of the queue file, and of its checkpoint. The queue file is
+  * only used by the log directory it names, since the records it recovers
+  * are logged there.
+  */
+struct QueueImage {
+  u32_t magic;
+  u32_t size;
+  u32_t lanes;
+  u32_t slot_size;
+
+  struct QueueLane lane[QUEUE_LANES];
+
+  char log_dir[LOG_DIR_SIZE];
+};
+
+/** The SSID queue for the read/store (producer/consumer) model. A record
+  * is popped by the consumer, but its slot is reused only after the record
+  * has been released (i.e. persisted). The queue is full when all of its
+  * lanes are full, and empty when all of its lanes are empty.
+  */
+struct SSIDQueue {
+  struct QueueImage* image;
+  struct QueueImage* checkpoint;
+  s32_t checkpoint_fd;
+
+  u64_t read_seq[QUEUE_LANES];
+  u64_t recovered, old_boots;
+  f64_t realtime_base;
+  u32_t boot;
+  u8_t lane_full[QUEUE_LANES], lane_empty[QUEUE_LANES];
+  u8_t full, empty;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Map the queue to its file and recover the records that were not
+*        persisted, so that they are popped again. After a reboot (or if the
+*        file is of another log directory), the queue is restored from its
+*        checkpoint in the log directory.
+* @param queue The queue to be opened.
+* @param path The file that backs the queue.
+* @param log_dir The directory of the log, that holds the checkpoint.
+* @return Void.
+*/
+void openSSIDQueue(struct SSIDQueue* queue, const char* path, const char* log_dir);
+
+/**
+* @brief Unmap the queue and close its checkpoint.
+* @param queue The queue to be closed.
+* @return Void.
+*/
+void closeSSIDQueue(struct SSIDQueue* queue);
+
+/**
+* @brief Write the queue to its checkpoint (and sync it), after the log has
+*        been flushed.
+* @param queue The queue.
+* @return The bytes written to flash.
+*/
+u32_t checkpointSSIDQueue(struct SSIDQueue* queue);
+
+/**
+* @brief Add a new SSID and timestamp to the queue.
+* @param queue The queue.
+* @param lane The lane of the queue (must not be full).
+* @param ssid The SSID to be added to the queue.
+* @param bssid The BSSID of the AP.
+* @param rssi The signal of the AP (dBm).
+* @param timestamp The timestamp that corresponds to the SSID.
+* @return Void.
+*/
+void queueAdd(struct SSIDQueue* queue, u8_t lane, char* ssid, const u8_t* bssid,
+              s8_t rssi, f32_t timestamp);
+
+/**
+* @brief Pop an SSID and timestamp from the queue. The timestamp is since the
+*        boot of the record, so a record of an earlier boot comes with the
+*        wall-clock time of its boot, as it was then.
+* @param queue The queue.
+* @param lane The lane of the queue (must not be empty).
+* @param ssid The SSID to be popped from the queue.
+* @param bssid The BSSID of the AP.
+* @param rssi The signal of the AP (dBm).
+* @param timestamp The timestamp that corresponds to the SSID.
+* @param realtime_base The wall-clock time of the boot of a record of an
+*        earlier boot, or 0 for a record of the current boot.
+* @return The sequence number of the popped record.
+*/
+u64_t queuePop(struct SSIDQueue* queue, u8_t lane, char* ssid, u8_t* bssid,
+               s8_t* rssi, f32_t* timestamp, f64_t* realtime_base);
+
+/**
+* @brief Release the records up to a sequence number, once persisted.
+* @param queue The queue.
+* @param lane The lane of the queue.
+* @param seq The sequence number of the last persisted record.
+* @return Void.
+*/
+void queueRelease(struct SSIDQueue* queue, u8_t lane, u64_t seq);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* SSID_QUEUE_H */
@@ -0,0 +1,765 @@
+/**
+  * @file ssid_store.c
+  * @brief Implements the local storage of the SSIDs and their timestamps,
+  *        bounded in size and indexed by a hash of the SSID.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include "time_helpers.h"
+#include "cold_tier.h"
+#include "memory_regions.h"
+
+#include "ssid_store.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The LRU lists an SSID can be in. With the LRU policy only the window
+  * list is used.
+  */
+#define SEGMENT_WINDOW    (0u)
+#define SEGMENT_PROBATION (1u)
+#define SEGMENT_PROTECTED (2u)
+#define NUM_SEGMENTS      (3u)
+
+/** The link of an SSID that is not linked to any other. */
+#define NO_ENTRY (U32_MAX)
+
+/** The number of rows of the frequency sketch. */
+#define SKETCH_ROWS (4u)
+
+/** The max value of a counter of the frequency sketch. */
+#define SKETCH_MAX_COUNT (15u)
+
+/***************************** Type Definitions ******************************/
+
+/** A bucket of the hash index (open addressing with linear probing). */
+struct IndexBucket {
+  u32_t hash;
+  u32_t entry;  /* index of the SSID + 1, or 0 if the bucket is empty */
+};
+
+/** A stored SSID, along with its latest timestamps. */
+struct StoreEntry {
+  char ssid[SSID_SIZE];
+  u32_t hash;
+
+  u32_t num_timestamps;
+  f32_t timestamps[STORE_HISTORY];
+  f32_t latencies[STORE_HISTORY];
+
+  u32_t prev, next;
+  u8_t segment;
+};
+
+/** An LRU list of SSIDs (the head is the most recently used). */
+struct EntryList {
+  u32_t head, tail;
+  u32_t size;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The saved ssids, and the list of the free slots. */
+static struct StoreEntry* entries;
+static u32_t capacity;
+static u64_t ssid_num;
+static u32_t free_head;
+
+/** The hash index of the saved ssids. */
+static struct IndexBucket* buckets;
+static u32_t bucket_mask;
+
+/** The eviction policy and its lists. */
+static u8_t policy;
+static struct EntryList lists[NUM_SEGMENTS];
+static u32_t window_capacity;
+static u32_t protected_capacity;
+
+/** The count-min sketch of the frequency of the SSIDs, whose 4-bit counters
+  * are packed two per byte.
+  */
+static u8_t* sketch;
+static u32_t sketch_shift;
+static u64_t sketch_additions;
+
+/** The multipliers that hash an SSID to each row of the sketch. */
+static const u32_t sketch_seeds[SKETCH_ROWS] = {
+  0x9E3779B1u, 0x85EBCA77u, 0xC2B2AE3Du, 0x27D4EB2Fu
+};
+
+/** The counters of the store. */
+static struct StoreStats stats;
+
+/** Guards the store, since it is reported from other tasks. */
+static pthread_mutex_t store_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Probe the index for the SSID a record should be appended to.
+ *        As before the index existed, a record is not appended to an SSID
+ *        whose last timestamp is the same, so such a record is stored as a
+ *        new SSID.
+ * @param record The record to be looked up.
+ * @param hash The hash of the record's SSID.
+ * @return The index of the SSID, or STORE_NOT_FOUND.
+ */
+static u32_t probeSSID(struct SSIDRecord* record, u32_t hash);
+
+/**
+ * @brief Hash a batch of records and prefetch their buckets.
+ * @param records The records of the batch.
+ * @param num The number of records.
+ * @param sort Whether the records are ordered by bucket.
+ * @param hashes The hash of each record.
+ * @param order The order in which the records are to be probed.
+ * @return Void.
+ */
+static void prepareBatch(struct SSIDRecord* records, u32_t num, u8_t sort,
+                         u32_t* hashes, u32_t* order);
+
+/**
+ * @brief Remove a saved SSID from the index (with backward shift deletion,
+ *        so that no tombstones are left).
+ * @param i The index of the SSID.
+ * @return Void.
+ */
+static void removeFromIndex(u32_t i);
+
+/**
+ * @brief Unlink a saved SSID from its list.
+ * @param i The index of the SSID.
+ * @return Void.
+ */
+static void listRemove(u32_t i);
+
+/**
+ * @brief Link a saved SSID at the head of a list.
+ * @param segment The list.
+ * @param i The index of the SSID.
+ * @return Void.
+ */
+static void listPush(u8_t segment, u32_t i);
+
+/**
+ * @brief Count an occurrence of an SSID to the frequency sketch.
+ * @param hash The hash of the SSID.
+ * @return Void.
+ */
+static void sketchIncrement(u32_t hash);
+
+/**
+ * @brief Estimate the frequency of an SSID.
+ * @param hash The hash of the SSID.
+ * @return The estimated frequency.
+ */
+static u32_t sketchEstimate(u32_t hash);
+
+/**
+ * @brief Drop a saved SSID and free its slot. The SSID is spilled to the cold
+ *        tier, if it is open.
+ * @param i The index of the SSID.
+ * @return Void.
+ */
+static void evictEntry(u32_t i);
+
+/**
+ * @brief Free a slot for a new SSID, according to the eviction policy.
+ * @return Void.
+ */
+static void makeRoom(void);
+
+/**
+ * @brief Append a timestamp to a saved SSID and update its recency.
+ * @param i The index of the SSID.
+ * @param timestamp The timestamp to be appended.
+ * @return Void.
+ */
+static void appendTimestamp(u32_t i, f32_t timestamp);
+
+/**
+ * @brief Save a new SSID along with its first timestamp.
+ * @param record The record of the SSID.
+ * @param hash The hash of the SSID.
+ * @param history The timestamps of the SSID from the cold tier, or NULL.
+ * @return Void.
+ */
+static void addSSID(struct SSIDRecord* record, u32_t hash, const struct ColdEntry* history);
+
+/***************************** Static Functions ******************************/
+
+u32_t probeSSID(struct SSIDRecord* record, u32_t hash)
+{
+  u32_t b, i;
+  struct StoreEntry* entry;
+
+  for (b = hash & bucket_mask; buckets[b].entry; b = (b + 1) & bucket_mask)
+  {
+    i = buckets[b].entry - 1;
+    entry = &entries[i];
+
+    if (buckets[b].hash == hash &&
+        !strcmp(entry->ssid, record->ssid) &&  /* equal */
+        entry->timestamps[(entry->num_timestamps - 1) % STORE_HISTORY] != record->timestamp)
+    {
+      return i;
+    }
+  }
+
+  return STORE_NOT_FOUND;
+}
+
+void prepareBatch(struct SSIDRecord* records, u32_t num, u8_t sort,
+                  u32_t* hashes, u32_t* order)
+{
+  u32_t i, shift, digit, count, sum;
+  u32_t counts[256], sorted[STORE_MAX_BATCH];
+
+  for (i = 0; i < num; i++)
+  {
+    hashes[i] = hashSSID(records[i].ssid);
+    __builtin_prefetch(&buckets[hashes[i] & bucket_mask]);
+
+    order[i] = i;
+  }
+
+  if (!sort)
+    return;
+
+  /* A radix sort on the bucket bits (a byte per pass), which is stable, so
+   * that the records of the same SSID keep their order.
+   */
+  for (shift = 0; (bucket_mask >> shift) != 0; shift += 8)
+  {
+    memset(counts, 0, sizeof(counts));
+
+    for (i = 0; i < num; i++)
+      counts[((hashes[i] & bucket_mask) >> shift) & 0xFF]++;
+
+    for (digit = 0, sum = 0; digit < 256; digit++)
+    {
+      count = counts[digit];
+      counts[digit] = sum;
+      sum += count;
+    }
+
+    for (i = 0; i < num; i++)
+      sorted[counts[((hashes[order[i]] & bucket_mask) >> shift) & 0xFF]++] = order[i];
+
+    memcpy(order, sorted, num * sizeof(u32_t));
+  }
+}
+
+void removeFromIndex(u32_t i)
+{
+  u32_t b, j, home;
+
+  for (b = entries[i].hash & bucket_mask; buckets[b].entry != i + 1; b = (b + 1) & bucket_mask);
+
+  /* Shift back every following bucket that is allowed to move to the hole */
+  for (j = (b + 1) & bucket_mask; buckets[j].entry; j = (j + 1) & bucket_mask)
+  {
+    home = buckets[j].hash & bucket_mask;
+
+    if (((j - home) & bucket_mask) >= ((j - b) & bucket_mask))
+    {
+      buckets[b] = buckets[j];
+      b = j;
+    }
+  }
+
+  buckets[b].entry = 0;
+}
+
+void listRemove(u32_t i)
+{
+  struct EntryList* list = &lists[entries[i].segment];
+
+  if (entries[i].prev != NO_ENTRY)
+    entries[entries[i].prev].next = entries[i].next;
+  else
+    list->head = entries[i].next;
+
+  if (entries[i].next != NO_ENTRY)
+    entries[entries[i].next].prev = entries[i].prev;
+  else
+    list->tail = entries[i].prev;
+
+  list->size--;
+}
+
+void listPush(u8_t segment, u32_t i)
+{
+  struct EntryList* list = &lists[segment];
+
+  entries[i].segment = segment;
+  entries[i].prev = NO_ENTRY;
+  entries[i].next = list->head;
+
+  if (list->head != NO_ENTRY)
+    entries[list->head].prev = i;
+  else
+    list->tail = i;
+
+  list->head = i;
+  list->size++;
+}
+
+void sketchIncrement(u32_t hash)
+{
+  u32_t row, c, nibble;
+
+  for (row = 0; row < SKETCH_ROWS; row++)
+  {
+    c = (row << (32 - sketch_shift)) + ((hash * sketch_seeds[row]) >> sketch_shift);
+    nibble = (c & 1) * 4;
+
+    if (((sketch[c >> 1] >> nibble) & SKETCH_MAX_COUNT) < SKETCH_MAX_COUNT)
+      sketch[c >> 1] += 1 << nibble;
+  }
+
+  /* Aging (halves both of the counters of each byte) */
+  if (++sketch_additions >= (u64_t)SKETCH_AGING_FACTOR * capacity)
+  {
+    for (c = 0; c < (SKETCH_ROWS << (32 - sketch_shift)) / 2; c++)
+      sketch[c] = (sketch[c] >> 1) & 0x77;
+
+    sketch_additions /= 2;
+  }
+}
+
+u32_t sketchEstimate(u32_t hash)
+{
+  u32_t row, c, count, min_count = SKETCH_MAX_COUNT;
+
+  for (row = 0; row < SKETCH_ROWS; row++)
+  {
+    c = (row << (32 - sketch_shift)) + ((hash * sketch_seeds[row]) >> sketch_shift);
+    count = (sketch[c >> 1] >> ((c & 1) * 4)) & SKETCH_MAX_COUNT;
+
+    if (count < min_count)
+      min_count = count;
+  }
+
+  return min_count;
+}
+
+void evictEntry(u32_t i)
+{
+  struct ColdEntry cold;
+
+  if (isColdTierOpen())
+  {
+    memset(&cold, 0, sizeof(cold));
+    strcpy(cold.ssid, entries[i].ssid);
+    cold.hash = entries[i].hash;
+    cold.num_timestamps = entries[i].num_timestamps;
+    memcpy(cold.timestamps, entries[i].timestamps, sizeof(cold.timestamps));
+    memcpy(cold.latencies, entries[i].latencies, sizeof(cold.latencies));
+
+    spillColdEntry(&cold);
+  }
+
+  removeFromIndex(i);
+  listRemove(i);
+
+  entries[i].next = free_head;
+  free_head = i;
+
+  ssid_num--;
+  stats.evictions++;
+}
+
+void makeRoom(void)
+{
+  u32_t candidate, victim;
+
+  if (policy == STORE_POLICY_LRU)
+  {
+    evictEntry(lists[SEGMENT_WINDOW].tail);
+    return;
+  }
+
+  victim = (lists[SEGMENT_PROBATION].tail != NO_ENTRY) ?
+           lists[SEGMENT_PROBATION].tail : lists[SEGMENT_PROTECTED].tail;
+
+  if (lists[SEGMENT_WINDOW].size < window_capacity && victim != NO_ENTRY)
+  {
+    evictEntry(victim);
+    return;
+  }
+
+  /* The SSID leaving the window is admitted to the main segment only if it
+   * is more frequent than the SSID it would displace.
+   */
+  candidate = lists[SEGMENT_WINDOW].tail;
+
+  if (victim != NO_ENTRY &&
+      sketchEstimate(entries[candidate].hash) > sketchEstimate(entries[victim].hash))
+  {
+    evictEntry(victim);
+    listRemove(candidate);
+    listPush(SEGMENT_PROBATION, candidate);
+    stats.admissions++;
+  }
+  else
+  {
+    evictEntry(candidate);
+    stats.rejections++;
+  }
+}
+
+void appendTimestamp(u32_t i, f32_t timestamp)
+{
+  u32_t demoted;
+  struct StoreEntry* entry = &entries[i];
+
+  entry->timestamps[entry->num_timestamps % STORE_HISTORY] = timestamp;
+  entry->latencies[entry->num_timestamps % STORE_HISTORY] = getCurrentTimestamp() - timestamp;
+  entry->num_timestamps++;
+
+  sketchIncrement(entry->hash);
+
+  listRemove(i);
+
+  if (policy == STORE_POLICY_TINYLFU && entry->segment != SEGMENT_WINDOW)
+  {
+    listPush(SEGMENT_PROTECTED, i);
+
+    if (lists[SEGMENT_PROTECTED].size > protected_capacity)
+    {
+      demoted = lists[SEGMENT_PROTECTED].tail;
+      listRemove(demoted);
+      listPush(SEGMENT_PROBATION, demoted);
+    }
+  }
+  else
+    listPush(entry->segment, i);
+}
+
+void addSSID(struct SSIDRecord* record, u32_t hash, const struct ColdEntry* history)
+{
+  u32_t b, i, moved;
+  struct StoreEntry* entry;
+
+  sketchIncrement(hash);
+
+  if (free_head == NO_ENTRY)
+    makeRoom();
+
+  i = free_head;
+  free_head = entries[i].next;
+  ssid_num++;
+
+  entry = &entries[i];
+  strcpy(entry->ssid, record->ssid);
+  entry->hash = hash;
+  entry->num_timestamps = 0;
+
+  /* A promoted SSID keeps the timestamps it had when it was evicted */
+  if (history != NULL)
+  {
+    entry->num_timestamps = history->num_timestamps;
+    memcpy(entry->timestamps, history->timestamps, sizeof(entry->timestamps));
+    memcpy(entry->latencies, history->latencies, sizeof(entry->latencies));
+  }
+
+  entry->timestamps[entry->num_timestamps % STORE_HISTORY] = record->timestamp;
+  entry->latencies[entry->num_timestamps % STORE_HISTORY] = getCurrentTimestamp() - record->timestamp;
+  entry->num_timestamps++;
+
+  listPush(SEGMENT_WINDOW, i);
+
+  /* While the store is not full, the window overflows to the main segment */
+  if (policy == STORE_POLICY_TINYLFU && lists[SEGMENT_WINDOW].size > window_capacity)
+  {
+    moved = lists[SEGMENT_WINDOW].tail;
+    listRemove(moved);
+    listPush(SEGMENT_PROBATION, moved);
+  }
+
+  /* The new SSID goes after any saved SSID with the same hash */
+  for (b = hash & bucket_mask; buckets[b].entry; b = (b + 1) & bucket_mask);
+
+  buckets[b].hash = hash;
+  buckets[b].entry = i + 1;
+}
+
+/***************************** Public Functions ******************************/
+
+u32_t hashSSID(const char* ssid)
+{
+  u32_t hash = 2166136261u;
+
+  while (*ssid)
+  {
+    hash ^= (u8_t)*ssid++;
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+void initializeSSIDStore(u32_t max_ssids, u8_t eviction_policy)
+{
+  u32_t i, buckets_num = 1, sketch_width = 64;
+
+  capacity = max_ssids;
+  policy = eviction_policy;
+  ssid_num = 0;
+
+  /* Keep the load factor of the index under 1/2 */
+  while (buckets_num < 2 * capacity)
+    buckets_num <<= 1;
+
+  bucket_mask = buckets_num - 1;
+
+  sketch_shift = 26;
+  while (sketch_width < capacity)
+  {
+    sketch_width <<= 1;
+    sketch_shift--;
+  }
+
+  if (!(entries = malloc(sizeof(struct StoreEntry) * capacity)) ||
+      !(buckets = calloc(buckets_num, sizeof(struct IndexBucket))) ||
+      !(sketch = calloc(SKETCH_ROWS * sketch_width / 2, sizeof(u8_t))))
+  {
+    perror("Memory allocation failed!");
+    exit(-5);
+  }
+
+  /* The hot tier is what the store task touches on every record */
+  lockMemoryRegion("hot tier", entries, sizeof(struct StoreEntry) * capacity);
+  lockMemoryRegion("hot index", buckets, sizeof(struct IndexBucket) * buckets_num);
+  lockMemoryRegion("hot sketch", sketch, SKETCH_ROWS * sketch_width / 2);
+
+  sketch_additions = 0;
+
+  for (i = 0; i < capacity; i++)
+    entries[i].next = (i + 1 < capacity) ? (i + 1) : NO_ENTRY;
+
+  free_head = 0;
+
+  for (i = 0; i < NUM_SEGMENTS; i++)
+  {
+    lists[i].head = NO_ENTRY;
+    lists[i].tail = NO_ENTRY;
+    lists[i].size = 0;
+  }
+
+  window_capacity = capacity * TINYLFU_WINDOW_PERCENT / 100;
+  if (window_capacity == 0)
+    window_capacity = 1;
+
+  protected_capacity = (capacity - window_capacity) * TINYLFU_PROTECTED_PERCENT / 100;
+
+  memset(&stats, 0, sizeof(stats));
+  stats.memory = sizeof(struct StoreEntry) * capacity +
+                 sizeof(struct IndexBucket) * buckets_num +
+                 SKETCH_ROWS * sketch_width / 2;
+}
+
+void exitSSIDStore(void)
+{
+  releaseMemoryRegion(entries);
+  releaseMemoryRegion(buckets);
+  releaseMemoryRegion(sketch);
+
+  free(entries);
+  free(buckets);
+  free(sketch);
+}
+
+u32_t findSSID(struct SSIDRecord* record)
+{
+  return probeSSID(record, hashSSID(record->ssid));
+}
+
+void findSSIDBatch(struct SSIDRecord* records, u32_t num, u8_t sort, u32_t* found)
+{
+  u32_t i;
+  u32_t hashes[STORE_MAX_BATCH];
+  u32_t order[STORE_MAX_BATCH];
+
+  prepareBatch(records, num, sort, hashes, order);
+
+  for (i = 0; i < num; i++)
+    found[order[i]] = probeSSID(&records[order[i]], hashes[order[i]]);
+}
+
+void storeSSID(struct SSIDRecord* record)
+{
+  storeSSIDBatch(record, 1, FALSE);
+}
+
+void storeSSIDBatch(struct SSIDRecord* records, u32_t num, u8_t sort)
+{
+  u32_t i, r, found;
+  u32_t hashes[STORE_MAX_BATCH];
+  u32_t order[STORE_MAX_BATCH];
+  u64_t start_time;
+  struct ColdEntry cold;
+
+  pthread_mutex_lock(&store_mutex);
+
+  start_time = getMonotonicTime();
+
+  prepareBatch(records, num, sort, hashes, order);
+
+  for (i = 0; i < num; i++)
+  {
+    r = order[i];
+
+    if ((found = probeSSID(&records[r], hashes[r])) != STORE_NOT_FOUND)
+    {
+      appendTimestamp(found, records[r].timestamp);
+      records[r].tier = STORE_TIER_HOT;
+      stats.hits++;
+    }
+    else
+    {
+      records[r].tier = isColdTierOpen() ?
+                        promoteColdEntry(hashes[r], records[r].ssid, &cold) : STORE_TIER_NEW;
+
+      /* Only a warm SSID comes with its timestamps; those of a cold one are
+       * read by the prefetch task, off the lock.
+       */
+      addSSID(&records[r], hashes[r], (records[r].tier == STORE_TIER_WARM) ? &cold : NULL);
+    }
+  }
+
+  stats.lookups += num;
+  stats.op_time += getMonotonicTime() - start_time;
+
+  pthread_mutex_unlock(&store_mutex);
+}
+
+u8_t restoreSSIDHistory(const struct ColdEntry* history)
+{
+  u32_t b, j, n = 0, total;
+  f32_t timestamps[2 * STORE_HISTORY];
+  f32_t latencies[2 * STORE_HISTORY];
+  struct StoreEntry* entry = NULL;
+
+  pthread_mutex_lock(&store_mutex);
+
+  for (b = history->hash & bucket_mask; buckets[b].entry; b = (b + 1) & bucket_mask)
+  {
+    if (buckets[b].hash == history->hash && !strcmp(entries[buckets[b].entry - 1].ssid, history->ssid))
+    {
+      entry = &entries[buckets[b].entry - 1];
+      break;
+    }
+  }
+
+  if (entry == NULL)
+  {
+    pthread_mutex_unlock(&store_mutex);
+    return FALSE;
+  }
+
+  /* The latest timestamps of both, the old ones first */
+  for (j = (history->num_timestamps > STORE_HISTORY) ? history->num_timestamps - STORE_HISTORY : 0;
+       j < history->num_timestamps; j++, n++)
+  {
+    timestamps[n] = history->timestamps[j % STORE_HISTORY];
+    latencies[n] = history->latencies[j % STORE_HISTORY];
+  }
+
+  for (j = (entry->num_timestamps > STORE_HISTORY) ? entry->num_timestamps - STORE_HISTORY : 0;
+       j < entry->num_timestamps; j++, n++)
+  {
+    timestamps[n] = entry->timestamps[j % STORE_HISTORY];
+    latencies[n] = entry->latencies[j % STORE_HISTORY];
+  }
+
+  total = history->num_timestamps + entry->num_timestamps;
+
+  for (j = (n > STORE_HISTORY) ? n - STORE_HISTORY : 0; j < n; j++)
+  {
+    entry->timestamps[(total - n + j) % STORE_HISTORY] = timestamps[j];
+    entry->latencies[(total - n + j) % STORE_HISTORY] = latencies[j];
+  }
+
+  entry->num_timestamps = total;
+
+  pthread_mutex_unlock(&store_mutex);
+
+  return TRUE;
+}
+
+u64_t getStoredSSIDs(void)
+{
+  return ssid_num;
+}
+
+void getStoreStats(struct StoreStats* store_stats)
+{
+  pthread_mutex_lock(&store_mutex);
+  *store_stats = stats;
+  store_stats->load_factor = ssid_num / (f64_t)(bucket_mask + 1);
+  pthread_mutex_unlock(&store_mutex);
+}
+
+void printSSIDStore(FILE* file)
+{
+  u32_t i, j, first;
+  u8_t segment;
+  struct StoreEntry* entry;
+
+  pthread_mutex_lock(&store_mutex);
+
+  fprintf(file, "SSID\n");
+  fprintf(file, "    timestamp  (latency)\n");
+  fprintf(file, "=========================\n\n");
+
+  for (segment = 0; segment < NUM_SEGMENTS; segment++)
+  {
+    for (i = lists[segment].head; i != NO_ENTRY; i = entries[i].next)
+    {
+      entry = &entries[i];
+      fprintf(file, "%s", entry->ssid);
+
+      /* Only the latest STORE_HISTORY timestamps are kept */
+      first = (entry->num_timestamps > STORE_HISTORY) ? (entry->num_timestamps - STORE_HISTORY) : 0;
+
+      for (j = first; j < entry->num_timestamps; j++)
+      {
+        fprintf(file, "    %.3f", entry->timestamps[j % STORE_HISTORY]);
+        fprintf(file, "   (%.6f)\n", entry->latencies[j % STORE_HISTORY]);
+      }
+
+      fprintf(file, "\n");
+    }
+  }
+
+  pthread_mutex_unlock(&store_mutex);
+}
+
+void printStoreStats(FILE* file)
+{
+  pthread_mutex_lock(&store_mutex);
+
+  fprintf(file, "policy      %s\n", (policy == STORE_POLICY_LRU) ? "lru" : "tinylfu");
+  fprintf(file, "capacity    %u\n", capacity);
+  fprintf(file, "stored      %llu\n", ssid_num);
+  fprintf(file, "hit_rate    %.4f\n", stats.lookups ? (f64_t)stats.hits / stats.lookups : 0);
+  fprintf(file, "admitted    %llu\n", stats.admissions);
+  fprintf(file, "rejected    %llu\n", stats.rejections);
+  fprintf(file, "evicted     %llu\n", stats.evictions);
+  fprintf(file, "memory      %llu\n", stats.memory);
+  fprintf(file, "load_factor %.3f\n", ssid_num / (f64_t)(bucket_mask + 1));
+  fprintf(file, "ns_per_op   %.1f\n", stats.lookups ? (f64_t)stats.op_time / stats.lookups : 0);
+
+  pthread_mutex_unlock(&store_mutex);
+}
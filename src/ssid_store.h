@@ -0,0 +1,189 @@
+/**
+  * @file ssid_store.h
+  * @brief Contains the declarations of functions defined in ssid_store.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef SSID_STORE_H
+#define SSID_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+#include "ssid_queue.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The default max number of SSIDs that are stored. */
+#define STORE_CAPACITY (1024u)
+
+/** The number of the latest timestamps that are kept per SSID. */
+#define STORE_HISTORY (16u)
+
+/** The max number of records that are stored in a single batch. */
+#define STORE_MAX_BATCH (256u)
+
+/** The value of a lookup that did not match any stored SSID. */
+#define STORE_NOT_FOUND (U32_MAX)
+
+/** The eviction policies: plain LRU, or W-TinyLFU (an LRU window in front
+  * of a segmented LRU, with a frequency sketch deciding whether an SSID
+  * leaving the window displaces the main segment's victim).
+  */
+#define STORE_POLICY_LRU     (0u)
+#define STORE_POLICY_TINYLFU (1u)
+
+/** The share of the capacity (in percent) given to the W-TinyLFU window
+  * and to the protected part of its main segment.
+  */
+#define TINYLFU_WINDOW_PERCENT    (10u)
+#define TINYLFU_PROTECTED_PERCENT (80u)
+
+/** The number of additions (per stored SSID) after which the counters of the
+  * frequency sketch are halved, so that old popularity fades out.
+  */
+#define SKETCH_AGING_FACTOR (10u)
+
+/** Where the SSID of a record was found when it was stored: nowhere (a new
+  * SSID), in the store, or in the cold tier (prefetched to the warm tier
+  * before it was sighted, or read on demand).
+  */
+#define STORE_TIER_NEW  (0u)
+#define STORE_TIER_HOT  (1u)
+#define STORE_TIER_WARM (2u)
+#define STORE_TIER_COLD (3u)
+
+/***************************** Type Definitions ******************************/
+
+/** A record to be stored. */
+struct SSIDRecord {
+  char ssid[SSID_SIZE];
+  f32_t timestamp;
+  u8_t bssid[BSSID_SIZE];
+  s8_t rssi;  /* dBm */
+  u8_t tier;  /* set when the record is stored */
+};
+
+/** The counters of the store. */
+struct StoreStats {
+  u64_t lookups, hits;
+  u64_t admissions, rejections, evictions;
+  u64_t op_time;  /* nsecs spent in storing */
+  u64_t memory;   /* bytes */
+  f64_t load_factor;  /* of the index */
+};
+
+/** An SSID of the cold tier (defined in cold_tier.h). */
+struct ColdEntry;
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module.
+* @param capacity The max number of SSIDs that are stored.
+* @param policy The eviction policy.
+* @return Void.
+*/
+void initializeSSIDStore(u32_t capacity, u8_t policy);
+
+/**
+* @brief Exit the module and clean up.
+* @return Void.
+*/
+void exitSSIDStore(void);
+
+/**
+* @brief Hash an SSID (FNV-1a).
+* @param ssid The SSID to be hashed.
+* @return The hash of the SSID.
+*/
+u32_t hashSSID(const char* ssid);
+
+/**
+* @brief Find the stored SSID that a record should be appended to.
+* @param record The record to be looked up.
+* @return The index of the SSID, or STORE_NOT_FOUND.
+*/
+u32_t findSSID(struct SSIDRecord* record);
+
+/**
+* @brief Find the stored SSIDs of a batch of records. All the buckets are
+*        prefetched before any of them is probed, so that the cache misses
+*        of the batch overlap.
+* @param records The records to be looked up.
+* @param num The number of records (up to STORE_MAX_BATCH).
+* @param sort Whether the probes are done in bucket order.
+* @param found The index of each record's SSID, or STORE_NOT_FOUND.
+* @return Void.
+*/
+void findSSIDBatch(struct SSIDRecord* records, u32_t num, u8_t sort, u32_t* found);
+
+/**
+* @brief Store a record, appending its timestamp to its SSID.
+* @param record The record to be stored.
+* @return Void.
+*/
+void storeSSID(struct SSIDRecord* record);
+
+/**
+* @brief Store a batch of records, with the lookups done as in findSSIDBatch.
+*        The SSIDs that are not in the store are taken from the cold tier,
+*        if it is open (if they are only in its file, their timestamps are
+*        restored later, by restoreSSIDHistory).
+* @param records The records to be stored.
+* @param num The number of records (up to STORE_MAX_BATCH).
+* @param sort Whether the probes are done in bucket order.
+* @return Void.
+*/
+void storeSSIDBatch(struct SSIDRecord* records, u32_t num, u8_t sort);
+
+/**
+* @brief Restore the timestamps an SSID had when it was evicted, read from
+*        the cold tier after it was stored again, before its new ones.
+* @param history The SSID, along with its old timestamps.
+* @return TRUE if it was restored, FALSE if the SSID is not stored anymore.
+*/
+u8_t restoreSSIDHistory(const struct ColdEntry* history);
+
+/**
+* @brief Get the number of stored SSIDs.
+* @return The number of SSIDs.
+*/
+u64_t getStoredSSIDs(void);
+
+/**
+* @brief Get the counters of the store.
+* @param stats The counters.
+* @return Void.
+*/
+void getStoreStats(struct StoreStats* stats);
+
+/**
+* @brief Print the stored SSIDs along with their timestamps and latencies.
+* @param file The file to print to.
+* @return Void.
+*/
+void printSSIDStore(FILE* file);
+
+/**
+* @brief Print the counters of the store.
+* @param file The file to print to.
+* @return Void.
+*/
+void printStoreStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* SSID_STORE_H */
@@ -0,0 +1,188 @@
+/**
+  * @file task_stacks.c
+  * @brief Implements the explicit stacks of the tasks, i.e. stacks of a
+  *        configured size that are prefaulted up front, instead of the
+  *        default (8 MB) stacks, and the measurement of their high-water
+  *        marks by stack painting.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "memory_regions.h"
+
+#include "task_stacks.h"
+
+/***************************** Type Definitions ******************************/
+
+/** The stack of a task. */
+struct TaskStack {
+  const char* name;
+  u8_t* base;  /* the lowest address, since the stacks grow down */
+  u32_t size;
+};
+
+/***************************** Static Variables ******************************/
+
+/** Whether the stacks are profiled. */
+static u8_t profiling;
+
+/** The stacks of the tasks. */
+static struct TaskStack stacks[MAX_TASK_STACKS];
+static u32_t stack_num;
+static pthread_mutex_t stacks_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the high-water mark of a stack, i.e. the bytes from its top to
+ *        the deepest byte that is not painted.
+ * @param stack The stack.
+ * @return The high-water mark (in bytes).
+ */
+static u32_t getHighWater(const struct TaskStack* stack);
+
+/**
+ * @brief Round a size up to whole pages.
+ * @param size The size.
+ * @return The rounded size.
+ */
+static u32_t roundToPages(u32_t size);
+
+/***************************** Static Functions ******************************/
+
+u32_t getHighWater(const struct TaskStack* stack)
+{
+  u32_t offset = 0;
+  const u64_t* word = (const u64_t*)stack->base;
+  u64_t painted;
+
+  memset(&painted, STACK_PAINT_BYTE, sizeof(painted));
+
+  /* The words are compared first, and the bytes of the first used word */
+  while (offset < stack->size && word[offset / sizeof(u64_t)] == painted)
+    offset += sizeof(u64_t);
+
+  while (offset < stack->size && stack->base[offset] == STACK_PAINT_BYTE)
+    offset++;
+
+  return stack->size - offset;
+}
+
+u32_t roundToPages(u32_t size)
+{
+  u32_t page = sysconf(_SC_PAGESIZE);
+
+  return (size + page - 1) / page * page;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeTaskStacks(u8_t profile)
+{
+  profiling = profile;
+}
+
+void setTaskStack(pthread_attr_t* attr, const char* name, u32_t size, u8_t locked)
+{
+  u32_t page = sysconf(_SC_PAGESIZE);
+  u8_t* mapping;
+
+  if (profiling)
+    size = PROFILE_STACK_SIZE;
+
+  size = roundToPages((size < PTHREAD_STACK_MIN) ? PTHREAD_STACK_MIN : size);
+
+  /* An overflow hits the guard page instead of the memory below */
+  mapping = mmap(NULL, size + page, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+
+  if (mapping == MAP_FAILED || mprotect(mapping, page, PROT_NONE) == -1)
+  {
+    perror("Could not allocate a task stack");
+    exit(-13);
+  }
+
+  memset(mapping + page, STACK_PAINT_BYTE, size);
+
+  if (locked)
+    lockMemoryRegion(name, mapping + page, size);
+  else
+    addMemoryRegion(name, mapping + page, size);
+
+  pthread_attr_setstack(attr, mapping + page, size);
+
+  pthread_mutex_lock(&stacks_mutex);
+
+  if (stack_num < MAX_TASK_STACKS)
+  {
+    stacks[stack_num].name = name;
+    stacks[stack_num].base = mapping + page;
+    stacks[stack_num].size = size;
+    stack_num++;
+  }
+
+  pthread_mutex_unlock(&stacks_mutex);
+}
+
+void releaseTaskStack(pthread_attr_t* attr)
+{
+  u32_t i, page = sysconf(_SC_PAGESIZE);
+  void* stack;
+  size_t size;
+
+  if (pthread_attr_getstack(attr, &stack, &size) != 0 || stack == NULL)
+    return;
+
+  pthread_mutex_lock(&stacks_mutex);
+
+  for (i = 0; i < stack_num; i++)
+  {
+    if (stacks[i].base == stack)
+    {
+      stacks[i] = stacks[--stack_num];
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&stacks_mutex);
+
+  releaseMemoryRegion(stack);
+  munmap((u8_t*)stack - page, size + page);
+}
+
+void printTaskStackStats(FILE* file)
+{
+  u32_t i, used, recommended, total = 0;
+
+  pthread_mutex_lock(&stacks_mutex);
+
+  fprintf(file, "mode       %s\n", profiling ? "profile" : "configured");
+  fprintf(file, "task       size_kb  used_kb  recommended_kb\n");
+
+  for (i = 0; i < stack_num; i++)
+  {
+    used = getHighWater(&stacks[i]);
+    total += stacks[i].size;
+
+    recommended = roundToPages(used + STACK_MARGIN);
+    if (recommended < PTHREAD_STACK_MIN)
+      recommended = roundToPages(PTHREAD_STACK_MIN);
+
+    fprintf(file, "%-10s %-8u %-8.1f %u\n", stacks[i].name, stacks[i].size / 1024,
+            used / 1024.0, recommended / 1024);
+  }
+
+  fprintf(file, "total_kb   %u\n", total / 1024);
+
+  pthread_mutex_unlock(&stacks_mutex);
+}
\ No newline at end of file
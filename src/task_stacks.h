@@ -0,0 +1,85 @@
+/**
+  * @file task_stacks.h
+  * @brief Contains the declarations of functions defined in task_stacks.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef TASK_STACKS_H
+#define TASK_STACKS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+#include <pthread.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The byte the stacks are painted with, so that the bytes a task has used
+  * (its high-water mark) can be told apart.
+  */
+#define STACK_PAINT_BYTE (0xA5u)
+
+/** The size of every stack in the profiling mode, in which the tasks are
+  * measured instead of being limited to their configured stacks.
+  */
+#define PROFILE_STACK_SIZE (2u * 1024u * 1024u)
+
+/** The margin that is added to the high-water mark of a task for its
+  * recommended stack size.
+  */
+#define STACK_MARGIN (16u * 1024u)
+
+/** The max number of task stacks. */
+#define MAX_TASK_STACKS (16u)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module.
+* @param profile Whether the stacks are profiled (PROFILE_STACK_SIZE each).
+* @return Void.
+*/
+void initializeTaskStacks(u8_t profile);
+
+/**
+* @brief Allocate the stack of a task and set it to the attributes of its
+*        thread. The stack has a guard page below it, and is painted, which
+*        also prefaults all of its pages up front.
+* @param attr The attributes of the thread.
+* @param name The name of the task.
+* @param size The size of the stack (in bytes).
+* @param locked Whether the stack is locked (for the real-time tasks).
+* @return Void.
+*/
+void setTaskStack(pthread_attr_t* attr, const char* name, u32_t size, u8_t locked);
+
+/**
+* @brief Free the stack of a task, once its thread has been joined.
+* @param attr The attributes of the thread.
+* @return Void.
+*/
+void releaseTaskStack(pthread_attr_t* attr);
+
+/**
+* @brief Print the size, the high-water mark and the recommended size of the
+*        stack of every task.
+* @param file The file to print the stats to.
+* @return Void.
+*/
+void printTaskStackStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* TASK_STACKS_H */
\ No newline at end of file
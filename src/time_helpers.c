@@ -8,10 +8,356 @@
 
 /******************************** Inclusions *********************************/
 
+#include <string.h>
+#include <setjmp.h>
+#include <signal.h>
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
 #include "time_helpers.h"
 
+/***************************** Macro Definitions *****************************/
+
+/** The file with the boot id of the kernel (a random UUID per boot). */
+#define BOOT_ID_FILE "/proc/sys/kernel/random/boot_id"
+
+/** The counter of the architecture, if it can be read from user space. The
+  * CNTVCT of 32-bit ARM needs ARMv7 (and the kernel to allow the access).
+  */
+#if defined(__x86_64__) || defined(__i386__)
+#define COUNTER_NAME "tsc"
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+#define COUNTER_NAME "cntvct"
+#endif
+
+/** The max time (in nsecs) between the two counter reads around a read of
+  * the clock, for the pair to be a calibration point.
+  */
+#define COUNTER_MAX_SAMPLE (20000u)
+
+/** The attempts to read a calibration point (if preempted). */
+#define COUNTER_SAMPLE_ATTEMPTS (5u)
+
+/***************************** Type Definitions ******************************/
+
+/** A calibration of the counter: the time at a counter value, the nsecs per
+  * tick (in fixed point), and the counter value it expires at.
+  */
+struct Calibration {
+  u64_t base_ticks;
+  u64_t base_time;
+  u32_t mult;
+  u32_t shift;
+  u64_t next_ticks;
+};
+
+/***************************** Static Variables ******************************/
+
+/** Whether the counter is used, and its calibrations. A new calibration is
+  * written to the slot that is not in use, and then published. The sequence
+  * is odd while a calibration is written, so that a reader that raced with
+  * it (e.g. its u64 fields were torn, on a 32-bit CPU) reads it again.
+  */
+static u8_t counter_enabled = FALSE;
+static struct Calibration calibrations[2];
+static u32_t current_calibration;
+static u32_t calibration_seq;
+static pthread_mutex_t calibration_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** The first calibration point, that the rate of the counter is measured
+  * from, and the rate.
+  */
+static u64_t anchor_ticks, anchor_time;
+static f64_t counter_rate;
+
+/** The counters of the calibration, and the reason of a fallback. */
+static u64_t calibration_num;
+static u64_t max_error;
+static const char* fallback_reason = "not initialized";
+
+#if defined(__arm__) && defined(COUNTER_NAME)
+/** The context the probe of the counter returns to, if it faults. */
+static sigjmp_buf probe_context;
+#endif
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Read the counter.
+ * @return The counter value (in ticks).
+ */
+static u64_t readCounter(void);
+
+/**
+ * @brief Check that the counter can be read, and that its rate is constant.
+ * @return TRUE if the counter can be used, FALSE otherwise.
+ */
+static u8_t probeCounter(void);
+
+/**
+ * @brief Read the counter and the clock at the same time.
+ * @param ticks The counter value.
+ * @param time The time of the clock (in nsecs).
+ * @return TRUE if the reads were close enough, FALSE otherwise.
+ */
+static u8_t sampleCounter(u64_t* ticks, u64_t* time);
+
+/**
+ * @brief Convert a counter value to time.
+ * @param calibration The calibration.
+ * @param ticks The counter value.
+ * @return The time (in nsecs).
+ */
+static u64_t counterToTime(const struct Calibration* calibration, u64_t ticks);
+
+/**
+ * @brief Read the current calibration consistently (a seqlock read).
+ * @param calibration The calibration.
+ * @return Void.
+ */
+static void readCalibration(struct Calibration* calibration);
+
+/**
+ * @brief Publish a new calibration.
+ * @param ticks The counter value of the calibration point.
+ * @param time The time of the calibration point.
+ * @return Void.
+ */
+static void publishCalibration(u64_t ticks, u64_t time);
+
+/**
+ * @brief Calibrate the counter again against the clock, or fall back to the
+ *        clock if the counter has drifted from it.
+ * @return Void.
+ */
+static void recalibrateCounter(void);
+
+#if defined(__arm__) && defined(COUNTER_NAME)
+/**
+ * @brief Return to the probe of the counter, when its read faults.
+ * @param signal The signal.
+ * @return Void.
+ */
+static void handleProbeFault(int signal);
+#endif
+
+/***************************** Static Functions ******************************/
+
+#if defined(__arm__) && defined(COUNTER_NAME)
+void handleProbeFault(int signal)
+{
+  siglongjmp(probe_context, 1);
+}
+#endif
+
+u64_t readCounter(void)
+{
+  u64_t ticks = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+  ticks = __rdtsc();
+#elif defined(__aarch64__)
+  __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(ticks) :: "memory");
+#elif defined(COUNTER_NAME)
+  __asm__ __volatile__("isb; mrrc p15, 1, %Q0, %R0, c14" : "=r"(ticks) :: "memory");
+#endif
+
+  return ticks;
+}
+
+u8_t probeCounter(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  u32_t eax, ebx, ecx, edx;
+
+  /* Only an invariant TSC ticks at a constant rate in every power state */
+  if (!__get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8)))
+  {
+    fallback_reason = "no invariant tsc";
+    return FALSE;
+  }
+
+  return TRUE;
+#elif defined(__aarch64__)
+  return TRUE;
+#elif defined(COUNTER_NAME)
+  u8_t readable = FALSE;
+  struct sigaction action, previous;
+
+  /* The kernel may not allow the access, in which case the read faults */
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = handleProbeFault;
+  sigaction(SIGILL, &action, &previous);
+
+  if (sigsetjmp(probe_context, 1) == 0)
+  {
+    (void)readCounter();
+    readable = TRUE;
+  }
+
+  sigaction(SIGILL, &previous, NULL);
+
+  if (!readable)
+    fallback_reason = "cntvct not accessible";
+
+  return readable;
+#else
+  fallback_reason = "no counter";
+  return FALSE;
+#endif
+}
+
+u8_t sampleCounter(u64_t* ticks, u64_t* time)
+{
+  u32_t i;
+  u64_t before, after;
+
+  for (i = 0; i < COUNTER_SAMPLE_ATTEMPTS; i++)
+  {
+    before = readCounter();
+    *time = getClockTime();
+    after = readCounter();
+
+    *ticks = before + (after - before) / 2;
+
+    /* Before the rate is known, the counter is taken to be up to 10 GHz */
+    if (after >= before &&
+        (after - before) <= (counter_rate ? COUNTER_MAX_SAMPLE * counter_rate / 1e9
+                                          : COUNTER_MAX_SAMPLE * 10.0))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+u64_t counterToTime(const struct Calibration* calibration, u64_t ticks)
+{
+  u64_t delta = ticks - calibration->base_ticks;
+
+  /* A counter read just before the calibration point (e.g. on a CPU whose
+   * counter is slightly behind) is at the calibration point.
+   */
+  if (ticks < calibration->base_ticks)
+    delta = 0;
+
+  /* The product is split, so that it does not overflow 64 bits */
+  return calibration->base_time +
+         (((delta >> 32) * calibration->mult) << (32 - calibration->shift)) +
+         (((delta & 0xFFFFFFFFull) * calibration->mult) >> calibration->shift);
+}
+
+void readCalibration(struct Calibration* calibration)
+{
+  u32_t seq;
+
+  do
+  {
+    seq = __atomic_load_n(&calibration_seq, __ATOMIC_ACQUIRE);
+    *calibration = calibrations[__atomic_load_n(&current_calibration, __ATOMIC_ACQUIRE)];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  } while ((seq & 1) || __atomic_load_n(&calibration_seq, __ATOMIC_RELAXED) != seq);
+}
+
+void publishCalibration(u64_t ticks, u64_t time)
+{
+  u32_t next = !current_calibration;
+  f64_t nsecs_per_tick = 1e9 / counter_rate;
+  struct Calibration* calibration = &calibrations[next];
+
+  __atomic_store_n(&calibration_seq, calibration_seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  /* The most precise fixed point that fits 32 bits */
+  calibration->shift = 32;
+  while (calibration->shift > 0 && nsecs_per_tick * (1ull << calibration->shift) >= 4294967296.0)
+    calibration->shift--;
+
+  calibration->mult = (u32_t)(nsecs_per_tick * (1ull << calibration->shift) + 0.5);
+  calibration->base_ticks = ticks;
+  calibration->base_time = time;
+  calibration->next_ticks = ticks + (u64_t)(COUNTER_CALIBRATION_PERIOD / 1e3 * counter_rate);
+
+  __atomic_store_n(&current_calibration, next, __ATOMIC_RELEASE);
+  __atomic_store_n(&calibration_seq, calibration_seq + 1, __ATOMIC_RELEASE);
+}
+
+void recalibrateCounter(void)
+{
+  u64_t ticks, time, predicted, error, allowed;
+  const struct Calibration* last;
+
+  /* Another task is already calibrating */
+  if (pthread_mutex_trylock(&calibration_mutex) != 0)
+    return;
+
+  if (__atomic_load_n(&counter_enabled, __ATOMIC_ACQUIRE) && sampleCounter(&ticks, &time))
+  {
+    last = &calibrations[current_calibration];
+    predicted = counterToTime(last, ticks);
+    error = (predicted > time) ? predicted - time : time - predicted;
+
+    allowed = COUNTER_MAX_ERROR * 1000ull;
+    if (time > last->base_time)
+      allowed += (time - last->base_time) / 1000000ull * COUNTER_MAX_DRIFT;
+
+    if (ticks < last->base_ticks || error > allowed)
+    {
+      fallback_reason = (ticks < last->base_ticks) ? "counter went backwards" : "counter drifted";
+      __atomic_store_n(&counter_enabled, FALSE, __ATOMIC_RELEASE);
+    }
+    else
+    {
+      if (error > max_error)
+        max_error = error;
+
+      /* The rate is refined over the whole run, and the time never goes back */
+      counter_rate = (ticks - anchor_ticks) / ((time - anchor_time) / 1e9);
+      publishCalibration(ticks, (predicted > time) ? predicted : time);
+      calibration_num++;
+    }
+  }
+
+  pthread_mutex_unlock(&calibration_mutex);
+}
+
 /***************************** Public Functions ******************************/
 
+void initializeTimeSource(void)
+{
+  u64_t ticks, time;
+  struct timespec settle;
+
+  if (!probeCounter())
+    return;
+
+  if (!sampleCounter(&anchor_ticks, &anchor_time))
+  {
+    fallback_reason = "counter not monotonic";
+    return;
+  }
+
+  settle.tv_sec = 0;
+  settle.tv_nsec = COUNTER_SETTLE_TIME * 1000000ul;
+  nanosleep(&settle, NULL);
+
+  if (!sampleCounter(&ticks, &time) || ticks <= anchor_ticks || time <= anchor_time)
+  {
+    fallback_reason = "counter not monotonic";
+    return;
+  }
+
+  counter_rate = (ticks - anchor_ticks) / ((time - anchor_time) / 1e9);
+  publishCalibration(ticks, time);
+
+  fallback_reason = NULL;
+  __atomic_store_n(&counter_enabled, TRUE, __ATOMIC_RELEASE);
+}
+
 void updateInterval(struct timespec* task_timer, u64_t interval)
 {
   task_timer->tv_nsec += interval;
@@ -25,10 +371,94 @@ void updateInterval(struct timespec* task_timer, u64_t interval)
 }
 
 f32_t getCurrentTimestamp(void)
+{
+  u64_t current_time = getMonotonicTime();
+
+  return (current_time / NSEC_PER_SEC) + ((current_time % NSEC_PER_SEC) / (f32_t)1000000000u);
+}
+
+u64_t getMonotonicTime(void)
+{
+  u64_t ticks;
+  struct Calibration calibration;
+
+  if (!__atomic_load_n(&counter_enabled, __ATOMIC_ACQUIRE))
+    return getClockTime();
+
+  readCalibration(&calibration);
+  ticks = readCounter();
+
+  if (ticks >= calibration.next_ticks)
+  {
+    recalibrateCounter();
+
+    if (!__atomic_load_n(&counter_enabled, __ATOMIC_ACQUIRE))
+      return getClockTime();
+
+    readCalibration(&calibration);
+    ticks = readCounter();
+  }
+
+  return counterToTime(&calibration, ticks);
+}
+
+u64_t getClockTime(void)
 {
   struct timespec current_t;
 
   clock_gettime(CLOCK_MONOTONIC, &current_t);
 
-  return current_t.tv_sec + (current_t.tv_nsec / (f32_t)1000000000u);
+  return (u64_t)current_t.tv_sec * NSEC_PER_SEC + current_t.tv_nsec;
+}
+
+f64_t getRealtimeBase(void)
+{
+  struct timespec realtime_t, monotonic_t;
+
+  clock_gettime(CLOCK_REALTIME, &realtime_t);
+  clock_gettime(CLOCK_MONOTONIC, &monotonic_t);
+
+  return (realtime_t.tv_sec - monotonic_t.tv_sec) +
+         (realtime_t.tv_nsec - monotonic_t.tv_nsec) / (f64_t)NSEC_PER_SEC;
+}
+
+u32_t getBootId(void)
+{
+  s32_t c;
+  u32_t hash = 2166136261u;
+  FILE* file = fopen(BOOT_ID_FILE, "r");
+
+  if (file == NULL)
+    return 0;
+
+  while ((c = fgetc(file)) != EOF && c != '\n')
+  {
+    hash ^= (u8_t)c;
+    hash *= 16777619u;
+  }
+
+  fclose(file);
+
+  return hash;
+}
+
+void printTimeSourceStats(FILE* file)
+{
+  u8_t enabled;
+
+  pthread_mutex_lock(&calibration_mutex);
+
+  enabled = __atomic_load_n(&counter_enabled, __ATOMIC_ACQUIRE);
+
+#ifdef COUNTER_NAME
+  fprintf(file, "source        %s\n", enabled ? COUNTER_NAME : "clock_gettime");
+#else
+  fprintf(file, "source        clock_gettime\n");
+#endif
+  fprintf(file, "fallback      %s\n", enabled ? "none" : fallback_reason);
+  fprintf(file, "rate_mhz      %.3f\n", counter_rate / 1e6);
+  fprintf(file, "calibrations  %llu\n", calibration_num);
+  fprintf(file, "max_error_us  %.1f\n", max_error / 1e3);
+
+  pthread_mutex_unlock(&calibration_mutex);
 }
\ No newline at end of file
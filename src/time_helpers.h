@@ -15,6 +15,7 @@ extern "C" {
 
 /******************************** Inclusions *********************************/
 
+#include <stdio.h>
 #include <time.h>
 
 #include "data_types.h"
@@ -24,6 +25,20 @@ extern "C" {
 /** The number of nsecs per sec. */
 #define NSEC_PER_SEC (1000000000ul)
 
+/** The time (in msecs) the counter is first calibrated over, and the period
+  * it is calibrated again against the monotonic clock.
+  */
+#define COUNTER_SETTLE_TIME        (100u)
+#define COUNTER_CALIBRATION_PERIOD (1000u)
+
+/** The max error of the counter against the monotonic clock at a calibration:
+  * an offset (in usecs) and a drift (in ppm of the time since the previous
+  * calibration). A larger error means that the counter is not reliable (e.g.
+  * it stops or changes rate), so the clock is used instead.
+  */
+#define COUNTER_MAX_ERROR (50u)
+#define COUNTER_MAX_DRIFT (100u)
+
 /***************************** Public Functions ******************************/
 
 /**
@@ -34,12 +49,56 @@ extern "C" {
  */
 void updateInterval(struct timespec* task_timer, u64_t interval);
 
+/**
+ * @brief Initialize the timestamp source: the architectural counter (TSC on
+ *        x86, CNTVCT on ARM), calibrated against the monotonic clock, if it
+ *        is available and reliable, or the monotonic clock otherwise.
+ * @return Void.
+ */
+void initializeTimeSource(void);
+
 /**
  * @brief Get the current time.
  * @return The current time.
  */
 f32_t getCurrentTimestamp(void);
 
+/**
+ * @brief Get the current time of the monotonic clock, from the timestamp
+ *        source.
+ * @return The current time in nsecs.
+ */
+u64_t getMonotonicTime(void);
+
+/**
+ * @brief Get the current time of the monotonic clock, from the clock itself
+ *        (i.e. with clock_gettime).
+ * @return The current time in nsecs.
+ */
+u64_t getClockTime(void);
+
+/**
+ * @brief Get the offset of the realtime clock from the monotonic clock, i.e.
+ *        the wall-clock time of the boot, that the timestamps are added to.
+ * @return The offset (in secs).
+ */
+f64_t getRealtimeBase(void);
+
+/**
+ * @brief Get an id of the boot (a hash of the boot id of the kernel), that
+ *        tells the records of an earlier boot apart even if the wall-clock
+ *        time is not to be trusted (e.g. before the clock is synchronized).
+ * @return The id of the boot (0 if it cannot be read).
+ */
+u32_t getBootId(void);
+
+/**
+ * @brief Print the timestamp source and its calibration.
+ * @param file The file to print the stats to.
+ * @return Void.
+ */
+void printTimeSourceStats(FILE* file);
+
 /*****************************************************************************/
 
 #ifdef __cplusplus
@@ -0,0 +1,369 @@
+/**
+  * @file uploader.c
+  * @brief Implements an uploader, that streams the sealed log segments to a
+  *        collector with sendfile, resuming where the collector left off.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "time_helpers.h"
+#include "flash_writer.h"
+
+#include "uploader.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max size of the path of a segment. */
+#define PATH_SIZE (256u)
+
+/***************************** Static Variables ******************************/
+
+/** The address of the collector, and the directory of the segments. */
+static char collector_host[128];
+static char collector_port[8];
+static char segment_dir[LOG_DIR_SIZE];
+
+/** The bytes that may be sent right away (a token bucket). */
+static f64_t tokens;
+static u64_t tokens_time;
+
+/** The counters of the uploader. */
+static u64_t connections, disconnections, timeouts;
+static u64_t segments_sent, bytes_sent;
+static u64_t throttled_time;
+static u32_t resume_segment;
+static u64_t resume_offset;
+
+/** Guards the counters, since they are reported from other tasks. */
+static pthread_mutex_t uploader_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Connect to the collector.
+ * @return The socket, or -1 if the collector cannot be reached.
+ */
+static s32_t connectCollector(void);
+
+/**
+ * @brief Count a disconnection, and whether it was a timeout.
+ * @return Void.
+ */
+static void countDisconnection(void);
+
+/**
+ * @brief Find the first sealed segment from an id on.
+ * @param min_id The id to start from.
+ * @param id The id of the segment.
+ * @return TRUE if there is such a segment, FALSE otherwise.
+ */
+static u8_t findSealedSegment(u32_t min_id, u32_t* id);
+
+/**
+ * @brief Wait until the rate allows some bytes to be sent.
+ * @param bytes The number of bytes.
+ * @return Void.
+ */
+static void waitForTokens(u32_t bytes);
+
+/**
+ * @brief Send the rest of a segment, from an offset on.
+ * @param sock The socket.
+ * @param id The id of the segment.
+ * @param offset The offset to start from.
+ * @return TRUE if the segment was sent, FALSE on a disconnection.
+ */
+static u8_t sendSegment(s32_t sock, u32_t id, u64_t offset);
+
+/***************************** Static Functions ******************************/
+
+s32_t connectCollector(void)
+{
+  s32_t sock = -1;
+  struct timeval timeout = { UPLOAD_TIMEOUT, 0 };
+  struct addrinfo hints, *addresses, *address;
+
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  if (getaddrinfo(collector_host, collector_port, &hints, &addresses) != 0)
+    return -1;
+
+  for (address = addresses; address != NULL; address = address->ai_next)
+  {
+    if ((sock = socket(address->ai_family, address->ai_socktype, address->ai_protocol)) == -1)
+      continue;
+
+    /* A call that times out fails with EAGAIN (EINPROGRESS for the connect),
+     * and is handled as a disconnection.
+     */
+    if (setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0 &&
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+        connect(sock, address->ai_addr, address->ai_addrlen) == 0)
+      break;
+
+    if (errno == EINPROGRESS)
+    {
+      pthread_mutex_lock(&uploader_mutex);
+      timeouts++;
+      pthread_mutex_unlock(&uploader_mutex);
+    }
+
+    close(sock);
+    sock = -1;
+  }
+
+  freeaddrinfo(addresses);
+
+  return sock;
+}
+
+void countDisconnection(void)
+{
+  u8_t timeout = (errno == EAGAIN || errno == EWOULDBLOCK);
+
+  pthread_mutex_lock(&uploader_mutex);
+
+  disconnections++;
+  if (timeout)
+    timeouts++;
+
+  pthread_mutex_unlock(&uploader_mutex);
+}
+
+u8_t findSealedSegment(u32_t min_id, u32_t* id)
+{
+  u8_t found = FALSE;
+  u32_t segment;
+  char extension[8];
+  struct dirent* entry;
+  DIR* dir = opendir(segment_dir);
+
+  if (dir == NULL)
+    return FALSE;
+
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (sscanf(entry->d_name, "ssids_%08u.%7s", &segment, extension) != 2 ||
+        strcmp(extension, "seg") || segment < min_id)
+      continue;
+
+    if (!found || segment < *id)
+      *id = segment;
+
+    found = TRUE;
+  }
+
+  closedir(dir);
+
+  return found;
+}
+
+void waitForTokens(u32_t bytes)
+{
+  u64_t now = getMonotonicTime();
+  struct timespec wait_time;
+
+  tokens += (now - tokens_time) * (f64_t)UPLOAD_RATE / NSEC_PER_SEC;
+  tokens_time = now;
+
+  /* A burst is a single chunk at most */
+  if (tokens > UPLOAD_CHUNK)
+    tokens = UPLOAD_CHUNK;
+
+  if (tokens < bytes)
+  {
+    wait_time.tv_sec = 0;
+    wait_time.tv_nsec = (bytes - tokens) * NSEC_PER_SEC / UPLOAD_RATE;
+    (void)nanosleep(&wait_time, NULL);
+
+    pthread_mutex_lock(&uploader_mutex);
+    throttled_time += wait_time.tv_nsec;
+    pthread_mutex_unlock(&uploader_mutex);
+
+    tokens = bytes;
+    tokens_time = getMonotonicTime();
+  }
+
+  tokens -= bytes;
+}
+
+u8_t sendSegment(s32_t sock, u32_t id, u64_t offset)
+{
+  s32_t fd;
+  ssize_t sent;
+  off_t position = offset;
+  char path[PATH_SIZE];
+  struct stat segment_stat;
+  struct UploadHeader header;
+
+  snprintf(path, PATH_SIZE, "%s/ssids_%08u.seg", segment_dir, id);
+
+  if ((fd = open(path, O_RDONLY)) == -1)
+    return TRUE;
+
+  fstat(fd, &segment_stat);
+
+  /* The collector has the whole segment already */
+  if (offset >= (u64_t)segment_stat.st_size)
+  {
+    close(fd);
+    return TRUE;
+  }
+
+  header.magic = UPLOAD_MAGIC;
+  header.segment_id = id;
+  header.offset = offset;
+  header.size = segment_stat.st_size;
+
+  errno = 0;
+
+  if (send(sock, &header, sizeof(header), MSG_NOSIGNAL) != sizeof(header))
+  {
+    close(fd);
+    return FALSE;
+  }
+
+  /* The bytes go from the page cache to the socket, without a copy to
+   * userspace.
+   */
+  while ((u64_t)position < header.size)
+  {
+    waitForTokens(UPLOAD_CHUNK);
+
+    if ((sent = sendfile(sock, fd, &position, UPLOAD_CHUNK)) <= 0)
+    {
+      close(fd);
+      return FALSE;
+    }
+
+    pthread_mutex_lock(&uploader_mutex);
+    bytes_sent += sent;
+    resume_segment = id;
+    resume_offset = position;
+    pthread_mutex_unlock(&uploader_mutex);
+  }
+
+  close(fd);
+
+  pthread_mutex_lock(&uploader_mutex);
+  segments_sent++;
+  pthread_mutex_unlock(&uploader_mutex);
+
+  return TRUE;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeUploader(const char* collector, const char* log_dir)
+{
+  const char* separator = strrchr(collector, ':');
+
+  if (separator == NULL || separator == collector ||
+      separator - collector >= (s32_t)sizeof(collector_host) ||
+      strlen(separator + 1) >= sizeof(collector_port))
+  {
+    perror("Wrong address of the collector");
+    exit(-4);
+  }
+
+  memcpy(collector_host, collector, separator - collector);
+  collector_host[separator - collector] = '\0';
+  strcpy(collector_port, separator + 1);
+
+  snprintf(segment_dir, LOG_DIR_SIZE, "%s", log_dir);
+
+  /* A disconnection is reported by the calls, not by a signal */
+  signal(SIGPIPE, SIG_IGN);
+
+  tokens = UPLOAD_CHUNK;
+  tokens_time = getMonotonicTime();
+}
+
+void uploadSegments(void)
+{
+  s32_t sock;
+  u32_t id, found;
+  u64_t offset;
+  struct UploadResume resume;
+
+  if ((sock = connectCollector()) != -1)
+  {
+    pthread_mutex_lock(&uploader_mutex);
+    connections++;
+    pthread_mutex_unlock(&uploader_mutex);
+
+    /* A closed connection does not set errno */
+    errno = 0;
+
+    if (recv(sock, &resume, sizeof(resume), MSG_WAITALL) != sizeof(resume))
+      countDisconnection();
+    else if (resume.magic == UPLOAD_MAGIC)
+    {
+      pthread_mutex_lock(&uploader_mutex);
+      resume_segment = resume.segment_id;
+      resume_offset = resume.offset;
+      pthread_mutex_unlock(&uploader_mutex);
+
+      id = resume.segment_id;
+      offset = resume.offset;
+
+      while (findSealedSegment(id, &found))
+      {
+        /* The segment the collector needs may have been removed */
+        if (found != id)
+          offset = 0;
+
+        if (!sendSegment(sock, found, offset))
+        {
+          countDisconnection();
+          break;
+        }
+
+        id = found + 1;
+        offset = 0;
+      }
+    }
+
+    close(sock);
+  }
+
+  sleep(UPLOAD_RETRY_PERIOD);
+}
+
+void printUploaderStats(FILE* file)
+{
+  pthread_mutex_lock(&uploader_mutex);
+
+  fprintf(file, "collector       %s:%s\n", collector_host, collector_port);
+  fprintf(file, "connections     %llu\n", connections);
+  fprintf(file, "disconnections  %llu\n", disconnections);
+  fprintf(file, "timeouts        %llu\n", timeouts);
+  fprintf(file, "segments_sent   %llu\n", segments_sent);
+  fprintf(file, "bytes_sent      %llu\n", bytes_sent);
+  fprintf(file, "throttled_secs  %.1f\n", throttled_time / (f64_t)NSEC_PER_SEC);
+  fprintf(file, "position        %u:%llu\n", resume_segment, resume_offset);
+
+  pthread_mutex_unlock(&uploader_mutex);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/**
+  * @file uploader.h
+  * @brief Contains the declarations of functions defined in uploader.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef UPLOADER_H
+#define UPLOADER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The magic number of the messages of the upload protocol. */
+#define UPLOAD_MAGIC (0x55504C44u)
+
+/** The max rate of the upload (bytes per sec), and the size of a chunk,
+  * i.e. the bytes that are sent at once.
+  */
+#define UPLOAD_RATE  (64u * 1024u)
+#define UPLOAD_CHUNK (16u * 1024u)
+
+/** The time (in secs) to wait before reconnecting, or before looking for
+  * new sealed segments.
+  */
+#define UPLOAD_RETRY_PERIOD (10u)
+
+/** The max time (in secs) a connect, send or receive may block, so that a
+  * collector that stops responding is treated as a disconnection. It leaves
+  * room for a chunk to be sent at the rate.
+  */
+#define UPLOAD_TIMEOUT (30u)
+
+/***************************** Type Definitions ******************************/
+
+/** The message the collector sends on connection: the segment and offset it
+  * needs next (it has all the bytes before them).
+  */
+struct UploadResume {
+  u32_t magic;
+  u32_t segment_id;
+  u64_t offset;
+};
+
+/** The message that precedes the bytes [offset, size) of a segment. */
+struct UploadHeader {
+  u32_t magic;
+  u32_t segment_id;
+  u64_t offset;
+  u64_t size;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the module.
+* @param collector The address of the collector (host:port).
+* @param log_dir The directory of the log segments.
+* @return Void.
+*/
+void initializeUploader(const char* collector, const char* log_dir);
+
+/**
+* @brief Connect to the collector and upload the sealed segments it does not
+*        have yet. Returns on a disconnection, or when there is nothing left.
+* @return Void.
+*/
+void uploadSegments(void);
+
+/**
+* @brief Print the counters of the uploader.
+* @param file The file to print to.
+* @return Void.
+*/
+void printUploaderStats(FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* UPLOADER_H */
\ No newline at end of file
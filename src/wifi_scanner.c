@@ -14,38 +14,112 @@
 #include <string.h>
 
 #include "time_helpers.h"
+#include "cyclic_executive.h"
+#include "metrics.h"
+#include "channel_stats.h"
+#include "ssid_store.h"
+#include "flash_writer.h"
+#include "seen_filter.h"
+#include "latency_stats.h"
+#include "localizer.h"
+#include "cold_tier.h"
+#include "prefetcher.h"
+#include "replay_source.h"
 
 #include "wifi_scanner.h"
 
 /***************************** Static Variables ******************************/
 
-/** The saved ssids and their timestamp. */
-static u64_t ssid_num = 0;
-static char** ssids;
-static u32_t* num_timestamps;
-static f32_t** timestamps;
-static f32_t** latencies;
-
 /** The queue to be used by the two tasks. */
 static struct SSIDQueue ssid_queue;
 
+/** The mode used to scan the channels. */
+static u8_t scan_mode;
+
+/** The APs observed by the current scan epoch, for the localizer. */
+static u8_t localize;
+static struct Observation epoch_observations[LOCALIZER_MAX_OBSERVATIONS];
+static u32_t epoch_num;
+
+/** Whether the evicted SSIDs are spilled to the cold tier, and prefetched
+  * back along the route.
+  */
+static u8_t prefetch;
+
+/** The latency of the records of each lane, until they are stored. */
+static struct LatencyHistogram lane_latencies[QUEUE_LANES];
+
+/** The batches stored by the store task, as seen by the last watchdog check,
+  * and the checks that found no progress.
+  */
+static u64_t store_heartbeat, watched_heartbeat;
+static u64_t store_stalls;
+
+/** Whether the store task is storing a scan (taken from the queue). */
+static u8_t store_busy;
+
+/** Whether the read task is scanning, and the scans that it has published
+  * and that the store task has stored. The novel lane is stored while the
+  * scan is still running, the repeat lane once the scan has been published.
+  */
+static u8_t scan_active;
+static u64_t published_scans, stored_scans;
+
+/** The novel SSIDs that overflowed into the repeat lane, and the SSIDs that
+  * were dropped (by the lane they were meant for) since both lanes were full.
+  */
+static u64_t novel_overflows;
+static u64_t lane_drops[QUEUE_LANES];
+
+/** Whether the scans are replayed in virtual time (by the soak test), and the
+  * time of the last one, which is the current time of the store task.
+  */
+static u8_t virtual_clock;
+static f32_t virtual_now;
+
+/** The SSIDs stored since the last published scan, for the prefetch task. */
+static struct SightedSSID sighted[PREFETCH_MAX_SCAN];
+static u32_t sighted_num;
+
 /************************ Static Function Prototypes *************************/
 
 /**
- * @brief Add a new SSID and timestamp to the queue.
- * @param ssid The SSID to be added to the queue.
- * @param timestamp The timestamp that corresponds to the SSID.
+ * @brief Run the shell script to scan a channel and add its SSIDs to the queue.
+ * @param channel The channel to be scanned (or ALL_CHANNELS).
  * @return Void.
  */
-static void queueAdd(char* ssid, f32_t timestamp);
+static void scanChannel(u32_t channel);
 
 /**
- * @brief Pop an SSID and timestamp from the queue.
- * @param ssid The SSID to be popped from the queue.
- * @param timestamp The timestamp that corresponds to the SSID.
+ * @brief Add the SSIDs of the next epoch of the replay source to the queue,
+ *        in place of a scan. They have no BSSID or signal.
  * @return Void.
  */
-static void queuePop(char* ssid, f32_t* timestamp);
+static void replayScan(void);
+
+/**
+ * @brief Add an SSID to its lane of the queue, and wake the store task up if
+ *        it is novel. A novel SSID overflows into the repeat lane if its lane
+ *        is full.
+ * @param ssid The SSID.
+ * @param bssid The BSSID of the AP.
+ * @param rssi The signal of the AP (dBm).
+ * @param timestamp The timestamp of the SSID.
+ * @return Void.
+ */
+static void enqueueSSID(char* ssid, const u8_t* bssid, s8_t rssi, f32_t timestamp);
+
+/**
+ * @brief Start a scan, once the queue is not full.
+ * @return Void.
+ */
+static void startScan(void);
+
+/**
+ * @brief Publish a scan, so that the store task takes its repeat lane too.
+ * @return Void.
+ */
+static void publishScan(void);
 
 /**
  * @brief Write SSIDs and their timestamps to a file.
@@ -53,225 +127,462 @@ static void queuePop(char* ssid, f32_t* timestamp);
  */
 static void writeToFile(void);
 
+/**
+ * @brief Print the queue's stats.
+ * @param file The file to print the stats to.
+ * @return Void.
+ */
+static void writeQueueStats(FILE* file);
+
 /***************************** Static Functions ******************************/
 
-void queueAdd(char* ssid, f32_t timestamp)
+void scanChannel(u32_t channel)
+{
+  u32_t aps = 0;
+  s32_t ssid_offset;
+  u64_t start_time;
+  f32_t rssi;
+  u8_t bssid[BSSID_SIZE];
+  char line[SSID_SIZE + 32];
+  char* ssid;
+  char command[64];
+  FILE *file;
+
+  if (channel == ALL_CHANNELS)
+    snprintf(command, sizeof(command), "/bin/bash searchWifi.sh");
+  else
+    snprintf(command, sizeof(command), "/bin/bash searchWifi.sh %u",
+             getChannelFrequency(channel));
+
+  start_time = getMonotonicTime();
+
+  file = popen(command, "r");
+
+  if (file != NULL)
+  {
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+      /* Each line is the BSSID, the RSSI and the SSID of an AP */
+      if (sscanf(line, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx %f %n", &bssid[0], &bssid[1],
+                 &bssid[2], &bssid[3], &bssid[4], &bssid[5], &rssi, &ssid_offset) != 7)
+        continue;
+
+      aps++;
+
+      /* Hidden APs are observed too, since they have a BSSID */
+      if (localize && epoch_num < LOCALIZER_MAX_OBSERVATIONS)
+      {
+        memcpy(epoch_observations[epoch_num].bssid, bssid, BSSID_SIZE);
+        epoch_observations[epoch_num].rssi = rssi;
+        epoch_num++;
+      }
+
+      ssid = &line[ssid_offset];
+
+      /* skip if SSID is x00* or empty (hidden) */
+      if (!strncmp(ssid, "x00", 3) || ssid[0] == '\0')
+        continue;
+
+      /* The SSID fits the queue with its trailing newline */
+      if (strlen(ssid) > SSID_SIZE - 2)
+        strcpy(&ssid[SSID_SIZE - 2], "\n");
+
+      enqueueSSID(ssid, bssid, rssi, getCurrentTimestamp());
+    }
+
+    pclose(file);
+  }
+
+  recordChannelScan(channel, (getMonotonicTime() - start_time) / 1e6f, aps);
+}
+
+void replayScan(void)
+{
+  u32_t i, num, length;
+  char ssid[SSID_SIZE];
+  const char* ssids[REPLAY_MAX_SCAN];
+  static const u8_t bssid[BSSID_SIZE] = { 0 };
+
+  num = nextReplayScan(ssids, REPLAY_MAX_SCAN);
+
+  for (i = 0; i < num; i++)
+  {
+    /* The SSID fits the queue with its trailing newline */
+    length = strlen(ssids[i]);
+
+    if (length > SSID_SIZE - 2)
+    {
+      memcpy(ssid, ssids[i], SSID_SIZE - 2);
+      strcpy(&ssid[SSID_SIZE - 2], "\n");
+    }
+    else
+      memcpy(ssid, ssids[i], length + 1);
+
+    enqueueSSID(ssid, bssid, 0, getCurrentTimestamp());
+  }
+}
+
+void enqueueSSID(char* ssid, const u8_t* bssid, s8_t rssi, f32_t timestamp)
 {
-  strcpy(ssid_queue.ssid_buffer[ssid_queue.tail], ssid);
-  ssid_queue.timestamp_buffer[ssid_queue.tail] = timestamp;
+  u32_t hash = hashSSID(ssid);
+  u8_t lane, queued = FALSE, novel = !checkSeen(hash);
 
-  ssid_queue.tail++;
+  pthread_mutex_lock(&ssid_queue.mutex);
 
-  if (ssid_queue.tail == BUFFER_SIZE)
-    ssid_queue.tail = 0;
-  if (ssid_queue.tail == ssid_queue.head)
-    ssid_queue.full = 1;
+  lane = novel ? LANE_NOVEL : LANE_REPEAT;
 
-  ssid_queue.empty = 0;
+  if (novel && ssid_queue.lane_full[LANE_NOVEL] && !ssid_queue.lane_full[LANE_REPEAT])
+  {
+    lane = LANE_REPEAT;
+    novel_overflows++;
+  }
+
+  if (ssid_queue.lane_full[lane])
+    lane_drops[novel ? LANE_NOVEL : LANE_REPEAT]++;
+  else
+  {
+    queueAdd(&ssid_queue, lane, ssid, bssid, rssi, timestamp);
+    queued = TRUE;
+  }
+
+  pthread_mutex_unlock(&ssid_queue.mutex);
+
+  /* A dropped SSID stays novel, so that its next sighting is not taken for a repeat */
+  if (queued)
+    markSeen(hash);
+
+  if (lane == LANE_NOVEL)
+    pthread_cond_signal(&ssid_queue.not_empty);
 }
 
-void queuePop(char* ssid, f32_t* timestamp)
+void startScan(void)
 {
-  strcpy(ssid, ssid_queue.ssid_buffer[ssid_queue.head]);
-  *timestamp = ssid_queue.timestamp_buffer[ssid_queue.head];
+  pthread_mutex_lock(&ssid_queue.mutex);
+  while (ssid_queue.full)
+    pthread_cond_wait(&ssid_queue.not_full, &ssid_queue.mutex);
 
-  ssid_queue.head++;
+  scan_active = TRUE;
 
-  if (ssid_queue.head == BUFFER_SIZE)
-    ssid_queue.head = 0;
-  if (ssid_queue.head == ssid_queue.tail)
-    ssid_queue.empty = 1;
+  pthread_mutex_unlock(&ssid_queue.mutex);
+}
 
-  ssid_queue.full = 0;
+void publishScan(void)
+{
+  advanceSeenFilter();
+
+  pthread_mutex_lock(&ssid_queue.mutex);
+
+  scan_active = FALSE;
+  published_scans++;
+
+  pthread_mutex_unlock(&ssid_queue.mutex);
+  pthread_cond_signal(&ssid_queue.not_empty);
 }
 
 void writeToFile(void)
 {
-  u64_t i, j;
-
-  FILE *file = fopen("ssids.txt", "w");
+  FILE *file = fopen(STAGING_DIR "/ssids.txt", "w");
 
   if (file != NULL)
   {
-    fprintf(file, "SSID\n");
-    fprintf(file, "    timestamp  (latency)\n");
-    fprintf(file, "=========================\n\n");
+    printSSIDStore(file);
 
-    for (i = 0; i < ssid_num; i++)
-    {
-      fprintf(file, "%s", ssids[i]);
+    fclose(file);
+  }
+}
 
-      for (j = 0; j < num_timestamps[i]; j++)
-      {
-        fprintf(file, "    %.3f", timestamps[i][j]);
-        fprintf(file, "   (%.6f)\n", latencies[i][j]);
-      }
+void writeQueueStats(FILE* file)
+{
+  u8_t lane;
+  struct QueueLane* image_lane;
+  static const char* lane_names[QUEUE_LANES] = { "novel", "repeat" };
 
-      fprintf(file, "\n");
-    }
+  pthread_mutex_lock(&ssid_queue.mutex);
 
-    fclose(file);
+  fprintf(file, "recovered  %llu\n", ssid_queue.recovered);
+  fprintf(file, "old_boots  %llu\n", ssid_queue.old_boots);
+  fprintf(file, "stalls     %llu\n", store_stalls);
+  fprintf(file, "overflows  %llu\n", novel_overflows);
+
+  for (lane = 0; lane < QUEUE_LANES; lane++)
+  {
+    image_lane = &ssid_queue.image->lane[lane];
+
+    fprintf(file, "%-10s pending %-4llu persisted %-8llu dropped %llu\n", lane_names[lane],
+            image_lane->next_seq - 1 - image_lane->persisted_seq, image_lane->persisted_seq,
+            lane_drops[lane]);
   }
+
+  for (lane = 0; lane < QUEUE_LANES; lane++)
+    printLatencyHistogram(file, lane_names[lane], &lane_latencies[lane]);
+
+  pthread_mutex_unlock(&ssid_queue.mutex);
 }
 
 /***************************** Public Functions ******************************/
 
-void initializeWifiScanner(void)
+void initializeWifiScanner(u8_t mode, u8_t store_policy, const char* ap_map,
+                           const char* cold_tier, const char* log_dir,
+                           const char* staging_file, const char* queue_file)
 {
-  ssid_queue.empty = 1;
-  ssid_queue.full = 0;
-  ssid_queue.head = 0;
-  ssid_queue.tail = 0;
-  pthread_mutex_init(&ssid_queue.mutex, NULL);
-  pthread_cond_init(&ssid_queue.not_empty, NULL);
-  pthread_cond_init(&ssid_queue.not_full, NULL);
+  scan_mode = mode;
+  localize = (ap_map != NULL);
+  prefetch = (cold_tier != NULL);
+
+  initializeChannelStats();
+  initializeSeenFilter();
+
+  resetLatencyHistogram(&lane_latencies[LANE_NOVEL]);
+  resetLatencyHistogram(&lane_latencies[LANE_REPEAT]);
+
+  initializeSSIDStore(STORE_CAPACITY, store_policy);
+  initializeFlashWriter(log_dir, staging_file);
+
+  openSSIDQueue(&ssid_queue, queue_file, log_dir);
+
+  registerMetricsSource("queue", writeQueueStats);
+  registerMetricsSource("store", printStoreStats);
+  registerMetricsSource("flash", printFlashWriterStats);
+
+  if (localize)
+  {
+    initializeLocalizer(ap_map, 0);
+    registerMetricsSource("localizer", printLocalizerStats);
+  }
+
+  if (prefetch)
+  {
+    initializeColdTier(cold_tier);
+    initializePrefetcher();
+    registerMetricsSource("cold", printColdTierStats);
+    registerMetricsSource("prefetch", printPrefetcherStats);
+  }
 }
 
 void exitWifiScanner(void)
 {
-  free(ssids);
-  free(num_timestamps);
-  free(timestamps);
+  exitSSIDStore();
+  exitFlashWriter();
+
+  /* The records left in the queue are restored from the checkpoint after a reboot */
+  accountFlashWrite(checkpointSSIDQueue(&ssid_queue));
+  closeSSIDQueue(&ssid_queue);
+
+  if (localize)
+    exitLocalizer();
 
-  pthread_mutex_destroy(&ssid_queue.mutex);
-  pthread_cond_destroy(&ssid_queue.not_empty);
-  pthread_cond_destroy(&ssid_queue.not_full);
+  if (prefetch)
+    exitColdTier();
 }
 
 void readSSID(void)
 {
-  char ssid[SSID_SIZE];
+  u32_t i;
+  f32_t min_yield;
 
-  FILE *file = popen("/bin/bash searchWifi.sh", "r");
+  startScan();
 
-  pthread_mutex_lock(&ssid_queue.mutex);
-  while (ssid_queue.full)
-    pthread_cond_wait(&ssid_queue.not_full, &ssid_queue.mutex);
+  epoch_num = 0;
 
-  if (file != NULL)
+  if (isReplaySourceOpen())
+  {
+    replayScan();
+  }
+  else if (scan_mode == SCAN_MODE_FULL)
   {
-    while (fgets(ssid, sizeof(ssid) - 1, file) != NULL)
+    scanChannel(ALL_CHANNELS);
+  }
+  else
+  {
+    if (scan_mode == SCAN_MODE_ADAPTIVE)
+      min_yield = getMeanChannelYield() * YIELD_DROP_RATIO;
+    else
+      min_yield = CHANNEL_MIN_YIELD;
+
+    for (i = 0; i < NUM_CHANNELS; i++)
     {
-      /* skip if SSID is x00* */
-      if (!ssid_queue.full && strncmp(ssid, "x00", 3))
-      {
-        queueAdd(ssid, getCurrentTimestamp());
-      }
+      if (!shouldSkipChannel(i, min_yield))
+        scanChannel(i);
     }
+  }
 
-    pclose(file);
+  publishScan();
+
+  /* The scan is a single epoch of the localizer */
+  if (localize)
+    postScanEpoch(epoch_observations, epoch_num, getCurrentTimestamp());
+}
+
+void readRecords(const struct SSIDRecord* records, u32_t num, f32_t time)
+{
+  u32_t i;
+  char ssid[SSID_SIZE];
+
+  startScan();
+
+  virtual_clock = TRUE;
+  virtual_now = time;
+
+  for (i = 0; i < num; i++)
+  {
+    memcpy(ssid, records[i].ssid, SSID_SIZE);
+    enqueueSSID(ssid, records[i].bssid, records[i].rssi, records[i].timestamp);
   }
 
-  pthread_mutex_unlock(&ssid_queue.mutex);
-  pthread_cond_signal(&ssid_queue.not_empty);
+  publishScan();
 }
 
 void storeSSIDs(void)
 {
-  u64_t i;
-  u8_t ssid_found;
-  f32_t timestamp;
-  char ssid[SSID_SIZE];
+  u8_t lane, scan_done;
+  u32_t i, num[QUEUE_LANES];
+  u64_t seq[QUEUE_LANES];
+  f32_t now;
+  f32_t latencies[QUEUE_LANES][BUFFER_SIZE], timestamps[QUEUE_LANES][BUFFER_SIZE];
+  f64_t bases[QUEUE_LANES][BUFFER_SIZE];
+  struct SSIDRecord records[QUEUE_LANES][BUFFER_SIZE];
 
   pthread_mutex_lock(&ssid_queue.mutex);
-  while (ssid_queue.empty)
+  while (ssid_queue.lane_empty[LANE_NOVEL] && stored_scans == published_scans)
     pthread_cond_wait(&ssid_queue.not_empty, &ssid_queue.mutex);
 
-  queuePop(ssid, &timestamp);
+  store_busy = TRUE;
+  scan_done = (stored_scans != published_scans);
+  stored_scans = published_scans;
+
+  /* The novel lane is taken as soon as it has records, even while the scan
+   * is still running; the repeat lane is taken once the scan is published,
+   * so that the rest of the scan is stored as a single batch.
+   */
+  for (lane = 0; lane < QUEUE_LANES; lane++)
+  {
+    for (num[lane] = 0; !ssid_queue.lane_empty[lane] && (lane == LANE_NOVEL || scan_done); num[lane]++)
+    {
+      seq[lane] = queuePop(&ssid_queue, lane, records[lane][num[lane]].ssid,
+                           records[lane][num[lane]].bssid, &records[lane][num[lane]].rssi,
+                           &timestamps[lane][num[lane]], &bases[lane][num[lane]]);
+
+      /* The store is on the time axis of this boot, so a record of an earlier
+       * boot is moved to it by the clock (it is logged as it was).
+       */
+      records[lane][num[lane]].timestamp = timestamps[lane][num[lane]];
+      if (bases[lane][num[lane]])
+        records[lane][num[lane]].timestamp += (f32_t)(bases[lane][num[lane]] - ssid_queue.realtime_base);
+    }
+  }
 
-  ssid_found = 0;
+  pthread_mutex_unlock(&ssid_queue.mutex);
 
-  for (i = 0; i < ssid_num; i++)
+  /* The novel lane is stored first */
+  for (lane = 0; lane < QUEUE_LANES; lane++)
   {
-    if (!strcmp(ssids[i], ssid) &&  /* equal */
-        timestamps[i][num_timestamps[i] - 1] != timestamp)
+    if (num[lane] == 0)
+      continue;
+
+    storeSSIDBatch(records[lane], num[lane], FALSE);
+
+    now = virtual_clock ? virtual_now : getCurrentTimestamp();
+
+    for (i = 0; i < num[lane]; i++)
     {
-      num_timestamps[i]++;
+      latencies[lane][i] = now - records[lane][i].timestamp;
 
-      if ((timestamps[i] = realloc(timestamps[i], sizeof(f32_t) * num_timestamps[i])))
-        timestamps[i][num_timestamps[i] - 1] = timestamp;
-      else
-      {
-        perror("Memory allocation failed!");
-        exit(-5);
-      }
+      appendLogRecord(records[lane][i].ssid, records[lane][i].bssid, records[lane][i].rssi,
+                      timestamps[lane][i], latencies[lane][i], bases[lane][i]);
 
-      if ((latencies[i] = realloc(latencies[i], sizeof(f32_t) * num_timestamps[i])))
-        latencies[i][num_timestamps[i] - 1] = getCurrentTimestamp() - timestamp;
-      else
+      if (prefetch && sighted_num < PREFETCH_MAX_SCAN)
       {
-        perror("Memory allocation failed!");
-        exit(-5);
+        sighted[sighted_num].hash = hashSSID(records[lane][i].ssid);
+        sighted[sighted_num].tier = records[lane][i].tier;
+        sighted_num++;
       }
-
-      ssid_found = 1;
-      break;
     }
   }
 
-  if (!ssid_found)
+  /* The prefetch task learns from the stored epoch and warms the SSIDs that
+   * are expected next, off the real-time tasks.
+   */
+  if (scan_done)
   {
-    ssid_num++;
+    if (prefetch)
+      postStoredEpoch(sighted, sighted_num);
 
-    if ((ssids = realloc(ssids, sizeof(char*) * ssid_num)))
-    {
-      if ((ssids[ssid_num - 1] = malloc(sizeof(char) * SSID_SIZE)))
-        strcpy(ssids[ssid_num - 1], ssid);
-      else
-      {
-        perror("Memory allocation failed!");
-        exit(-5);
-      }
-    }
-    else
-    {
-      perror("Memory allocation failed!");
-      exit(-5);
-    }
+    sighted_num = 0;
 
-    if ((num_timestamps = realloc(num_timestamps, sizeof(u32_t) * ssid_num)))
-      num_timestamps[ssid_num - 1] = 1;
-    else
-    {
-      perror("Memory allocation failed!");
-      exit(-5);
-    }
+    writeToFile();
+  }
 
-    if ((timestamps = realloc(timestamps, sizeof(f32_t*) * ssid_num)))
-    {
-      if ((timestamps[ssid_num - 1] = malloc(sizeof(f32_t))))
-        timestamps[ssid_num - 1][0] = timestamp;
-      else
-      {
-        perror("Memory allocation failed!");
-        exit(-5);
-      }
-    }
-    else
-    {
-      perror("Memory allocation failed!");
-      exit(-5);
-    }
+  /* The records can be dropped from the queue once they are staged for the
+   * log, since the staging buffer survives a crash too; from then on, they
+   * are at risk of a power loss for MAX_DATA_AT_RISK at most.
+   */
+  pthread_mutex_lock(&ssid_queue.mutex);
 
-    if ((latencies = realloc(latencies, sizeof(f32_t*) * ssid_num)))
-    {
-      if ((latencies[ssid_num - 1] = malloc(sizeof(f32_t))))
-        latencies[ssid_num - 1][0] = getCurrentTimestamp() - timestamp;
-      else
-      {
-        perror("Memory allocation failed!");
-        exit(-5);
-      }
-    }
-    else
-    {
-      perror("Memory allocation failed!");
-      exit(-5);
-    }
+  for (lane = 0; lane < QUEUE_LANES; lane++)
+  {
+    if (num[lane] == 0)
+      continue;
+
+    queueRelease(&ssid_queue, lane, seq[lane]);
+
+    for (i = 0; i < num[lane]; i++)
+      recordLatency(&lane_latencies[lane], latencies[lane][i]);
   }
 
+  store_heartbeat++;
+  store_busy = FALSE;
+
   pthread_mutex_unlock(&ssid_queue.mutex);
   pthread_cond_signal(&ssid_queue.not_full);
+}
+
+void flushLog(void)
+{
+  u8_t quiet;
+  u64_t left = getFrameTimeLeft();
+  u64_t guard = QUIET_WINDOW_GUARD * 1000000ull;
+  struct timespec deadline;
+
+  /* The queue's condition uses the realtime clock */
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  updateInterval(&deadline, (left > guard) ? (left - guard) : 0);
+
+  /* The read task is the only one that waits for the queue not to be full,
+   * so it is woken up once the store task has released the scan.
+   */
+  pthread_mutex_lock(&ssid_queue.mutex);
+
+  while ((store_busy || !ssid_queue.empty || stored_scans != published_scans) && left > guard)
+  {
+    if (pthread_cond_timedwait(&ssid_queue.not_full, &ssid_queue.mutex, &deadline) != 0)
+      break;
+  }
+
+  quiet = !store_busy && ssid_queue.empty && stored_scans == published_scans;
+
+  pthread_mutex_unlock(&ssid_queue.mutex);
 
-  writeToFile();
+  pollLog(quiet && getFrameTimeLeft() > guard);
+}
+
+void pollLog(u8_t quiet)
+{
+  /* Only the records that are not on flash yet are kept in the checkpoint */
+  if (pollFlashWriter(quiet))
+    accountFlashWrite(checkpointSSIDQueue(&ssid_queue));
+}
+
+void checkWatchdog(void)
+{
+  pthread_mutex_lock(&ssid_queue.mutex);
+
+  if (!ssid_queue.empty && store_heartbeat == watched_heartbeat)
+  {
+    store_stalls++;
+    fprintf(stderr, "The store task has not made progress since the last check\n");
+  }
+
+  watched_heartbeat = store_heartbeat;
+
+  pthread_mutex_unlock(&ssid_queue.mutex);
 }
\ No newline at end of file
@@ -15,40 +15,51 @@ extern "C" {
 
 /******************************** Inclusions *********************************/
 
-#include <pthread.h>
-
 #include "data_types.h"
+#include "ssid_queue.h"
+#include "ssid_store.h"
 
 /***************************** Macro Definitions *****************************/
 
-/** The max size of the SSID. */
-#define SSID_SIZE (64u)
-
-/** The size of the SSID buffer. */
-#define BUFFER_SIZE (32u)
-
-/***************************** Type Definitions ******************************/
+/** The scan modes: a single scan of all the channels, a scan per channel
+  * that drops the channels under CHANNEL_MIN_YIELD, or a scan per channel
+  * that drops the channels under YIELD_DROP_RATIO of the average yield.
+  */
+#define SCAN_MODE_FULL     (0u)
+#define SCAN_MODE_SUBSET   (1u)
+#define SCAN_MODE_ADAPTIVE (2u)
 
-/** The SSID queue for the read/store (producer/consumer) model. */
-struct SSIDQueue {
-  char ssid_buffer[BUFFER_SIZE][SSID_SIZE];
-  f32_t timestamp_buffer[BUFFER_SIZE];
+/** The yield (APs per ms) under which a channel is dropped in subset mode. */
+#define CHANNEL_MIN_YIELD (0.005f)
 
-  u32_t head, tail;
-  u8_t full, empty;
+/** The fraction of the average yield under which a channel is dropped in
+  * adaptive mode.
+  */
+#define YIELD_DROP_RATIO (0.25f)
 
-  pthread_mutex_t mutex;
-  pthread_cond_t not_empty;
-  pthread_cond_t not_full;
-};
+/** The min time (in msecs) that has to be left in the minor frame for a
+  * flush to start in it, i.e. the time a flush of a few blocks takes.
+  */
+#define QUIET_WINDOW_GUARD (100u)
 
 /***************************** Public Functions ******************************/
 
 /**
 * @brief Initialize the module.
+* @param scan_mode The mode used to scan the channels.
+* @param store_policy The eviction policy of the store.
+* @param ap_map The file of the AP map, or NULL if there is no localization.
+* @param cold_tier The file of the cold tier, or NULL if the evicted SSIDs
+*        are dropped.
+* @param log_dir The directory of the log segments and of the checkpoint of
+*        the queue.
+* @param staging_file The file that backs the staging buffer of the log.
+* @param queue_file The file that backs the queue.
 * @return Void.
 */
-void initializeWifiScanner(void);
+void initializeWifiScanner(u8_t scan_mode, u8_t store_policy, const char* ap_map,
+                           const char* cold_tier, const char* log_dir,
+                           const char* staging_file, const char* queue_file);
 
 /**
 * @brief Exit the module and clean up.
@@ -62,12 +73,48 @@ void exitWifiScanner(void);
 */
 void readSSID(void);
 
+/**
+* @brief Add the records of a scan to the queue in place of a scan, and
+*        publish it (for the soak test). From then on, the time of the scan is
+*        the current time of the store task, so the pipeline runs in virtual
+*        time.
+* @param records The records of the scan.
+* @param num The number of records.
+* @param time The virtual time of the scan.
+* @return Void.
+*/
+void readRecords(const struct SSIDRecord* records, u32_t num, f32_t time);
+
 /**
 * @brief Store locally the SSIDs and timestamp from the buffers.
 * @return Void.
 */
 void storeSSIDs(void);
 
+/**
+* @brief Flush the log in the quiet window after a scan, i.e. once the store
+*        task has stored the scan, if there is enough time left before the
+*        next scan (or minor frame). Otherwise, the log is flushed only if it
+*        has to be.
+* @return Void.
+*/
+void flushLog(void);
+
+/**
+* @brief Poll the writer of the log, and checkpoint the queue to the log
+*        directory after a flush.
+* @param quiet Whether it is a quiet window.
+* @return Void.
+*/
+void pollLog(u8_t quiet);
+
+/**
+* @brief Check that the store task makes progress while there are pending
+*        records, and report it otherwise.
+* @return Void.
+*/
+void checkWatchdog(void);
+
 /*****************************************************************************/
 
 #ifdef __cplusplus
@@ -0,0 +1,295 @@
+/**
+  * @file workload.c
+  * @brief Implements a synthetic, deterministic workload of scans that
+  *        replays the daily routine of a vehicle in virtual time.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "workload.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The schedule of a day (in hours), on time. */
+#define LEAVE_HOME   (7.5f)
+#define ARRIVE_DEPOT (8.5f)
+#define LEAVE_DEPOT  (17.0f)
+#define ARRIVE_HOME  (18.0f)
+
+/** The variation of the days, so that no two days are the same: a departure
+  * is late by up to a max (in hours), and a drive takes longer or shorter by
+  * up to a fraction of it.
+  */
+#define MAX_DEPARTURE_DELAY (0.5f)
+#define MAX_DRIVE_SPREAD    (0.25f)
+
+/** The probability (in percent) that a trip takes a detour, i.e. sees other
+  * APs in place of a stretch of the route, or skips a stretch of the route,
+  * and the max length of the stretch (as a fraction of the route).
+  */
+#define DETOUR_PERCENT (30u)
+#define SKIP_PERCENT   (20u)
+#define MAX_STRETCH    (0.2f)
+
+/** The APs of the detours. */
+#define DETOUR_APS (1000u)
+
+/** The probability (in percent) that an anchor AP is seen by a scan. */
+#define ANCHOR_SIGHT_PERCENT (90u)
+
+/***************************** Type Definitions ******************************/
+
+/** A trip along the route (to the depot, or back home), as planned for the
+  * day. The stretches are in fractions of the route (empty if not taken).
+  */
+struct Trip {
+  f32_t leave, arrive;  /* hours */
+  f32_t skip_start, skip_end;
+  f32_t detour_start, detour_end;
+  u32_t detour_first;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The state of the workload. */
+static u32_t random_state;
+static u64_t scan_num;
+static u64_t roadside_num;
+static u8_t with_bursts;
+
+/** The trips of the day, and the day they are planned for. */
+static struct Trip trips[2];
+static u64_t planned_day;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the next pseudo-random number (xorshift32).
+ * @return The next number.
+ */
+static u32_t nextRandom(void);
+
+/**
+ * @brief Get the next pseudo-random fraction.
+ * @return The next fraction (0 to 1).
+ */
+static f32_t nextFraction(void);
+
+/**
+ * @brief Plan a trip of the day.
+ * @param trip The trip.
+ * @param leave The time of the departure, if on time (in hours).
+ * @param drive The duration of the drive, if on time (in hours).
+ * @return Void.
+ */
+static void planTrip(struct Trip* trip, f32_t leave, f32_t drive);
+
+/**
+ * @brief Set the BSSID (derived from the SSID) and the RSSI of a record.
+ * @param record The record.
+ * @return Void.
+ */
+static void setRadio(struct SSIDRecord* record);
+
+/**
+ * @brief Add the anchor APs that a scan sees.
+ * @param records The records of the scan.
+ * @param num The number of records of the scan.
+ * @param name The name of the anchor.
+ * @param aps The number of APs of the anchor.
+ * @param time The virtual time of the scan.
+ * @return The new number of records of the scan.
+ */
+static u32_t addAnchor(struct SSIDRecord* records, u32_t num, const char* name,
+                       u32_t aps, f32_t time);
+
+/**
+ * @brief Add the route (or detour) and roadside APs that a scan sees.
+ * @param records The records of the scan.
+ * @param num The number of records of the scan.
+ * @param trip The trip.
+ * @param progress How far along the route the vehicle is (0 to 1, from
+ *        home), not counting a skipped stretch.
+ * @param time The virtual time of the scan.
+ * @return The new number of records of the scan.
+ */
+static u32_t addRoute(struct SSIDRecord* records, u32_t num, const struct Trip* trip,
+                      f32_t progress, f32_t time);
+
+/**
+ * @brief Add the one-off APs that a scan sees.
+ * @param records The records of the scan.
+ * @param num The number of records of the scan.
+ * @param sights The number of one-off APs.
+ * @param time The virtual time of the scan.
+ * @return The new number of records of the scan.
+ */
+static u32_t addRoadside(struct SSIDRecord* records, u32_t num, u32_t sights,
+                         f32_t time);
+
+/***************************** Static Functions ******************************/
+
+u32_t nextRandom(void)
+{
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+
+  return random_state;
+}
+
+f32_t nextFraction(void)
+{
+  return (nextRandom() % 1024u) / 1024.0f;
+}
+
+void planTrip(struct Trip* trip, f32_t leave, f32_t drive)
+{
+  trip->leave = leave + nextFraction() * MAX_DEPARTURE_DELAY;
+  trip->arrive = trip->leave + drive * (1.0f + (2.0f * nextFraction() - 1.0f) * MAX_DRIVE_SPREAD);
+
+  trip->skip_start = trip->skip_end = 0;
+  trip->detour_start = trip->detour_end = 0;
+
+  if (nextRandom() % 100 < SKIP_PERCENT)
+  {
+    trip->skip_start = nextFraction() * (1.0f - MAX_STRETCH);
+    trip->skip_end = trip->skip_start + (0.25f + 0.75f * nextFraction()) * MAX_STRETCH;
+  }
+
+  if (nextRandom() % 100 < DETOUR_PERCENT)
+  {
+    trip->detour_start = nextFraction() * (1.0f - MAX_STRETCH);
+    trip->detour_end = trip->detour_start + (0.25f + 0.75f * nextFraction()) * MAX_STRETCH;
+    trip->detour_first = nextRandom() % (u32_t)(DETOUR_APS - MAX_STRETCH * WORKLOAD_ROUTE_APS -
+                                                WORKLOAD_ROUTE_SIGHTS);
+  }
+}
+
+void setRadio(struct SSIDRecord* record)
+{
+  u32_t hash = hashSSID(record->ssid);
+
+  /* A locally administered address */
+  record->bssid[0] = 0x02;
+  record->bssid[1] = 0x00;
+  memcpy(&record->bssid[2], &hash, sizeof(hash));
+
+  record->rssi = -40 - (s8_t)(nextRandom() % 50);
+}
+
+u32_t addAnchor(struct SSIDRecord* records, u32_t num, const char* name,
+                u32_t aps, f32_t time)
+{
+  u32_t i;
+
+  for (i = 0; i < aps; i++)
+  {
+    if (nextRandom() % 100 < ANCHOR_SIGHT_PERCENT)
+    {
+      snprintf(records[num].ssid, SSID_SIZE, "%s%02u\n", name, i);
+      records[num].timestamp = time;
+      setRadio(&records[num]);
+      num++;
+    }
+  }
+
+  return num;
+}
+
+u32_t addRoute(struct SSIDRecord* records, u32_t num, const struct Trip* trip,
+               f32_t progress, f32_t time)
+{
+  u32_t i, first;
+  f32_t position = progress * (1.0f - (trip->skip_end - trip->skip_start));
+  const char* name = "route";
+
+  /* The skipped stretch is not driven, so the rest takes all of the drive */
+  if (trip->skip_end > trip->skip_start && position >= trip->skip_start)
+    position += trip->skip_end - trip->skip_start;
+
+  first = position * (WORKLOAD_ROUTE_APS - WORKLOAD_ROUTE_SIGHTS);
+
+  if (position >= trip->detour_start && position < trip->detour_end)
+  {
+    first = trip->detour_first + (position - trip->detour_start) * WORKLOAD_ROUTE_APS;
+    name = "detour";
+  }
+
+  for (i = 0; i < WORKLOAD_ROUTE_SIGHTS; i++)
+  {
+    snprintf(records[num].ssid, SSID_SIZE, "%s%04u\n", name, first + i);
+    records[num].timestamp = time;
+    setRadio(&records[num]);
+    num++;
+  }
+
+  return addRoadside(records, num, WORKLOAD_ROADSIDE_SIGHTS, time);
+}
+
+u32_t addRoadside(struct SSIDRecord* records, u32_t num, u32_t sights,
+                  f32_t time)
+{
+  u32_t i;
+
+  for (i = 0; i < sights; i++)
+  {
+    snprintf(records[num].ssid, SSID_SIZE, "roadside%08llu\n", roadside_num++);
+    records[num].timestamp = time;
+    setRadio(&records[num]);
+    num++;
+  }
+
+  return num;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeWorkload(u32_t seed, u8_t bursts)
+{
+  random_state = seed ? seed : 1;
+  scan_num = 0;
+  roadside_num = 0;
+  with_bursts = bursts;
+  planned_day = ~0ull;
+}
+
+u32_t nextWorkloadScan(struct SSIDRecord* records, f32_t* time)
+{
+  u32_t num = 0;
+  f64_t virtual_time = scan_num * (f64_t)WORKLOAD_SCAN_PERIOD;
+  u64_t day = virtual_time / WORKLOAD_DAY;
+  f32_t hour = (virtual_time - day * (f64_t)WORKLOAD_DAY) / 3600.0f;
+  struct Trip* out = &trips[0];
+  struct Trip* back = &trips[1];
+
+  *time = virtual_time;
+  scan_num++;
+
+  if (day != planned_day)
+  {
+    planTrip(out, LEAVE_HOME, ARRIVE_DEPOT - LEAVE_HOME);
+    planTrip(back, LEAVE_DEPOT, ARRIVE_HOME - LEAVE_DEPOT);
+    planned_day = day;
+  }
+
+  if (hour < out->leave || hour >= back->arrive)
+    num = addAnchor(records, num, "home", WORKLOAD_HOME_APS, *time);
+  else if (hour < out->arrive)
+    num = addRoute(records, num, out, (hour - out->leave) / (out->arrive - out->leave), *time);
+  else if (hour < back->leave && with_bursts &&
+           scan_num % WORKLOAD_BURST_PERIOD >= WORKLOAD_BURST_PERIOD - WORKLOAD_BURST_SCANS)
+    num = addRoadside(records, num, WORKLOAD_BURST_SIGHTS, *time);
+  else if (hour < back->leave)
+    num = addAnchor(records, num, "depot", WORKLOAD_DEPOT_APS, *time);
+  else
+    num = addRoute(records, num, back, (back->arrive - hour) / (back->arrive - back->leave), *time);
+
+  return num;
+}
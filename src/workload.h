@@ -0,0 +1,78 @@
+/**
+  * @file workload.h
+  * @brief Contains the declarations of functions defined in workload.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+#include "ssid_store.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The virtual time between two scans (in secs). */
+#define WORKLOAD_SCAN_PERIOD (5.0f)
+
+/** The number of virtual secs in a day. */
+#define WORKLOAD_DAY (86400.0f)
+
+/** The APs of the anchors (home and depot). */
+#define WORKLOAD_HOME_APS  (20u)
+#define WORKLOAD_DEPOT_APS (30u)
+
+/** The APs along the daily route, and how many of them a scan sees. */
+#define WORKLOAD_ROUTE_APS    (2000u)
+#define WORKLOAD_ROUTE_SIGHTS (12u)
+
+/** The one-off roadside APs a scan sees while driving. */
+#define WORKLOAD_ROADSIDE_SIGHTS (6u)
+
+/** The bursts of the workload (if enabled), i.e. short errands from the depot
+  * through a dense area: every period, a few scans see only one-off APs, more
+  * of them in total than the store holds.
+  */
+#define WORKLOAD_BURST_PERIOD (12u)
+#define WORKLOAD_BURST_SCANS  (3u)
+#define WORKLOAD_BURST_SIGHTS (96u)
+
+/** The max number of APs a scan sees (a scan of a burst is the largest). */
+#define WORKLOAD_MAX_SCAN (WORKLOAD_BURST_SIGHTS)
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize the workload, i.e. a vehicle that spends the night at
+*        home and the day at the depot, driving the same route in between,
+*        though not the same way every day (late departures, slower or faster
+*        drives, detours and skipped stretches of the route).
+* @param seed The seed of the workload (the same seed gives the same scans).
+* @param bursts Whether the day at the depot is interrupted by bursts.
+* @return Void.
+*/
+void initializeWorkload(u32_t seed, u8_t bursts);
+
+/**
+* @brief Generate the next scan of the workload.
+* @param records The records of the scan (at least WORKLOAD_MAX_SCAN).
+* @param time The virtual time of the scan.
+* @return The number of records of the scan.
+*/
+u32_t nextWorkloadScan(struct SSIDRecord* records, f32_t* time);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* WORKLOAD_H */
@@ -0,0 +1,1245 @@
+/**
+  * @file apmap.c
+  * @brief Builds the AP map of the localizer from the log segments: the
+  *        sightings of every BSSID are positioned by GPS fixes (or by the APs
+  *        of a previous map), and its position and path loss model are fitted
+  *        to them by a pool of threads that steal work from each other.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "data_types.h"
+#include "ap_map.h"
+#include "segment_reader.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The defaults of the options. */
+#define DEFAULT_MIN_SIGHTINGS (8u)
+
+/** The max number of threads. */
+#define MAX_THREADS (64u)
+
+/** The max size of a path. */
+#define PATH_SIZE (4096u)
+
+/** The max time (in secs) between the two GPS fixes a sighting is
+  * interpolated between.
+  */
+#define MAX_FIX_GAP (10.0)
+
+/** The mean radius of the earth (in meters). */
+#define EARTH_RADIUS (6371000.0)
+
+/** The max time (in secs) between a sighting and the rest of its scan. The
+  * pipeline stamps each SSID as it is read (msecs apart) and writes the novel
+  * ones before the repeated ones, so the records of a scan are not in time
+  * order, but the scans are seconds apart.
+  */
+#define SCAN_GAP (0.5f)
+
+/** The min number of APs of the previous map a scan has to see, to be
+  * positioned by them, and the max number of records of a scan.
+  */
+#define MIN_ANCHORS      (3u)
+#define MAX_SCAN_RECORDS (1024u)
+
+/** The fit of the model (as in ap_map.h): its parameters (x, y, rssi_1m,
+  * path_loss), the max iterations of Levenberg-Marquardt, and how far (in
+  * meters) a fit may leave the area of the sightings.
+  */
+#define NUM_PARAMS     (4u)
+#define MAX_ITERATIONS (50u)
+#define FIT_MARGIN     (6.0)
+
+/** The limits of the path loss exponent, and the model that is assumed when
+  * the distances of the sightings are too similar to fit one.
+  */
+#define MIN_PATH_LOSS     (1.5)
+#define MAX_PATH_LOSS     (6.0)
+#define DEFAULT_RSSI_1M   (-40.0)
+#define DEFAULT_PATH_LOSS (3.0)
+
+/** The min deviation (in dB) of the signal of an AP. */
+#define MIN_SIGMA (1.0)
+
+/** The number of BSSIDs a worker takes from its own queue at a time. */
+#define WORK_CHUNK (16u)
+
+/***************************** Type Definitions ******************************/
+
+/** A GPS fix, projected to meters east (x) and north (y) of the origin. */
+struct GPSFix {
+  f64_t time;
+  f64_t x, y;
+};
+
+/** A positioned sighting of a BSSID. The BSSID is a big-endian number, so
+  * that the sightings sort as the entries of the map (by bytes).
+  */
+struct Observation {
+  u64_t bssid;
+  f32_t x, y;
+  f32_t rssi;
+};
+
+/** The sightings of a BSSID. */
+struct BSSIDGroup {
+  u64_t first;
+  u64_t count;
+};
+
+/** The queue of a worker: the range [top, bottom) of the BSSIDs it has left.
+  * The worker takes from the bottom, and the thieves take half from the top.
+  */
+struct WorkQueue {
+  u64_t top, bottom;
+  pthread_mutex_t mutex;
+};
+
+/***************************** Static Variables ******************************/
+
+/** The options. */
+static u32_t thread_num;
+static u32_t min_sightings = DEFAULT_MIN_SIGHTINGS;
+static const char* output_path = AP_MAP_FILE;
+
+/** The origin of the map. */
+static f64_t origin_lat, origin_lon;
+
+/** The GPS fixes, sorted by time. */
+static struct GPSFix* fixes;
+static u64_t fix_num;
+
+/** The APs of the previous map, sorted by BSSID. */
+static struct APMapEntry* prior_entries;
+static u32_t prior_num;
+
+/** The segments. */
+static char** inputs;
+static u32_t input_num;
+
+/** The positioned sightings, and their lock. */
+static struct Observation* observations;
+static u64_t observation_num, observation_capacity;
+static pthread_mutex_t observation_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** The BSSIDs, and their fitted entries. */
+static struct BSSIDGroup* groups;
+static struct APMapEntry* entries;
+static u8_t* fitted;
+static u64_t group_num;
+
+/** The next segment to read, and the queues of the workers. */
+static u32_t next_input;
+static struct WorkQueue queues[MAX_THREADS];
+
+/** The counters. */
+static u64_t records, unpositioned, skipped_records, bad_segments;
+static u64_t fitted_num, sparse_num, fallbacks, steals;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the big-endian number of a BSSID.
+ * @param bssid The BSSID (6 bytes).
+ * @return The number.
+ */
+static u64_t bssidKey(const u8_t* bssid);
+
+/**
+ * @brief Read the GPS fixes from a CSV file (time,lat,lon per line, with the
+ *        UNIX time in secs), and project them around the first one, unless
+ *        there is a previous map.
+ * @param path The file of the fixes.
+ * @return Void.
+ */
+static void readFixes(const char* path);
+
+/**
+ * @brief Compare two GPS fixes by time.
+ * @return The order of the fixes.
+ */
+static int compareFixes(const void* a, const void* b);
+
+/**
+ * @brief Read a previous AP map, whose APs position the scans that have no
+ *        GPS fix.
+ * @param path The file of the map.
+ * @return Void.
+ */
+static void readPriorMap(const char* path);
+
+/**
+ * @brief Find an AP of the previous map.
+ * @param bssid The BSSID (6 bytes).
+ * @return The AP, or NULL if it is not in the map.
+ */
+static const struct APMapEntry* findPriorAP(const u8_t* bssid);
+
+/**
+ * @brief Position a scan by the GPS fixes before and after it.
+ * @param time The UNIX time of the scan.
+ * @param x The position east of the origin.
+ * @param y The position north of the origin.
+ * @return TRUE if the scan is between two close fixes, FALSE otherwise.
+ */
+static u8_t positionFromFixes(f64_t time, f32_t* x, f32_t* y);
+
+/**
+ * @brief Position a scan by the weighted centroid of the APs of the previous
+ *        map it saw.
+ * @param scan The records of the scan.
+ * @param num The number of records.
+ * @param x The position east of the origin.
+ * @param y The position north of the origin.
+ * @return TRUE if it saw enough APs of the map, FALSE otherwise.
+ */
+static u8_t positionFromAnchors(const struct SegmentRecord* scan, u32_t num,
+                                f32_t* x, f32_t* y);
+
+/**
+ * @brief Get the squared distance of a sighting from an AP, as the model
+ *        counts it (at least AP_MAP_MIN_DISTANCE).
+ * @param dx The distance east.
+ * @param dy The distance north.
+ * @return The squared distance.
+ */
+static f64_t modelDistance2(f64_t dx, f64_t dy);
+
+/**
+ * @brief Add the sightings of a thread to the positioned ones.
+ * @param local The sightings.
+ * @param num The number of sightings.
+ * @return Void.
+ */
+static void addObservations(const struct Observation* local, u64_t num);
+
+/**
+ * @brief Read the segments and position their sightings, a scan at a time.
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void* readSegments(void* arg);
+
+/**
+ * @brief Compare two sightings by BSSID.
+ * @return The order of the sightings.
+ */
+static int compareObservations(const void* a, const void* b);
+
+/**
+ * @brief Group the sorted sightings by BSSID.
+ * @return Void.
+ */
+static void groupObservations(void);
+
+/**
+ * @brief Take a chunk of BSSIDs from the own queue of a worker, or steal half
+ *        of the queue of another worker when it is empty.
+ * @param worker The worker.
+ * @param first The first BSSID of the chunk.
+ * @param last The BSSID after the last one of the chunk.
+ * @return TRUE if there was work left, FALSE otherwise.
+ */
+static u8_t takeWork(u32_t worker, u64_t* first, u64_t* last);
+
+/**
+ * @brief Solve a linear system by gaussian elimination.
+ * @param a The matrix (overwritten).
+ * @param b The right-hand side (overwritten).
+ * @param x The solution.
+ * @return TRUE if the system is not singular, FALSE otherwise.
+ */
+static u8_t solveSystem(f64_t a[NUM_PARAMS][NUM_PARAMS], f64_t b[NUM_PARAMS],
+                        f64_t x[NUM_PARAMS]);
+
+/**
+ * @brief Get the sum of squared residuals of a model.
+ * @param obs The sightings.
+ * @param num The number of sightings.
+ * @param params The model.
+ * @return The sum of squared residuals (dB^2).
+ */
+static f64_t modelCost(const struct Observation* obs, u64_t num, const f64_t params[NUM_PARAMS]);
+
+/**
+ * @brief Fit the rssi_1m and path loss of the model at a fixed position, by
+ *        linear least squares on the log distance.
+ * @param obs The sightings.
+ * @param num The number of sightings.
+ * @param params The model (its position is kept).
+ * @return Void.
+ */
+static void fitPathLoss(const struct Observation* obs, u64_t num, f64_t params[NUM_PARAMS]);
+
+/**
+ * @brief Fit the position and path loss model of a BSSID: the weighted
+ *        centroid is refined by nonlinear least squares (Levenberg-Marquardt),
+ *        and kept if the refinement diverges.
+ * @param group The BSSID.
+ * @return Void.
+ */
+static void fitBSSID(u64_t group);
+
+/**
+ * @brief Fit the BSSIDs of the queues.
+ * @param arg The index of the worker.
+ * @return NULL.
+ */
+static void* fitWorker(void* arg);
+
+/**
+ * @brief Write the fitted BSSIDs as an AP map. It is written to a temporary
+ *        file and renamed, so that a localizer never maps a partial map.
+ * @return The number of APs.
+ */
+static u32_t writeMap(void);
+
+/**
+ * @brief Find the sealed segments of the directories.
+ * @param dirs The directories.
+ * @param num The number of directories.
+ * @return Void.
+ */
+static void findInputs(char** dirs, u32_t num);
+
+/***************************** Static Functions ******************************/
+
+u64_t bssidKey(const u8_t* bssid)
+{
+  u32_t i;
+  u64_t key = 0;
+
+  for (i = 0; i < 6; i++)
+    key = (key << 8) | bssid[i];
+
+  return key;
+}
+
+void readFixes(const char* path)
+{
+  u64_t capacity = 4096;
+  f64_t time, lat, lon;
+  char line[256];
+  char* end;
+  FILE* file = fopen(path, "r");
+
+  if (file == NULL)
+  {
+    perror("Could not open the GPS fixes");
+    exit(-4);
+  }
+
+  if ((fixes = malloc(capacity * sizeof(struct GPSFix))) == NULL)
+  {
+    perror("Could not allocate the GPS fixes");
+    exit(-5);
+  }
+
+  while (fgets(line, sizeof(line), file) != NULL)
+  {
+    /* A header or a malformed line is skipped */
+    time = strtod(line, &end);
+    if (end == line || *end++ != ',')
+      continue;
+
+    lat = strtod(end, &end);
+    if (*end++ != ',')
+      continue;
+
+    lon = strtod(end, &end);
+    if (*end != '\n' && *end != '\r' && *end != '\0')
+      continue;
+
+    if (fix_num == capacity)
+    {
+      capacity *= 2;
+
+      if ((fixes = realloc(fixes, capacity * sizeof(struct GPSFix))) == NULL)
+      {
+        perror("Could not allocate the GPS fixes");
+        exit(-5);
+      }
+    }
+
+    if (fix_num == 0 && prior_entries == NULL)
+    {
+      origin_lat = lat;
+      origin_lon = lon;
+    }
+
+    /* An equirectangular projection, which is exact enough for a city */
+    fixes[fix_num].time = time;
+    fixes[fix_num].x = EARTH_RADIUS * (lon - origin_lon) * (M_PI / 180.0) *
+                       cos(origin_lat * (M_PI / 180.0));
+    fixes[fix_num].y = EARTH_RADIUS * (lat - origin_lat) * (M_PI / 180.0);
+    fix_num++;
+  }
+
+  fclose(file);
+
+  if (fix_num == 0)
+  {
+    perror("There are no GPS fixes");
+    exit(-4);
+  }
+
+  qsort(fixes, fix_num, sizeof(struct GPSFix), compareFixes);
+}
+
+int compareFixes(const void* a, const void* b)
+{
+  const struct GPSFix* x = a;
+  const struct GPSFix* y = b;
+
+  return (x->time > y->time) - (x->time < y->time);
+}
+
+void readPriorMap(const char* path)
+{
+  struct APMapHeader header;
+  FILE* file = fopen(path, "rb");
+
+  if (file == NULL || fread(&header, sizeof(header), 1, file) != 1)
+  {
+    perror("Could not read the previous AP map");
+    exit(-10);
+  }
+
+  if (header.magic != AP_MAP_MAGIC || header.version != AP_MAP_VERSION ||
+      header.entry_size != sizeof(struct APMapEntry) || header.count == 0)
+  {
+    perror("The previous AP map is not valid");
+    exit(-10);
+  }
+
+  if ((prior_entries = malloc((u64_t)header.count * sizeof(struct APMapEntry))) == NULL)
+  {
+    perror("Could not allocate the previous AP map");
+    exit(-5);
+  }
+
+  if (fseek(file, header.header_size, SEEK_SET) == -1 ||
+      fread(prior_entries, sizeof(struct APMapEntry), header.count, file) != header.count)
+  {
+    perror("Could not read the previous AP map");
+    exit(-10);
+  }
+
+  fclose(file);
+
+  /* The new map keeps the origin of the previous one */
+  origin_lat = header.origin_lat;
+  origin_lon = header.origin_lon;
+  prior_num = header.count;
+}
+
+const struct APMapEntry* findPriorAP(const u8_t* bssid)
+{
+  u32_t low = 0, high = prior_num;
+  s32_t order;
+
+  while (low < high)
+  {
+    order = memcmp(prior_entries[(low + high) / 2].bssid, bssid, 6);
+
+    if (order == 0)
+      return &prior_entries[(low + high) / 2];
+
+    if (order < 0)
+      low = (low + high) / 2 + 1;
+    else
+      high = (low + high) / 2;
+  }
+
+  return NULL;
+}
+
+u8_t positionFromFixes(f64_t time, f32_t* x, f32_t* y)
+{
+  u64_t low = 0, high = fix_num;
+  f64_t ratio;
+  const struct GPSFix* before;
+  const struct GPSFix* after;
+
+  /* The first fix after the scan */
+  while (low < high)
+  {
+    if (fixes[(low + high) / 2].time <= time)
+      low = (low + high) / 2 + 1;
+    else
+      high = (low + high) / 2;
+  }
+
+  if (low == 0 || low == fix_num)
+    return FALSE;
+
+  before = &fixes[low - 1];
+  after = &fixes[low];
+
+  if (after->time - before->time > MAX_FIX_GAP)
+    return FALSE;
+
+  ratio = (time - before->time) / (after->time - before->time);
+  *x = before->x + ratio * (after->x - before->x);
+  *y = before->y + ratio * (after->y - before->y);
+
+  return TRUE;
+}
+
+u8_t positionFromAnchors(const struct SegmentRecord* scan, u32_t num, f32_t* x, f32_t* y)
+{
+  u32_t i, anchors = 0;
+  f64_t weight, sum_weight = 0, sum_x = 0, sum_y = 0;
+  const struct APMapEntry* ap;
+
+  for (i = 0; i < num; i++)
+  {
+    if ((ap = findPriorAP(scan[i].bssid)) == NULL)
+      continue;
+
+    /* The closer APs are weighed more, by the amplitude of their signal */
+    weight = pow(10.0, scan[i].rssi / 20.0);
+    sum_weight += weight;
+    sum_x += weight * ap->x;
+    sum_y += weight * ap->y;
+    anchors++;
+  }
+
+  if (anchors < MIN_ANCHORS)
+    return FALSE;
+
+  *x = sum_x / sum_weight;
+  *y = sum_y / sum_weight;
+
+  return TRUE;
+}
+
+f64_t modelDistance2(f64_t dx, f64_t dy)
+{
+  return fmax(dx * dx + dy * dy, AP_MAP_MIN_DISTANCE * AP_MAP_MIN_DISTANCE);
+}
+
+void addObservations(const struct Observation* local, u64_t num)
+{
+  pthread_mutex_lock(&observation_mutex);
+
+  if (observation_num + num > observation_capacity)
+  {
+    while (observation_num + num > observation_capacity)
+      observation_capacity = observation_capacity ? 2 * observation_capacity : 1u << 20;
+
+    observations = realloc(observations, observation_capacity * sizeof(struct Observation));
+
+    if (observations == NULL)
+    {
+      perror("Could not allocate the sightings");
+      exit(-5);
+    }
+  }
+
+  memcpy(&observations[observation_num], local, num * sizeof(struct Observation));
+  observation_num += num;
+
+  pthread_mutex_unlock(&observation_mutex);
+}
+
+void* readSegments(void* arg)
+{
+  u32_t input, i, scan_num;
+  u8_t more, positioned;
+  u64_t local_num, local_records = 0, local_unpositioned = 0, local_skipped = 0, local_bad = 0;
+  f32_t x = 0, y = 0, scan_start = 0, scan_end = 0, time;
+  struct SegmentReader reader;
+  struct SegmentRecord* scan = malloc((MAX_SCAN_RECORDS + 1) * sizeof(struct SegmentRecord));
+  struct Observation* local = malloc(MAX_SCAN_RECORDS * sizeof(struct Observation));
+
+  if (scan == NULL || local == NULL)
+  {
+    perror("Could not allocate the scan buffers");
+    exit(-5);
+  }
+
+  while ((input = __sync_fetch_and_add(&next_input, 1)) < input_num)
+  {
+    if (!openSegmentReader(&reader, inputs[input]))
+    {
+      local_bad++;
+      continue;
+    }
+
+    scan_num = 0;
+
+    do
+    {
+      more = nextSegmentRecord(&reader, &scan[scan_num]);
+
+      if (more)
+      {
+        local_records++;
+
+        /* Version 1 records have no BSSID or signal */
+        if (!scan[scan_num].has_radio)
+        {
+          local_skipped++;
+          continue;
+        }
+
+        /* The records of a scan are at most SCAN_GAP from its time span */
+        time = scan[scan_num].timestamp;
+
+        if (scan_num == 0)
+          scan_start = scan_end = time;
+
+        if (scan_num == 0 || (time >= scan_start - SCAN_GAP && time <= scan_end + SCAN_GAP &&
+                              scan_num < MAX_SCAN_RECORDS))
+        {
+          scan_start = fminf(scan_start, time);
+          scan_end = fmaxf(scan_end, time);
+          scan_num++;
+          continue;
+        }
+      }
+
+      if (scan_num == 0)
+        continue;
+
+      /* A scan without a GPS fix is positioned by the previous map, if any */
+      positioned = fixes != NULL &&
+                   positionFromFixes(reader.header.realtime_base + (scan_start + scan_end) / 2.0,
+                                     &x, &y);
+
+      if (!positioned && prior_entries != NULL)
+        positioned = positionFromAnchors(scan, scan_num, &x, &y);
+
+      if (positioned)
+      {
+        for (i = 0, local_num = 0; i < scan_num; i++, local_num++)
+        {
+          local[local_num].bssid = bssidKey(scan[i].bssid);
+          local[local_num].x = x;
+          local[local_num].y = y;
+          local[local_num].rssi = scan[i].rssi;
+        }
+
+        addObservations(local, local_num);
+      }
+      else
+        local_unpositioned += scan_num;
+
+      /* The record that ended the scan starts the next one */
+      if (more)
+      {
+        scan[0] = scan[scan_num];
+        scan_start = scan_end = scan[0].timestamp;
+        scan_num = 1;
+      }
+      else
+        scan_num = 0;
+    } while (more);
+
+    closeSegmentReader(&reader);
+  }
+
+  free(scan);
+  free(local);
+
+  __sync_fetch_and_add(&records, local_records);
+  __sync_fetch_and_add(&unpositioned, local_unpositioned);
+  __sync_fetch_and_add(&skipped_records, local_skipped);
+  __sync_fetch_and_add(&bad_segments, local_bad);
+
+  return NULL;
+}
+
+int compareObservations(const void* a, const void* b)
+{
+  const struct Observation* x = a;
+  const struct Observation* y = b;
+
+  return (x->bssid > y->bssid) - (x->bssid < y->bssid);
+}
+
+void groupObservations(void)
+{
+  u64_t i, capacity = 1024;
+
+  if ((groups = malloc(capacity * sizeof(struct BSSIDGroup))) == NULL)
+  {
+    perror("Could not allocate the BSSIDs");
+    exit(-5);
+  }
+
+  for (i = 0; i < observation_num; i++)
+  {
+    if (i > 0 && observations[i].bssid == observations[i - 1].bssid)
+    {
+      groups[group_num - 1].count++;
+      continue;
+    }
+
+    if (group_num == capacity)
+    {
+      capacity *= 2;
+
+      if ((groups = realloc(groups, capacity * sizeof(struct BSSIDGroup))) == NULL)
+      {
+        perror("Could not allocate the BSSIDs");
+        exit(-5);
+      }
+    }
+
+    groups[group_num].first = i;
+    groups[group_num].count = 1;
+    group_num++;
+  }
+
+  entries = calloc(group_num ? group_num : 1, sizeof(struct APMapEntry));
+  fitted = calloc(group_num ? group_num : 1, sizeof(u8_t));
+
+  if (entries == NULL || fitted == NULL)
+  {
+    perror("Could not allocate the AP entries");
+    exit(-5);
+  }
+}
+
+u8_t takeWork(u32_t worker, u64_t* first, u64_t* last)
+{
+  u32_t i, victim;
+  u64_t start = 0, half = 0;
+  struct WorkQueue* own = &queues[worker];
+
+  while (1)
+  {
+    pthread_mutex_lock(&own->mutex);
+
+    if (own->top < own->bottom)
+    {
+      *last = own->bottom;
+      own->bottom = (own->bottom - own->top > WORK_CHUNK) ? own->bottom - WORK_CHUNK : own->top;
+      *first = own->bottom;
+
+      pthread_mutex_unlock(&own->mutex);
+      return TRUE;
+    }
+
+    pthread_mutex_unlock(&own->mutex);
+
+    /* The own queue is empty, so half of the first queue that is not is
+     * stolen. No work is added after the start, so when all the queues are
+     * empty, the work is done.
+     */
+    for (i = 1; i < thread_num; i++)
+    {
+      victim = (worker + i) % thread_num;
+
+      pthread_mutex_lock(&queues[victim].mutex);
+
+      half = (queues[victim].bottom - queues[victim].top + 1) / 2;
+      start = queues[victim].top;
+      queues[victim].top += half;
+
+      pthread_mutex_unlock(&queues[victim].mutex);
+
+      if (half)
+        break;
+    }
+
+    if (i == thread_num)
+      return FALSE;
+
+    __sync_fetch_and_add(&steals, 1);
+
+    pthread_mutex_lock(&own->mutex);
+    own->top = start;
+    own->bottom = start + half;
+    pthread_mutex_unlock(&own->mutex);
+  }
+}
+
+u8_t solveSystem(f64_t a[NUM_PARAMS][NUM_PARAMS], f64_t b[NUM_PARAMS], f64_t x[NUM_PARAMS])
+{
+  u32_t i, j, k, pivot;
+  f64_t factor, swap;
+
+  for (i = 0; i < NUM_PARAMS; i++)
+  {
+    /* Partial pivoting */
+    for (pivot = i, j = i + 1; j < NUM_PARAMS; j++)
+    {
+      if (fabs(a[j][i]) > fabs(a[pivot][i]))
+        pivot = j;
+    }
+
+    if (fabs(a[pivot][i]) < 1e-12)
+      return FALSE;
+
+    for (k = 0; k < NUM_PARAMS; k++)
+    {
+      swap = a[i][k];
+      a[i][k] = a[pivot][k];
+      a[pivot][k] = swap;
+    }
+
+    swap = b[i];
+    b[i] = b[pivot];
+    b[pivot] = swap;
+
+    for (j = i + 1; j < NUM_PARAMS; j++)
+    {
+      factor = a[j][i] / a[i][i];
+
+      for (k = i; k < NUM_PARAMS; k++)
+        a[j][k] -= factor * a[i][k];
+
+      b[j] -= factor * b[i];
+    }
+  }
+
+  for (i = NUM_PARAMS; i-- > 0; )
+  {
+    x[i] = b[i];
+
+    for (k = i + 1; k < NUM_PARAMS; k++)
+      x[i] -= a[i][k] * x[k];
+
+    x[i] /= a[i][i];
+  }
+
+  return TRUE;
+}
+
+f64_t modelCost(const struct Observation* obs, u64_t num, const f64_t params[NUM_PARAMS])
+{
+  u64_t i;
+  f64_t dx, dy, residual, cost = 0;
+
+  for (i = 0; i < num; i++)
+  {
+    dx = params[0] - obs[i].x;
+    dy = params[1] - obs[i].y;
+    residual = obs[i].rssi - (params[2] - 5.0 * params[3] * log10(modelDistance2(dx, dy)));
+    cost += residual * residual;
+  }
+
+  return cost;
+}
+
+void fitPathLoss(const struct Observation* obs, u64_t num, f64_t params[NUM_PARAMS])
+{
+  u64_t i;
+  f64_t dx, dy, l, sum_l = 0, sum_ll = 0, sum_r = 0, sum_lr = 0, variance, slope;
+
+  for (i = 0; i < num; i++)
+  {
+    dx = params[0] - obs[i].x;
+    dy = params[1] - obs[i].y;
+    l = 5.0 * log10(modelDistance2(dx, dy));
+
+    sum_l += l;
+    sum_ll += l * l;
+    sum_r += obs[i].rssi;
+    sum_lr += l * obs[i].rssi;
+  }
+
+  variance = sum_ll / num - (sum_l / num) * (sum_l / num);
+
+  if (variance < 1e-3)
+  {
+    params[2] = sum_r / num + DEFAULT_PATH_LOSS * sum_l / num;
+    params[3] = DEFAULT_PATH_LOSS;
+    return;
+  }
+
+  slope = (sum_lr / num - (sum_l / num) * (sum_r / num)) / variance;
+  params[3] = fmin(fmax(-slope, MIN_PATH_LOSS), MAX_PATH_LOSS);
+  params[2] = sum_r / num + params[3] * sum_l / num;
+}
+
+void fitBSSID(u64_t group)
+{
+  u32_t iteration, i, j;
+  u64_t k, num = groups[group].count;
+  f64_t weight, sum_weight = 0, centroid[NUM_PARAMS] = { 0, 0, 0, 0 };
+  f64_t params[NUM_PARAMS], trial[NUM_PARAMS], delta[NUM_PARAMS], row[NUM_PARAMS];
+  f64_t jtj[NUM_PARAMS][NUM_PARAMS], jtr[NUM_PARAMS];
+  f64_t a[NUM_PARAMS][NUM_PARAMS], b[NUM_PARAMS];
+  f64_t cost, trial_cost, lambda = 1e-3, dx, dy, d2, residual, radius = 0;
+  const struct Observation* obs = &observations[groups[group].first];
+  struct APMapEntry* entry = &entries[group];
+  u8_t converged = FALSE;
+
+  if (num < min_sightings)
+  {
+    __sync_fetch_and_add(&sparse_num, 1);
+    return;
+  }
+
+  /* The weighted centroid, that starts the fit */
+  for (k = 0; k < num; k++)
+  {
+    weight = pow(10.0, obs[k].rssi / 20.0);
+    sum_weight += weight;
+    centroid[0] += weight * obs[k].x;
+    centroid[1] += weight * obs[k].y;
+  }
+
+  centroid[0] /= sum_weight;
+  centroid[1] /= sum_weight;
+  fitPathLoss(obs, num, centroid);
+
+  for (k = 0; k < num; k++)
+  {
+    dx = centroid[0] - obs[k].x;
+    dy = centroid[1] - obs[k].y;
+    radius = fmax(radius, sqrt(dx * dx + dy * dy));
+  }
+
+  memcpy(params, centroid, sizeof(params));
+  cost = modelCost(obs, num, params);
+
+  /* Levenberg-Marquardt: rssi = rssi_1m - 5 * path_loss * log10(d^2), where
+   * a sighting within the min distance does not depend on the position.
+   */
+  for (iteration = 0; iteration < MAX_ITERATIONS && !converged; iteration++)
+  {
+    memset(jtj, 0, sizeof(jtj));
+    memset(jtr, 0, sizeof(jtr));
+
+    for (k = 0; k < num; k++)
+    {
+      dx = params[0] - obs[k].x;
+      dy = params[1] - obs[k].y;
+      d2 = modelDistance2(dx, dy);
+
+      residual = obs[k].rssi - (params[2] - 5.0 * params[3] * log10(d2));
+
+      if (dx * dx + dy * dy > AP_MAP_MIN_DISTANCE * AP_MAP_MIN_DISTANCE)
+      {
+        row[0] = -10.0 * params[3] * dx / (M_LN10 * d2);
+        row[1] = -10.0 * params[3] * dy / (M_LN10 * d2);
+      }
+      else
+        row[0] = row[1] = 0;
+      row[2] = 1.0;
+      row[3] = -5.0 * log10(d2);
+
+      for (i = 0; i < NUM_PARAMS; i++)
+      {
+        jtr[i] += row[i] * residual;
+
+        for (j = 0; j < NUM_PARAMS; j++)
+          jtj[i][j] += row[i] * row[j];
+      }
+    }
+
+    while (lambda < 1e10)
+    {
+      memcpy(a, jtj, sizeof(a));
+      memcpy(b, jtr, sizeof(b));
+
+      for (i = 0; i < NUM_PARAMS; i++)
+        a[i][i] += lambda * (jtj[i][i] + 1e-9);
+
+      if (!solveSystem(a, b, delta))
+      {
+        lambda *= 10.0;
+        continue;
+      }
+
+      for (i = 0; i < NUM_PARAMS; i++)
+        trial[i] = params[i] + delta[i];
+
+      trial[3] = fmin(fmax(trial[3], MIN_PATH_LOSS), MAX_PATH_LOSS);
+      trial_cost = modelCost(obs, num, trial);
+
+      if (trial_cost < cost)
+      {
+        converged = (cost - trial_cost < 1e-6 * cost) ||
+                    (fabs(delta[0]) + fabs(delta[1]) < 1e-3);
+        memcpy(params, trial, sizeof(params));
+        cost = trial_cost;
+        lambda = fmax(lambda / 10.0, 1e-9);
+        break;
+      }
+
+      lambda *= 10.0;
+    }
+
+    if (lambda >= 1e10)
+      break;
+  }
+
+  /* A fit that diverged, or that left the area of the sightings (e.g. to the
+   * mirror image of a straight road), falls back to the centroid.
+   */
+  dx = params[0] - centroid[0];
+  dy = params[1] - centroid[1];
+
+  if (!isfinite(cost) || !isfinite(params[0]) || !isfinite(params[1]) ||
+      sqrt(dx * dx + dy * dy) > radius + FIT_MARGIN)
+  {
+    memcpy(params, centroid, sizeof(params));
+    cost = modelCost(obs, num, params);
+    __sync_fetch_and_add(&fallbacks, 1);
+  }
+
+  for (i = 0; i < 6; i++)
+    entry->bssid[i] = obs[0].bssid >> (8 * (5 - i));
+
+  entry->sightings = (num > 0xFFFF) ? 0xFFFF : num;
+  entry->x = params[0];
+  entry->y = params[1];
+  entry->rssi_1m = params[2];
+  entry->path_loss = params[3];
+  entry->sigma = (num > NUM_PARAMS) ? sqrt(cost / (num - NUM_PARAMS)) : MIN_SIGMA;
+  if (entry->sigma < MIN_SIGMA)
+    entry->sigma = MIN_SIGMA;
+
+  fitted[group] = TRUE;
+  __sync_fetch_and_add(&fitted_num, 1);
+}
+
+void* fitWorker(void* arg)
+{
+  u32_t worker = (u32_t)(long)arg;
+  u64_t first, last, group;
+
+  while (takeWork(worker, &first, &last))
+  {
+    for (group = first; group < last; group++)
+      fitBSSID(group);
+  }
+
+  return NULL;
+}
+
+u32_t writeMap(void)
+{
+  u64_t i;
+  struct APMapHeader header;
+  char path[PATH_SIZE];
+  FILE* file;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = AP_MAP_MAGIC;
+  header.version = AP_MAP_VERSION;
+  header.header_size = sizeof(header);
+  header.entry_size = sizeof(struct APMapEntry);
+  header.count = fitted_num;
+  header.origin_lat = origin_lat;
+  header.origin_lon = origin_lon;
+
+  snprintf(path, PATH_SIZE, "%s.tmp", output_path);
+
+  if ((file = fopen(path, "wb")) == NULL || fwrite(&header, sizeof(header), 1, file) != 1)
+  {
+    perror("Could not write the AP map");
+    exit(-10);
+  }
+
+  /* The groups are in the order of the BSSIDs, as the map has to be */
+  for (i = 0; i < group_num; i++)
+  {
+    if (fitted[i] && fwrite(&entries[i], sizeof(struct APMapEntry), 1, file) != 1)
+    {
+      perror("Could not write the AP map");
+      exit(-10);
+    }
+  }
+
+  if (fflush(file) != 0 || fsync(fileno(file)) == -1 || fclose(file) != 0 ||
+      rename(path, output_path) == -1)
+  {
+    perror("Could not write the AP map");
+    exit(-10);
+  }
+
+  return header.count;
+}
+
+void findInputs(char** dirs, u32_t num)
+{
+  u32_t i, id, capacity = 1024;
+  char path[PATH_SIZE];
+  struct dirent* entry;
+  DIR* dir;
+
+  if ((inputs = malloc(capacity * sizeof(char*))) == NULL)
+  {
+    perror("Could not allocate the inputs");
+    exit(-5);
+  }
+
+  for (i = 0; i < num; i++)
+  {
+    if ((dir = opendir(dirs[i])) == NULL)
+    {
+      perror("Could not open a directory of segments");
+      exit(-4);
+    }
+
+    while ((entry = readdir(dir)) != NULL)
+    {
+      if (!isSealedSegment(entry->d_name, &id))
+        continue;
+
+      if (input_num == capacity)
+      {
+        capacity *= 2;
+
+        if ((inputs = realloc(inputs, capacity * sizeof(char*))) == NULL)
+        {
+          perror("Could not allocate the inputs");
+          exit(-5);
+        }
+      }
+
+      snprintf(path, PATH_SIZE, "%s/%s", dirs[i], entry->d_name);
+      inputs[input_num++] = strdup(path);
+    }
+
+    closedir(dir);
+  }
+}
+
+/********************************** Main Entry *******************************/
+
+s32_t main(int argc, char** argv)
+{
+  s32_t option;
+  u32_t i, map_count;
+  u64_t share;
+  const char* gps_path = NULL;
+  const char* prior_path = NULL;
+  pthread_t threads[MAX_THREADS];
+  struct timespec start_t, phase_t[3];
+
+  thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+
+  while ((option = getopt(argc, argv, "g:p:t:n:o:")) != -1)
+  {
+    switch (option)
+    {
+      case 'g':
+        gps_path = optarg;
+        break;
+
+      case 'p':
+        prior_path = optarg;
+        break;
+
+      case 't':
+        thread_num = strtoul(optarg, NULL, 0);
+        break;
+
+      case 'n':
+        min_sightings = strtoul(optarg, NULL, 0);
+        break;
+
+      case 'o':
+        output_path = optarg;
+        break;
+
+      default:
+        fprintf(stderr, "Usage: apmap [-g gps.csv] [-p previous_map] [-t threads] "
+                        "[-n min_sightings] [-o output] segment_dir...\n");
+        exit(-4);
+    }
+  }
+
+  if (argc - optind < 1 || (gps_path == NULL && prior_path == NULL) || thread_num == 0 ||
+      thread_num > MAX_THREADS || min_sightings <= NUM_PARAMS)
+  {
+    perror("Wrong arguments (GPS fixes or a previous map are needed)");
+    exit(-4);
+  }
+
+  /* The previous map sets the origin, so it is read first */
+  if (prior_path != NULL)
+    readPriorMap(prior_path);
+
+  if (gps_path != NULL)
+    readFixes(gps_path);
+
+  findInputs(&argv[optind], argc - optind);
+
+  clock_gettime(CLOCK_MONOTONIC, &start_t);
+
+  for (i = 0; i < thread_num; i++)
+    (void)pthread_create(&threads[i], NULL, readSegments, NULL);
+
+  for (i = 0; i < thread_num; i++)
+    pthread_join(threads[i], NULL);
+
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[0]);
+
+  qsort(observations, observation_num, sizeof(struct Observation), compareObservations);
+  groupObservations();
+
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[1]);
+
+  /* Each worker starts with an equal range of the BSSIDs; the BSSIDs with
+   * many sightings take longer to fit, so the idle workers steal the rest.
+   */
+  share = (group_num + thread_num - 1) / thread_num;
+
+  for (i = 0; i < thread_num; i++)
+  {
+    queues[i].top = (i * share < group_num) ? i * share : group_num;
+    queues[i].bottom = ((i + 1) * share < group_num) ? (i + 1) * share : group_num;
+    pthread_mutex_init(&queues[i].mutex, NULL);
+  }
+
+  for (i = 0; i < thread_num; i++)
+    (void)pthread_create(&threads[i], NULL, fitWorker, (void*)(long)i);
+
+  for (i = 0; i < thread_num; i++)
+    pthread_join(threads[i], NULL);
+
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[2]);
+
+  map_count = writeMap();
+
+  fprintf(stderr, "segments        %u (%llu not valid)\n", input_num, bad_segments);
+  fprintf(stderr, "records         %llu (%llu without a BSSID)\n", records, skipped_records);
+  fprintf(stderr, "sightings       %llu (%llu not positioned)\n", observation_num, unpositioned);
+  fprintf(stderr, "bssids          %llu (%llu with too few sightings)\n", group_num, sparse_num);
+  fprintf(stderr, "aps             %u (%llu from the centroid)\n", map_count, fallbacks);
+  fprintf(stderr, "steals          %llu\n", steals);
+  fprintf(stderr, "read_secs       %.2f\n", (phase_t[0].tv_sec - start_t.tv_sec) +
+          (phase_t[0].tv_nsec - start_t.tv_nsec) / 1e9);
+  fprintf(stderr, "sort_secs       %.2f\n", (phase_t[1].tv_sec - phase_t[0].tv_sec) +
+          (phase_t[1].tv_nsec - phase_t[0].tv_nsec) / 1e9);
+  fprintf(stderr, "fit_secs        %.2f\n", (phase_t[2].tv_sec - phase_t[1].tv_sec) +
+          (phase_t[2].tv_nsec - phase_t[1].tv_nsec) / 1e9);
+
+  for (i = 0; i < thread_num; i++)
+    pthread_mutex_destroy(&queues[i].mutex);
+  for (i = 0; i < input_num; i++)
+    free(inputs[i]);
+  free(inputs);
+  free(observations);
+  free(groups);
+  free(entries);
+  free(fitted);
+  free(fixes);
+  free(prior_entries);
+
+  exit(0);
+}
\ No newline at end of file
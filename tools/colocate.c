@@ -0,0 +1,1018 @@
+/**
+  * @file colocate.c
+  * @brief Finds which devices of a fleet were near each other and when, i.e.
+  *        saw the same BSSIDs within the same time bucket, with a parallel,
+  *        radix-partitioned hash join that spills its partitions to disk.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "data_types.h"
+#include "segment_reader.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The number of partitions (by the top bits of the hash). */
+#define PARTITION_BITS (8u)
+#define NUM_PARTITIONS (1u << PARTITION_BITS)
+
+/** The defaults of the options. */
+#define DEFAULT_BUCKET_SECS (60u)
+#define DEFAULT_GAP_BUCKETS (1u)
+#define DEFAULT_MEMORY_MB   (512u)
+#define DEFAULT_SPILL_DIR   "/tmp"
+
+/** The slots of the set a thread drops the repeated sightings of a segment
+  * with (a power of 2), and the load it is cleared at.
+  */
+#define SEEN_SLOTS    (1u << 16)
+#define SEEN_MAX_LOAD (SEEN_SLOTS / 2)
+
+/** The max number of threads, and the min size of a partition buffer. */
+#define MAX_THREADS     (64u)
+#define MIN_BUFFER_SIZE (4096u)
+
+/** The memory a sighting needs while it is joined (the sighting, its share
+  * of the hash table at half load and a device node).
+  */
+#define JOIN_BYTES_PER_SIGHTING (sizeof(struct Sighting) + 2 * sizeof(struct GroupSlot) + \
+                                 sizeof(struct DeviceNode))
+
+/** The max size of a path. */
+#define PATH_SIZE (4096u)
+
+/***************************** Type Definitions ******************************/
+
+/** A sighting of a BSSID by a device, in a time bucket. */
+struct Sighting {
+  u64_t bssid;
+  u32_t bucket;
+  u32_t device;
+};
+
+/** A time bucket in which two devices (a < b) saw the same BSSIDs. */
+struct PairBucket {
+  u32_t a, b;
+  u32_t bucket;
+  u32_t shared;
+};
+
+/** A slot of the hash table of the join: a (BSSID, bucket) group, with the
+  * list of the devices that saw it.
+  */
+struct GroupSlot {
+  u64_t bssid;
+  u32_t bucket;
+  u32_t head;  /* index + 1 of the first device, 0 if the slot is empty */
+};
+
+/** A device of a group. */
+struct DeviceNode {
+  u32_t device;
+  u32_t next;  /* index + 1 of the next device, 0 at the end */
+};
+
+/** A slot of the set of the sightings of a segment, valid if its generation
+  * is the current one of the thread.
+  */
+struct SeenSlot {
+  u64_t bssid;
+  u32_t bucket;
+  u32_t generation;
+};
+
+/** A spilled partition. */
+struct Partition {
+  s32_t fd;
+  u64_t size;
+  pthread_mutex_t mutex;
+};
+
+/** An input segment, and the device it belongs to. */
+struct InputFile {
+  char* path;
+  u32_t device;
+};
+
+/** The buffers a thread stages its writes to the partitions in. */
+struct PartitionBuffers {
+  u8_t* data;
+  u32_t used[NUM_PARTITIONS];
+};
+
+/***************************** Static Variables ******************************/
+
+/** The options. */
+static u32_t bucket_secs = DEFAULT_BUCKET_SECS;
+static u32_t gap_buckets = DEFAULT_GAP_BUCKETS;
+static u64_t memory_limit = DEFAULT_MEMORY_MB * 1024ull * 1024ull;
+static u32_t thread_num;
+static const char* spill_dir = DEFAULT_SPILL_DIR;
+
+/** The devices and their segments. */
+static char** device_names;
+static u32_t device_num;
+static struct InputFile* inputs;
+static u32_t input_num;
+
+/** The spilled sightings and pair buckets. */
+static char spill_path[PATH_SIZE / 2];
+static struct Partition sighting_partitions[NUM_PARTITIONS];
+static struct Partition pair_partitions[NUM_PARTITIONS];
+static u32_t buffer_size;
+
+/** The next item of the current phase (an input or a partition). */
+static u32_t next_item;
+
+/** The output, and its lock. */
+static FILE* output;
+static pthread_mutex_t output_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** The counters. */
+static u64_t sightings, skipped_records, bad_segments, repeated_sightings;
+static u64_t pair_buckets, intervals, extra_passes, grown_passes;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Mix the bits of a number (the finalizer of splitmix64).
+ * @param x The number.
+ * @return The mixed number.
+ */
+static u64_t mixBits(u64_t x);
+
+/**
+ * @brief Get the hash of a (BSSID, bucket) group.
+ * @param bssid The BSSID.
+ * @param bucket The time bucket.
+ * @return The hash.
+ */
+static u64_t hashGroup(u64_t bssid, u32_t bucket);
+
+/**
+ * @brief Open the spill files of a set of partitions.
+ * @param partitions The partitions.
+ * @param prefix The prefix of their files.
+ * @return Void.
+ */
+static void openPartitions(struct Partition* partitions, const char* prefix);
+
+/**
+ * @brief Close and delete the spill files of a set of partitions.
+ * @param partitions The partitions.
+ * @param prefix The prefix of their files.
+ * @return Void.
+ */
+static void removePartitions(struct Partition* partitions, const char* prefix);
+
+/**
+ * @brief Append a thread's buffer to its partition.
+ * @param partition The partition.
+ * @param data The buffer.
+ * @param size The size of the buffer.
+ * @return Void.
+ */
+static void spillBuffer(struct Partition* partition, const u8_t* data, u32_t size);
+
+/**
+ * @brief Stage an item for a partition, spilling the buffer when it is full.
+ * @param buffers The buffers of the thread.
+ * @param partitions The partitions.
+ * @param index The index of the partition.
+ * @param item The item.
+ * @param size The size of the item.
+ * @return Void.
+ */
+static void stageItem(struct PartitionBuffers* buffers, struct Partition* partitions,
+                      u32_t index, const void* item, u32_t size);
+
+/**
+ * @brief Spill all the buffers of a thread.
+ * @param buffers The buffers of the thread.
+ * @param partitions The partitions.
+ * @return Void.
+ */
+static void spillBuffers(struct PartitionBuffers* buffers, struct Partition* partitions);
+
+/**
+ * @brief Read the items of a partition that belong to a pass, growing their
+ *        buffer if the pass is larger than its estimate (due to skew).
+ * @param partition The partition.
+ * @param item_size The size of an item.
+ * @param passes The number of passes the partition is split to.
+ * @param pass The pass.
+ * @param items The items of the pass (may be reallocated).
+ * @param capacity The max number of items (updated if they are reallocated).
+ * @return The number of items.
+ */
+static u64_t loadPartition(struct Partition* partition, u32_t item_size, u32_t passes,
+                           u32_t pass, void** items, u64_t* capacity);
+
+/**
+ * @brief Check whether a sighting was already seen in the current segment,
+ *        and add it to the set of the segment if not.
+ * @param seen The set of the thread.
+ * @param seen_num The number of sightings in the set.
+ * @param generation The generation of the set.
+ * @param sighting The sighting.
+ * @return TRUE if it was already seen, FALSE otherwise.
+ */
+static u8_t checkSeen(struct SeenSlot* seen, u32_t* seen_num, u32_t* generation,
+                      const struct Sighting* sighting);
+
+/**
+ * @brief Get the pass of the partitioning an item belongs to.
+ * @param item The item.
+ * @param item_size The size of the item.
+ * @param passes The number of passes.
+ * @return The pass.
+ */
+static u32_t itemPass(const void* item, u32_t item_size, u32_t passes);
+
+/**
+ * @brief Phase 1: read the segments and partition the sightings.
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void* partitionSightings(void* arg);
+
+/**
+ * @brief Phase 2: join each partition of sightings on (BSSID, bucket) and
+ *        partition the pair buckets that are found.
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void* joinPartitions(void* arg);
+
+/**
+ * @brief Phase 3: merge the pair buckets of each partition into intervals.
+ * @param arg Unused.
+ * @return NULL.
+ */
+static void* mergePairs(void* arg);
+
+/**
+ * @brief Run a phase on all the threads.
+ * @param phase The phase.
+ * @return Void.
+ */
+static void runPhase(void* (*phase)(void*));
+
+/**
+ * @brief Compare two pair buckets by pair and bucket.
+ * @return The order of the pair buckets.
+ */
+static int comparePairBuckets(const void* a, const void* b);
+
+/**
+ * @brief Find the segments of the devices.
+ * @param dirs The directories of the devices.
+ * @param num The number of directories.
+ * @return Void.
+ */
+static void findInputs(char** dirs, u32_t num);
+
+/***************************** Static Functions ******************************/
+
+u64_t mixBits(u64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBull;
+  x ^= x >> 31;
+
+  return x;
+}
+
+u64_t hashGroup(u64_t bssid, u32_t bucket)
+{
+  return mixBits(bssid ^ ((u64_t)bucket << 48) ^ ((u64_t)bucket * 0x9E3779B97F4A7C15ull));
+}
+
+void openPartitions(struct Partition* partitions, const char* prefix)
+{
+  u32_t i;
+  char path[PATH_SIZE];
+
+  for (i = 0; i < NUM_PARTITIONS; i++)
+  {
+    snprintf(path, PATH_SIZE, "%s/%s_%03u", spill_path, prefix, i);
+
+    if ((partitions[i].fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600)) == -1)
+    {
+      perror("Could not create a spill file");
+      exit(-7);
+    }
+
+    partitions[i].size = 0;
+    pthread_mutex_init(&partitions[i].mutex, NULL);
+  }
+}
+
+void removePartitions(struct Partition* partitions, const char* prefix)
+{
+  u32_t i;
+  char path[PATH_SIZE];
+
+  for (i = 0; i < NUM_PARTITIONS; i++)
+  {
+    snprintf(path, PATH_SIZE, "%s/%s_%03u", spill_path, prefix, i);
+
+    close(partitions[i].fd);
+    unlink(path);
+    pthread_mutex_destroy(&partitions[i].mutex);
+  }
+}
+
+void spillBuffer(struct Partition* partition, const u8_t* data, u32_t size)
+{
+  u32_t written = 0;
+  ssize_t result;
+
+  pthread_mutex_lock(&partition->mutex);
+
+  while (written < size)
+  {
+    if ((result = pwrite(partition->fd, data + written, size - written,
+                         partition->size + written)) <= 0)
+    {
+      perror("Could not write a spill file");
+      exit(-7);
+    }
+
+    written += result;
+  }
+
+  partition->size += size;
+
+  pthread_mutex_unlock(&partition->mutex);
+}
+
+void stageItem(struct PartitionBuffers* buffers, struct Partition* partitions,
+               u32_t index, const void* item, u32_t size)
+{
+  u8_t* buffer = buffers->data + (u64_t)index * buffer_size;
+
+  if (buffers->used[index] + size > buffer_size)
+  {
+    spillBuffer(&partitions[index], buffer, buffers->used[index]);
+    buffers->used[index] = 0;
+  }
+
+  memcpy(buffer + buffers->used[index], item, size);
+  buffers->used[index] += size;
+}
+
+void spillBuffers(struct PartitionBuffers* buffers, struct Partition* partitions)
+{
+  u32_t i;
+
+  for (i = 0; i < NUM_PARTITIONS; i++)
+  {
+    if (buffers->used[i])
+      spillBuffer(&partitions[i], buffers->data + (u64_t)i * buffer_size, buffers->used[i]);
+
+    buffers->used[i] = 0;
+  }
+}
+
+u32_t itemPass(const void* item, u32_t item_size, u32_t passes)
+{
+  const struct Sighting* sighting;
+  const struct PairBucket* pair;
+
+  if (passes == 1)
+    return 0;
+
+  /* The low bits of the hash, since the high ones chose the partition */
+  if (item_size == sizeof(struct Sighting))
+  {
+    sighting = item;
+    return hashGroup(sighting->bssid, sighting->bucket) % passes;
+  }
+
+  pair = item;
+  return mixBits(((u64_t)pair->a << 32) | pair->b) % passes;
+}
+
+u64_t loadPartition(struct Partition* partition, u32_t item_size, u32_t passes,
+                    u32_t pass, void** items, u64_t* capacity)
+{
+  u64_t offset = 0, num = 0;
+  u8_t grown = FALSE;
+  u32_t i, chunk_items;
+  ssize_t result;
+  u8_t* chunk = malloc(buffer_size);
+
+  if (chunk == NULL)
+  {
+    perror("Could not allocate a chunk");
+    exit(-5);
+  }
+
+  while (offset < partition->size)
+  {
+    if ((result = pread(partition->fd, chunk, buffer_size - buffer_size % item_size, offset)) <= 0)
+    {
+      perror("Could not read a spill file");
+      exit(-7);
+    }
+
+    chunk_items = result / item_size;
+
+    for (i = 0; i < chunk_items; i++)
+    {
+      if (itemPass(chunk + (u64_t)i * item_size, item_size, passes) != pass)
+        continue;
+
+      if (num == *capacity)
+      {
+        *capacity *= 2;
+        grown = TRUE;
+
+        if ((*items = realloc(*items, *capacity * item_size)) == NULL)
+        {
+          perror("Could not allocate the items of a pass");
+          exit(-5);
+        }
+      }
+
+      memcpy((u8_t*)*items + num++ * item_size, chunk + (u64_t)i * item_size, item_size);
+    }
+
+    offset += (u64_t)chunk_items * item_size;
+  }
+
+  free(chunk);
+
+  if (grown)
+    __sync_fetch_and_add(&grown_passes, 1);
+
+  return num;
+}
+
+u8_t checkSeen(struct SeenSlot* seen, u32_t* seen_num, u32_t* generation,
+               const struct Sighting* sighting)
+{
+  u32_t slot;
+
+  /* A full set is cleared, which only lets a few repeats through */
+  if (*seen_num == SEEN_MAX_LOAD)
+  {
+    (*generation)++;
+    *seen_num = 0;
+  }
+
+  slot = hashGroup(sighting->bssid, sighting->bucket) & (SEEN_SLOTS - 1);
+
+  while (seen[slot].generation == *generation)
+  {
+    if (seen[slot].bssid == sighting->bssid && seen[slot].bucket == sighting->bucket)
+      return TRUE;
+
+    slot = (slot + 1) & (SEEN_SLOTS - 1);
+  }
+
+  seen[slot].bssid = sighting->bssid;
+  seen[slot].bucket = sighting->bucket;
+  seen[slot].generation = *generation;
+  (*seen_num)++;
+
+  return FALSE;
+}
+
+void* partitionSightings(void* arg)
+{
+  u32_t input, seen_num = 0, generation = 0;
+  u64_t bssid, local_sightings = 0, local_skipped = 0, local_bad = 0, local_repeated = 0;
+  struct Sighting sighting;
+  struct SeenSlot* seen = calloc(SEEN_SLOTS, sizeof(struct SeenSlot));
+  struct SegmentReader reader;
+  struct SegmentRecord record;
+  struct PartitionBuffers buffers;
+
+  memset(&buffers, 0, sizeof(buffers));
+
+  buffers.data = malloc((u64_t)NUM_PARTITIONS * buffer_size);
+
+  if (buffers.data == NULL || seen == NULL)
+  {
+    perror("Could not allocate the partition buffers");
+    exit(-5);
+  }
+
+  while ((input = __sync_fetch_and_add(&next_item, 1)) < input_num)
+  {
+    if (!openSegmentReader(&reader, inputs[input].path))
+    {
+      local_bad++;
+      continue;
+    }
+
+    /* A device sees the same APs in every scan of a bucket, so the repeats
+     * of a segment are dropped before they are spilled (the generation 0
+     * marks the empty slots).
+     */
+    generation++;
+    seen_num = 0;
+
+    while (nextSegmentRecord(&reader, &record))
+    {
+      /* Version 1 records have no BSSID */
+      if (!record.has_radio)
+      {
+        local_skipped++;
+        continue;
+      }
+
+      bssid = 0;
+      memcpy(&bssid, record.bssid, 6);
+
+      sighting.bssid = bssid;
+      sighting.bucket = getRecordTime(&reader, &record) / bucket_secs;
+      sighting.device = inputs[input].device;
+
+      if (checkSeen(seen, &seen_num, &generation, &sighting))
+      {
+        local_repeated++;
+        continue;
+      }
+
+      stageItem(&buffers, sighting_partitions,
+                hashGroup(sighting.bssid, sighting.bucket) >> (64 - PARTITION_BITS),
+                &sighting, sizeof(sighting));
+
+      local_sightings++;
+    }
+
+    closeSegmentReader(&reader);
+  }
+
+  spillBuffers(&buffers, sighting_partitions);
+  free(buffers.data);
+  free(seen);
+
+  __sync_fetch_and_add(&sightings, local_sightings);
+  __sync_fetch_and_add(&repeated_sightings, local_repeated);
+  __sync_fetch_and_add(&skipped_records, local_skipped);
+  __sync_fetch_and_add(&bad_segments, local_bad);
+
+  return NULL;
+}
+
+void* joinPartitions(void* arg)
+{
+  u32_t partition, pass, passes, i, j, k, head, device_count, device_capacity = 64;
+  u64_t n, max_items, node_capacity, table_size, slot, node_num, local_pairs = 0;
+  u64_t thread_memory = memory_limit / thread_num;
+  u32_t* devices = malloc(device_capacity * sizeof(u32_t));
+  struct Sighting* items;
+  struct GroupSlot* table;
+  struct DeviceNode* nodes;
+  struct PairBucket pair;
+  struct PartitionBuffers buffers;
+
+  memset(&buffers, 0, sizeof(buffers));
+  buffers.data = malloc((u64_t)NUM_PARTITIONS * buffer_size);
+
+  if (buffers.data == NULL || devices == NULL)
+  {
+    perror("Could not allocate the join buffers");
+    exit(-5);
+  }
+
+  while ((partition = __sync_fetch_and_add(&next_item, 1)) < NUM_PARTITIONS)
+  {
+    n = sighting_partitions[partition].size / sizeof(struct Sighting);
+
+    if (n == 0)
+      continue;
+
+    /* A partition that does not fit the memory of a thread (due to skew)
+     * is joined in several passes, by the low bits of the hash.
+     */
+    passes = (n * JOIN_BYTES_PER_SIGHTING + thread_memory - 1) / thread_memory;
+    if (passes == 0)
+      passes = 1;
+    if (passes > 1)
+      __sync_fetch_and_add(&extra_passes, passes - 1);
+
+    max_items = node_capacity = n / passes + n / (4 * passes) + 1024;
+
+    for (table_size = 1; table_size < 2 * max_items; table_size <<= 1);
+
+    items = malloc(max_items * sizeof(struct Sighting));
+    table = malloc(table_size * sizeof(struct GroupSlot));
+    nodes = malloc(node_capacity * sizeof(struct DeviceNode));
+
+    if (items == NULL || table == NULL || nodes == NULL)
+    {
+      perror("Could not allocate the hash table");
+      exit(-5);
+    }
+
+    for (pass = 0; pass < passes; pass++)
+    {
+      n = loadPartition(&sighting_partitions[partition], sizeof(struct Sighting),
+                        passes, pass, (void**)&items, &max_items);
+
+      /* A pass that outgrew its estimate grows the table with it */
+      if (max_items > node_capacity)
+      {
+        node_capacity = max_items;
+
+        for (; table_size < 2 * node_capacity; table_size <<= 1);
+
+        table = realloc(table, table_size * sizeof(struct GroupSlot));
+        nodes = realloc(nodes, node_capacity * sizeof(struct DeviceNode));
+
+        if (table == NULL || nodes == NULL)
+        {
+          perror("Could not allocate the hash table");
+          exit(-5);
+        }
+      }
+
+      memset(table, 0, table_size * sizeof(struct GroupSlot));
+      node_num = 0;
+
+      /* Build: group the sightings by (BSSID, bucket), once per device */
+      for (i = 0; i < n; i++)
+      {
+        slot = hashGroup(items[i].bssid, items[i].bucket) & (table_size - 1);
+
+        while (table[slot].head && (table[slot].bssid != items[i].bssid ||
+                                    table[slot].bucket != items[i].bucket))
+          slot = (slot + 1) & (table_size - 1);
+
+        for (head = table[slot].head; head; head = nodes[head - 1].next)
+        {
+          if (nodes[head - 1].device == items[i].device)
+            break;
+        }
+
+        if (head)
+          continue;
+
+        nodes[node_num].device = items[i].device;
+        nodes[node_num].next = table[slot].head;
+        node_num++;
+
+        table[slot].bssid = items[i].bssid;
+        table[slot].bucket = items[i].bucket;
+        table[slot].head = node_num;
+      }
+
+      /* Probe: every group seen by several devices gives a pair bucket per
+       * pair of devices.
+       */
+      for (slot = 0; slot < table_size; slot++)
+      {
+        if (!table[slot].head || !nodes[table[slot].head - 1].next)
+          continue;
+
+        device_count = 0;
+
+        for (head = table[slot].head; head; head = nodes[head - 1].next)
+        {
+          if (device_count == device_capacity)
+          {
+            device_capacity *= 2;
+
+            if ((devices = realloc(devices, device_capacity * sizeof(u32_t))) == NULL)
+            {
+              perror("Could not allocate the devices of a group");
+              exit(-5);
+            }
+          }
+
+          devices[device_count++] = nodes[head - 1].device;
+        }
+
+        for (j = 0; j < device_count; j++)
+        {
+          for (k = j + 1; k < device_count; k++)
+          {
+            pair.a = (devices[j] < devices[k]) ? devices[j] : devices[k];
+            pair.b = (devices[j] < devices[k]) ? devices[k] : devices[j];
+            pair.bucket = table[slot].bucket;
+            pair.shared = 1;
+
+            stageItem(&buffers, pair_partitions,
+                      mixBits(((u64_t)pair.a << 32) | pair.b) >> (64 - PARTITION_BITS),
+                      &pair, sizeof(pair));
+
+            local_pairs++;
+          }
+        }
+      }
+    }
+
+    free(items);
+    free(table);
+    free(nodes);
+  }
+
+  spillBuffers(&buffers, pair_partitions);
+  free(buffers.data);
+  free(devices);
+
+  __sync_fetch_and_add(&pair_buckets, local_pairs);
+
+  return NULL;
+}
+
+void* mergePairs(void* arg)
+{
+  u32_t partition, pass, passes;
+  u64_t i, n, max_items, local_intervals = 0;
+  u64_t thread_memory = memory_limit / thread_num;
+  u64_t start, end, shared, buckets;
+  struct PairBucket* items;
+
+  while ((partition = __sync_fetch_and_add(&next_item, 1)) < NUM_PARTITIONS)
+  {
+    n = pair_partitions[partition].size / sizeof(struct PairBucket);
+
+    if (n == 0)
+      continue;
+
+    passes = (n * sizeof(struct PairBucket) + thread_memory - 1) / thread_memory;
+    if (passes == 0)
+      passes = 1;
+
+    max_items = n / passes + n / (4 * passes) + 1024;
+
+    if ((items = malloc(max_items * sizeof(struct PairBucket))) == NULL)
+    {
+      perror("Could not allocate the pair buckets");
+      exit(-5);
+    }
+
+    for (pass = 0; pass < passes; pass++)
+    {
+      n = loadPartition(&pair_partitions[partition], sizeof(struct PairBucket),
+                        passes, pass, (void**)&items, &max_items);
+
+      qsort(items, n, sizeof(struct PairBucket), comparePairBuckets);
+
+      pthread_mutex_lock(&output_mutex);
+
+      /* The buckets of a pair that are at most gap_buckets apart are merged
+       * into an interval.
+       */
+      for (i = 0; i < n; )
+      {
+        start = end = items[i].bucket;
+        shared = 0;
+        buckets = 0;
+
+        do
+        {
+          if (items[i].bucket != end || buckets == 0)
+            buckets++;
+
+          end = items[i].bucket;
+          shared += items[i].shared;
+          i++;
+        } while (i < n && items[i].a == items[i - 1].a && items[i].b == items[i - 1].b &&
+                 items[i].bucket - end <= gap_buckets);
+
+        fprintf(output, "%s,%s,%llu,%llu,%llu,%llu\n", device_names[items[i - 1].a],
+                device_names[items[i - 1].b], start * bucket_secs, (end + 1) * bucket_secs,
+                buckets, shared);
+
+        local_intervals++;
+      }
+
+      pthread_mutex_unlock(&output_mutex);
+    }
+
+    free(items);
+  }
+
+  __sync_fetch_and_add(&intervals, local_intervals);
+
+  return NULL;
+}
+
+void runPhase(void* (*phase)(void*))
+{
+  u32_t i;
+  pthread_t threads[MAX_THREADS];
+
+  next_item = 0;
+
+  for (i = 0; i < thread_num; i++)
+    (void)pthread_create(&threads[i], NULL, phase, NULL);
+
+  for (i = 0; i < thread_num; i++)
+    pthread_join(threads[i], NULL);
+}
+
+int comparePairBuckets(const void* a, const void* b)
+{
+  const struct PairBucket* x = a;
+  const struct PairBucket* y = b;
+
+  if (x->a != y->a)
+    return (x->a < y->a) ? -1 : 1;
+  if (x->b != y->b)
+    return (x->b < y->b) ? -1 : 1;
+  if (x->bucket != y->bucket)
+    return (x->bucket < y->bucket) ? -1 : 1;
+
+  return 0;
+}
+
+void findInputs(char** dirs, u32_t num)
+{
+  u32_t i, id, capacity = 1024;
+  char path[PATH_SIZE];
+  const char* name;
+  struct dirent* entry;
+  DIR* dir;
+
+  device_names = malloc(num * sizeof(char*));
+  inputs = malloc(capacity * sizeof(struct InputFile));
+
+  if (device_names == NULL || inputs == NULL)
+  {
+    perror("Could not allocate the inputs");
+    exit(-5);
+  }
+
+  for (i = 0; i < num; i++)
+  {
+    /* A device is named after its directory */
+    name = strrchr(dirs[i], '/');
+    device_names[i] = strdup((name != NULL && name[1]) ? name + 1 : dirs[i]);
+
+    if ((dir = opendir(dirs[i])) == NULL)
+    {
+      perror("Could not open the directory of a device");
+      exit(-4);
+    }
+
+    while ((entry = readdir(dir)) != NULL)
+    {
+      if (!isSealedSegment(entry->d_name, &id))
+        continue;
+
+      if (input_num == capacity)
+      {
+        capacity *= 2;
+
+        if ((inputs = realloc(inputs, capacity * sizeof(struct InputFile))) == NULL)
+        {
+          perror("Could not allocate the inputs");
+          exit(-5);
+        }
+      }
+
+      snprintf(path, PATH_SIZE, "%s/%s", dirs[i], entry->d_name);
+      inputs[input_num].path = strdup(path);
+      inputs[input_num].device = i;
+      input_num++;
+    }
+
+    closedir(dir);
+  }
+
+  device_num = num;
+}
+
+/********************************** Main Entry *******************************/
+
+s32_t main(int argc, char** argv)
+{
+  s32_t option;
+  u32_t i;
+  struct timespec start_t, phase_t[4];
+
+  thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+  output = stdout;
+
+  while ((option = getopt(argc, argv, "b:g:t:m:d:o:")) != -1)
+  {
+    switch (option)
+    {
+      case 'b':
+        bucket_secs = strtoul(optarg, NULL, 0);
+        break;
+
+      case 'g':
+        gap_buckets = strtoul(optarg, NULL, 0);
+        break;
+
+      case 't':
+        thread_num = strtoul(optarg, NULL, 0);
+        break;
+
+      case 'm':
+        memory_limit = strtoull(optarg, NULL, 0) * 1024ull * 1024ull;
+        break;
+
+      case 'd':
+        spill_dir = optarg;
+        break;
+
+      case 'o':
+        if ((output = fopen(optarg, "w")) == NULL)
+        {
+          perror("Could not open the output");
+          exit(-4);
+        }
+        break;
+
+      default:
+        fprintf(stderr, "Usage: colocate [-b bucket_secs] [-g gap_buckets] [-t threads] "
+                        "[-m memory_mb] [-d spill_dir] [-o output] device_dir...\n");
+        exit(-4);
+    }
+  }
+
+  if (argc - optind < 2 || bucket_secs == 0 || thread_num == 0 || thread_num > MAX_THREADS ||
+      memory_limit == 0)
+  {
+    perror("Wrong arguments (at least two devices are needed)");
+    exit(-4);
+  }
+
+  /* The partition buffers of all the threads take a quarter of the memory */
+  buffer_size = memory_limit / (4ull * thread_num * NUM_PARTITIONS);
+  if (buffer_size < MIN_BUFFER_SIZE)
+    buffer_size = MIN_BUFFER_SIZE;
+  buffer_size -= buffer_size % (sizeof(struct Sighting) * sizeof(struct PairBucket));
+
+  snprintf(spill_path, sizeof(spill_path), "%s/colocate_XXXXXX", spill_dir);
+
+  if (mkdtemp(spill_path) == NULL)
+  {
+    perror("Could not create the spill directory");
+    exit(-7);
+  }
+
+  findInputs(&argv[optind], argc - optind);
+
+  openPartitions(sighting_partitions, "sightings");
+  openPartitions(pair_partitions, "pairs");
+
+  fprintf(output, "device_a,device_b,start,end,buckets,shared_bssids\n");
+
+  clock_gettime(CLOCK_MONOTONIC, &start_t);
+
+  runPhase(partitionSightings);
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[0]);
+
+  runPhase(joinPartitions);
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[1]);
+
+  runPhase(mergePairs);
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[2]);
+
+  removePartitions(sighting_partitions, "sightings");
+  removePartitions(pair_partitions, "pairs");
+  rmdir(spill_path);
+
+  if (output != stdout)
+    fclose(output);
+
+  fprintf(stderr, "devices         %u\n", device_num);
+  fprintf(stderr, "segments        %u (%llu not valid)\n", input_num, bad_segments);
+  fprintf(stderr, "sightings       %llu (%llu without a BSSID, %llu repeated)\n", sightings,
+          skipped_records, repeated_sightings);
+  fprintf(stderr, "pair_buckets    %llu\n", pair_buckets);
+  fprintf(stderr, "intervals       %llu\n", intervals);
+  fprintf(stderr, "extra_passes    %llu\n", extra_passes);
+  fprintf(stderr, "grown_passes    %llu\n", grown_passes);
+  fprintf(stderr, "partition_secs  %.2f\n", (phase_t[0].tv_sec - start_t.tv_sec) +
+          (phase_t[0].tv_nsec - start_t.tv_nsec) / 1e9);
+  fprintf(stderr, "join_secs       %.2f\n", (phase_t[1].tv_sec - phase_t[0].tv_sec) +
+          (phase_t[1].tv_nsec - phase_t[0].tv_nsec) / 1e9);
+  fprintf(stderr, "merge_secs      %.2f\n", (phase_t[2].tv_sec - phase_t[1].tv_sec) +
+          (phase_t[2].tv_nsec - phase_t[1].tv_nsec) / 1e9);
+
+  for (i = 0; i < input_num; i++)
+    free(inputs[i].path);
+  for (i = 0; i < device_num; i++)
+    free(device_names[i]);
+  free(inputs);
+  free(device_names);
+
+  exit(0);
+}
\ No newline at end of file
@@ -0,0 +1,712 @@
+/**
+  * @file legacy_archive.c
+  * @brief Implements the reader of the legacy text archives (the ssids.txt
+  *        files written by writeToFile), with a hand-written parser that
+  *        streams the files in chunks, and the reconstruction of the scan
+  *        epochs of each run from the timestamps the SSIDs of a scan share.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "legacy_archive.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The max length of an SSID of the archive. */
+#define LEGACY_SSID_SIZE (256u)
+
+/** The header of a legacy file. */
+#define LEGACY_HEADER_COLUMNS "    timestamp  (latency)"
+
+/** The bits of a digit of the radix sort. */
+#define RADIX_BITS (11u)
+#define RADIX_SIZE (1u << RADIX_BITS)
+
+/** The key of an SSID that is not interned yet. */
+#define NO_SSID (U32_MAX)
+
+/***************************** Type Definitions ******************************/
+
+/** The sightings that two files share. Only the files of a run (that are
+  * close in time) share sightings, so the pairs are counted in a hash table
+  * that grows with the pairs that occur, instead of a matrix of all of them.
+  */
+struct SharedPair {
+  u64_t pair;  /* the first file * the number of files + the second + 1, 0 if empty */
+  u64_t count;
+};
+
+/** The table of the shared sightings. */
+struct SharedTable {
+  struct SharedPair* pairs;
+  u64_t num, size;
+};
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Get the hash of an SSID (FNV-1a).
+ * @param ssid The SSID.
+ * @param length The length of the SSID.
+ * @return The hash.
+ */
+static u32_t hashName(const char* ssid, u32_t length);
+
+/**
+ * @brief Get the index of an SSID, adding it to the archive if it is new.
+ * @param archive The archive.
+ * @param ssid The SSID (without the trailing newline).
+ * @param length The length of the SSID.
+ * @return The index of the SSID.
+ */
+static u32_t internSSID(struct LegacyArchive* archive, const char* ssid, u32_t length);
+
+/**
+ * @brief Parse an unsigned decimal number to fixed point.
+ * @param cursor The text, moved after the number.
+ * @param end The end of the text.
+ * @param decimals The decimals of the fixed point.
+ * @param value The number, times 10^decimals.
+ * @return TRUE if there was a number, FALSE otherwise.
+ */
+static u8_t parseFixed(const char** cursor, const char* end, u32_t decimals, u64_t* value);
+
+/**
+ * @brief Parse a timestamp line ("    %.3f   (%.6f)").
+ * @param line The line (without the newline).
+ * @param end The end of the line.
+ * @param timestamp The timestamp (in msecs).
+ * @param latency The latency (in secs).
+ * @return TRUE if the line is a timestamp line, FALSE otherwise.
+ */
+static u8_t parseTimestampLine(const char* line, const char* end, u64_t* timestamp,
+                               f32_t* latency);
+
+/**
+ * @brief Add a sighting to the archive.
+ * @param archive The archive.
+ * @param key The key of the sighting.
+ * @param latency The latency of the sighting.
+ * @return Void.
+ */
+static void addSighting(struct LegacyArchive* archive, u64_t key, f32_t latency);
+
+/**
+ * @brief Count a sighting that two files share.
+ * @param table The table of the shared sightings.
+ * @param pair The key of the pair of files.
+ * @return Void.
+ */
+static void countSharedPair(struct SharedTable* table, u64_t pair);
+
+/***************************** Static Functions ******************************/
+
+u32_t hashName(const char* ssid, u32_t length)
+{
+  u32_t i, hash = 2166136261u;
+
+  for (i = 0; i < length; i++)
+  {
+    hash ^= (u8_t)ssid[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+u32_t internSSID(struct LegacyArchive* archive, const char* ssid, u32_t length)
+{
+  u32_t i, slot, index;
+  u32_t* table;
+  const char* name;
+
+  /* The table is kept at most half full */
+  if (2 * (archive->ssid_num + 1) > archive->table_size)
+  {
+    table = calloc(2 * archive->table_size, sizeof(u32_t));
+
+    if (table == NULL)
+    {
+      perror("Could not allocate the SSIDs of the archive");
+      exit(-12);
+    }
+
+    for (i = 0; i < archive->table_size; i++)
+    {
+      if (!archive->table[i])
+        continue;
+
+      index = archive->table[i] - 1;
+      name = &archive->names[archive->offsets[index]];
+      slot = hashName(name, strlen(name) - 1) & (2 * archive->table_size - 1);
+
+      while (table[slot])
+        slot = (slot + 1) & (2 * archive->table_size - 1);
+
+      table[slot] = index + 1;
+    }
+
+    free(archive->table);
+    archive->table = table;
+    archive->table_size *= 2;
+  }
+
+  slot = hashName(ssid, length) & (archive->table_size - 1);
+
+  while (archive->table[slot])
+  {
+    index = archive->table[slot] - 1;
+    name = &archive->names[archive->offsets[index]];
+
+    if (!memcmp(name, ssid, length) && name[length] == '\n' && name[length + 1] == '\0')
+      return index;
+
+    slot = (slot + 1) & (archive->table_size - 1);
+  }
+
+  if (archive->ssid_num == LEGACY_MAX_SSIDS)
+  {
+    perror("Too many SSIDs in the archive");
+    exit(-12);
+  }
+
+  if (archive->ssid_num == archive->ssid_capacity)
+  {
+    archive->ssid_capacity *= 2;
+
+    if ((archive->offsets = realloc(archive->offsets,
+                                    archive->ssid_capacity * sizeof(u64_t))) == NULL)
+    {
+      perror("Could not allocate the SSIDs of the archive");
+      exit(-12);
+    }
+  }
+
+  while (archive->names_size + length + 2 > archive->names_capacity)
+  {
+    archive->names_capacity *= 2;
+
+    if ((archive->names = realloc(archive->names, archive->names_capacity)) == NULL)
+    {
+      perror("Could not allocate the SSIDs of the archive");
+      exit(-12);
+    }
+  }
+
+  /* The SSIDs are kept with the trailing newline, as in the queue */
+  memcpy(&archive->names[archive->names_size], ssid, length);
+  archive->names[archive->names_size + length] = '\n';
+  archive->names[archive->names_size + length + 1] = '\0';
+
+  index = archive->ssid_num++;
+  archive->offsets[index] = archive->names_size;
+  archive->names_size += length + 2;
+  archive->table[slot] = index + 1;
+
+  return index;
+}
+
+u8_t parseFixed(const char** cursor, const char* end, u32_t decimals, u64_t* value)
+{
+  const char* c = *cursor;
+  u32_t fraction = 0;
+  u64_t number = 0;
+
+  if (c == end || *c < '0' || *c > '9')
+    return FALSE;
+
+  while (c < end && *c >= '0' && *c <= '9')
+    number = number * 10 + (*c++ - '0');
+
+  if (c < end && *c == '.')
+  {
+    c++;
+
+    /* The extra decimals are truncated */
+    while (c < end && *c >= '0' && *c <= '9')
+    {
+      if (fraction < decimals)
+      {
+        number = number * 10 + (*c - '0');
+        fraction++;
+      }
+
+      c++;
+    }
+  }
+
+  while (fraction++ < decimals)
+    number *= 10;
+
+  *cursor = c;
+  *value = number;
+
+  return TRUE;
+}
+
+u8_t parseTimestampLine(const char* line, const char* end, u64_t* timestamp, f32_t* latency)
+{
+  u64_t value;
+  u8_t negative;
+  const char* c = line;
+
+  while (c < end && *c == ' ')
+    c++;
+
+  if (c == line || !parseFixed(&c, end, 3, timestamp) ||
+      *timestamp >= (1ull << (64 - LEGACY_SSID_BITS)))
+    return FALSE;
+
+  while (c < end && *c == ' ')
+    c++;
+
+  if (c == end || *c++ != '(')
+    return FALSE;
+
+  /* The latency of a record with a rounded timestamp may be negative */
+  if ((negative = (c < end && *c == '-')))
+    c++;
+
+  if (!parseFixed(&c, end, 6, &value) || c == end || *c != ')')
+    return FALSE;
+
+  *latency = negative ? -(value / 1e6f) : value / 1e6f;
+
+  return TRUE;
+}
+
+void addSighting(struct LegacyArchive* archive, u64_t key, f32_t latency)
+{
+  if (archive->num == archive->capacity)
+  {
+    archive->capacity *= 2;
+
+    if ((archive->sightings = realloc(archive->sightings,
+                                      archive->capacity * sizeof(struct LegacySighting))) == NULL)
+    {
+      perror("Could not allocate the sightings of the archive");
+      exit(-12);
+    }
+  }
+
+  archive->sightings[archive->num].key = key;
+  archive->sightings[archive->num].latency = latency;
+  archive->sightings[archive->num].run = archive->file_num;
+  archive->num++;
+}
+
+void countSharedPair(struct SharedTable* table, u64_t pair)
+{
+  u64_t i, slot, size;
+  struct SharedPair* pairs;
+
+  /* The table is kept at most half full */
+  if (2 * (table->num + 1) > table->size)
+  {
+    size = 2 * table->size;
+
+    if ((pairs = calloc(size, sizeof(struct SharedPair))) == NULL)
+    {
+      perror("Could not allocate the shared sightings of the archive");
+      exit(-12);
+    }
+
+    for (i = 0; i < table->size; i++)
+    {
+      if (!table->pairs[i].pair)
+        continue;
+
+      slot = (table->pairs[i].pair * 0x9E3779B97F4A7C15ull) & (size - 1);
+
+      while (pairs[slot].pair)
+        slot = (slot + 1) & (size - 1);
+
+      pairs[slot] = table->pairs[i];
+    }
+
+    free(table->pairs);
+    table->pairs = pairs;
+    table->size = size;
+  }
+
+  slot = (pair * 0x9E3779B97F4A7C15ull) & (table->size - 1);
+
+  while (table->pairs[slot].pair && table->pairs[slot].pair != pair)
+    slot = (slot + 1) & (table->size - 1);
+
+  if (!table->pairs[slot].pair)
+  {
+    table->pairs[slot].pair = pair;
+    table->num++;
+  }
+
+  table->pairs[slot].count++;
+}
+
+/***************************** Public Functions ******************************/
+
+void initializeLegacyArchive(struct LegacyArchive* archive)
+{
+  memset(archive, 0, sizeof(*archive));
+
+  archive->capacity = 1u << 16;
+  archive->names_capacity = 1u << 16;
+  archive->ssid_capacity = 1u << 10;
+  archive->table_size = 1u << 11;
+
+  archive->sightings = malloc(archive->capacity * sizeof(struct LegacySighting));
+  archive->names = malloc(archive->names_capacity);
+  archive->offsets = malloc(archive->ssid_capacity * sizeof(u64_t));
+  archive->table = calloc(archive->table_size, sizeof(u32_t));
+
+  if (archive->sightings == NULL || archive->names == NULL || archive->offsets == NULL ||
+      archive->table == NULL)
+  {
+    perror("Could not allocate the archive");
+    exit(-12);
+  }
+}
+
+u8_t readLegacyFile(struct LegacyArchive* archive, const char* path)
+{
+  s32_t fd;
+  ssize_t result;
+  u32_t used = 0, ssid_length = 0, ssid = NO_SSID;
+  u8_t expect_ssid = TRUE, has_ssid = FALSE;
+  u64_t timestamp;
+  f32_t latency;
+  char pending[LEGACY_SSID_SIZE];
+  char* buffer;
+  const char* line;
+  const char* newline;
+  const char* end;
+
+  if ((fd = open(path, O_RDONLY)) == -1)
+    return FALSE;
+
+  if ((buffer = malloc(LEGACY_CHUNK_SIZE)) == NULL)
+  {
+    perror("Could not allocate the chunk of the archive");
+    exit(-12);
+  }
+
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  while ((result = read(fd, buffer + used, LEGACY_CHUNK_SIZE - used)) > 0 || used > 0)
+  {
+    if (result < 0)
+      break;
+
+    archive->bytes += (result > 0) ? result : 0;
+    used += (result > 0) ? result : 0;
+    end = buffer + used;
+    line = buffer;
+
+    while (line < end)
+    {
+      newline = memchr(line, '\n', end - line);
+
+      /* A partial line waits for the next chunk, unless the file ended */
+      if (newline == NULL)
+      {
+        if (result > 0)
+          break;
+
+        newline = end;
+      }
+
+      archive->lines++;
+
+      if (newline == line)
+      {
+        /* A blank line ends the timestamps of an SSID */
+        expect_ssid = TRUE;
+        has_ssid = FALSE;
+      }
+      else if (expect_ssid)
+      {
+        ssid_length = newline - line;
+        has_ssid = (ssid_length < LEGACY_SSID_SIZE);
+        expect_ssid = FALSE;
+        ssid = NO_SSID;
+
+        if (has_ssid)
+          memcpy(pending, line, ssid_length);
+        else
+          archive->malformed++;
+      }
+      else if (parseTimestampLine(line, newline, &timestamp, &latency))
+      {
+        if (has_ssid)
+        {
+          /* An SSID is interned on its first timestamp, so that the header
+           * (of every snapshot in a concatenated archive) is never one.
+           */
+          if (ssid == NO_SSID)
+            ssid = internSSID(archive, pending, ssid_length);
+
+          addSighting(archive, (timestamp << LEGACY_SSID_BITS) | ssid, latency);
+        }
+      }
+      else if ((u32_t)(newline - line) != strlen(LEGACY_HEADER_COLUMNS) ||
+               memcmp(line, LEGACY_HEADER_COLUMNS, newline - line))
+      {
+        if (*line != '=')
+          archive->malformed++;
+      }
+
+      line = (newline < end) ? newline + 1 : end;
+    }
+
+    /* The partial line is moved to the start of the buffer; a line that
+     * fills the buffer is dropped.
+     */
+    used = end - line;
+
+    if (used == LEGACY_CHUNK_SIZE)
+    {
+      archive->malformed++;
+      used = 0;
+    }
+
+    memmove(buffer, line, used);
+
+    if (result == 0)
+      break;
+  }
+
+  free(buffer);
+  close(fd);
+
+  archive->file_num++;
+
+  return (result == 0);
+}
+
+void sortLegacyArchive(struct LegacyArchive* archive)
+{
+  u32_t shift, bits = 0, f, g, run, root;
+  u64_t i, j, num, max_key = 0, counts[RADIX_SIZE];
+  struct SharedTable shared;
+  u64_t* file_counts;
+  u32_t* parents;
+  struct LegacySighting* sorted;
+  struct LegacySighting* swap;
+
+  for (i = 0; i < archive->num; i++)
+  {
+    if (archive->sightings[i].key > max_key)
+      max_key = archive->sightings[i].key;
+  }
+
+  while (bits < 64 && (max_key >> bits))
+    bits++;
+
+  sorted = malloc((archive->num ? archive->num : 1) * sizeof(struct LegacySighting));
+  shared.num = 0;
+  shared.size = 1u << 10;
+  shared.pairs = calloc(shared.size, sizeof(struct SharedPair));
+  file_counts = calloc(archive->file_num + 1, sizeof(u64_t));
+  parents = malloc((archive->file_num + 1) * sizeof(u32_t));
+  archive->file_runs = realloc(archive->file_runs, (archive->file_num + 1) * sizeof(u32_t));
+
+  if (sorted == NULL || shared.pairs == NULL || file_counts == NULL || parents == NULL ||
+      archive->file_runs == NULL)
+  {
+    perror("Could not allocate the sort of the archive");
+    exit(-12);
+  }
+
+  /* An LSD radix sort on the bits that are used, which is stable, so that the
+   * duplicates keep the order of the files.
+   */
+  for (shift = 0; shift < bits; shift += RADIX_BITS)
+  {
+    memset(counts, 0, sizeof(counts));
+
+    for (i = 0; i < archive->num; i++)
+      counts[(archive->sightings[i].key >> shift) & (RADIX_SIZE - 1)]++;
+
+    for (i = 0, num = 0; i < RADIX_SIZE; i++)
+    {
+      num += counts[i];
+      counts[i] = num - counts[i];
+    }
+
+    for (i = 0; i < archive->num; i++)
+      sorted[counts[(archive->sightings[i].key >> shift) & (RADIX_SIZE - 1)]++] =
+        archive->sightings[i];
+
+    swap = archive->sightings;
+    archive->sightings = sorted;
+    sorted = swap;
+  }
+
+  /* The sightings that two files share (the same SSID at the same msec), and
+   * the distinct sightings of each file.
+   */
+  for (i = 0; i < archive->num; i++)
+  {
+    f = archive->sightings[i].run;
+
+    if (i > 0 && archive->sightings[i - 1].key == archive->sightings[i].key)
+    {
+      g = archive->sightings[i - 1].run;
+
+      if (g != f)
+        countSharedPair(&shared, (u64_t)g * archive->file_num + f + 1);
+      else
+        continue;
+    }
+
+    file_counts[f]++;
+  }
+
+  /* The files that share enough sightings are snapshots of the same run */
+  for (f = 0; f < archive->file_num; f++)
+    parents[f] = f;
+
+  for (i = 0; i < shared.size; i++)
+  {
+    if (!shared.pairs[i].pair)
+      continue;
+
+    f = (shared.pairs[i].pair - 1) / archive->file_num;
+    g = (shared.pairs[i].pair - 1) % archive->file_num;
+
+    if (shared.pairs[i].count * LEGACY_RUN_SHARE <
+        ((file_counts[f] < file_counts[g]) ? file_counts[f] : file_counts[g]))
+      continue;
+
+    /* The root of a run is its first file */
+    for (run = g; parents[run] != run; run = parents[run]);
+    for (root = f; parents[root] != root; root = parents[root]);
+
+    if (root < run)
+      parents[run] = root;
+    else
+      parents[root] = run;
+  }
+
+  /* The runs are numbered in the order of their first files */
+  archive->run_num = 0;
+
+  for (f = 0; f < archive->file_num; f++)
+  {
+    for (run = f; parents[run] != run; run = parents[run]);
+
+    archive->file_runs[f] = (run == f) ? archive->run_num++ : archive->file_runs[run];
+  }
+
+  /* A stable counting sort by run keeps the sightings of a run by time */
+  memset(file_counts, 0, (archive->file_num + 1) * sizeof(u64_t));
+
+  for (i = 0; i < archive->num; i++)
+  {
+    archive->sightings[i].run = archive->file_runs[archive->sightings[i].run];
+    file_counts[archive->sightings[i].run]++;
+  }
+
+  for (f = 0, num = 0; f < archive->run_num; f++)
+  {
+    num += file_counts[f];
+    file_counts[f] = num - file_counts[f];
+  }
+
+  for (i = 0; i < archive->num; i++)
+    sorted[file_counts[archive->sightings[i].run]++] = archive->sightings[i];
+
+  swap = archive->sightings;
+  archive->sightings = sorted;
+  sorted = swap;
+
+  free(sorted);
+  free(shared.pairs);
+  free(file_counts);
+  free(parents);
+
+  /* The snapshots of the store overlap, so a sighting may be in many */
+  for (i = 0, j = 0; i < archive->num; i++)
+  {
+    if (j > 0 && archive->sightings[j - 1].key == archive->sightings[i].key &&
+        archive->sightings[j - 1].run == archive->sightings[i].run)
+    {
+      archive->duplicates++;
+      continue;
+    }
+
+    archive->sightings[j++] = archive->sightings[i];
+  }
+
+  archive->num = j;
+  archive->cursor = 0;
+  archive->epochs = 0;
+}
+
+u32_t nextLegacyEpoch(struct LegacyArchive* archive, const struct LegacySighting** first,
+                      f32_t* timestamp)
+{
+  u64_t i = archive->cursor;
+
+  if (i >= archive->num)
+    return 0;
+
+  *first = &archive->sightings[i];
+  *timestamp = (archive->sightings[i].key >> LEGACY_SSID_BITS) / 1000.0f;
+
+  for (i++; i < archive->num; i++)
+  {
+    if (archive->sightings[i].run != archive->sightings[i - 1].run ||
+        (archive->sightings[i].key >> LEGACY_SSID_BITS) -
+        (archive->sightings[i - 1].key >> LEGACY_SSID_BITS) > LEGACY_EPOCH_GAP)
+      break;
+  }
+
+  archive->epochs++;
+  archive->cursor = i;
+
+  return i - (*first - archive->sightings);
+}
+
+const char* getLegacySSID(const struct LegacyArchive* archive,
+                          const struct LegacySighting* sighting)
+{
+  return &archive->names[archive->offsets[sighting->key & (LEGACY_MAX_SSIDS - 1)]];
+}
+
+void rewindLegacyArchive(struct LegacyArchive* archive)
+{
+  archive->cursor = 0;
+}
+
+void exitLegacyArchive(struct LegacyArchive* archive)
+{
+  free(archive->sightings);
+  free(archive->names);
+  free(archive->offsets);
+  free(archive->table);
+  free(archive->file_runs);
+
+  memset(archive, 0, sizeof(*archive));
+}
+
+void printLegacyArchiveStats(const struct LegacyArchive* archive, FILE* file)
+{
+  fprintf(file, "bytes       %llu\n", archive->bytes);
+  fprintf(file, "lines       %llu\n", archive->lines);
+  fprintf(file, "malformed   %llu\n", archive->malformed);
+  fprintf(file, "sightings   %llu\n", archive->num);
+  fprintf(file, "duplicates  %llu\n", archive->duplicates);
+  fprintf(file, "ssids       %u\n", archive->ssid_num);
+  fprintf(file, "runs        %u (%u files)\n", archive->run_num, archive->file_num);
+  fprintf(file, "epochs      %llu\n", archive->epochs);
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+/**
+  * @file legacy_archive.h
+  * @brief Contains the declarations of functions defined in legacy_archive.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef LEGACY_ARCHIVE_H
+#define LEGACY_ARCHIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include <stdio.h>
+
+#include "data_types.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The size of the chunks the legacy files are read in. */
+#define LEGACY_CHUNK_SIZE (4u * 1024u * 1024u)
+
+/** The max time (in msecs) between two sightings of the same scan epoch. The
+  * legacy scans timestamped each SSID as it was read from the script, so the
+  * SSIDs of a scan are a few msecs apart, and the scans seconds apart.
+  */
+#define LEGACY_EPOCH_GAP (500u)
+
+/** The share of the sightings of two files that has to be the same, for
+  * them to be snapshots of the same run (1 / LEGACY_RUN_SHARE of the smaller
+  * one), since the timestamps of different boots may coincide by chance.
+  */
+#define LEGACY_RUN_SHARE (100u)
+
+/** The bits of the key of a sighting that hold its SSID. */
+#define LEGACY_SSID_BITS (24u)
+#define LEGACY_MAX_SSIDS (1u << LEGACY_SSID_BITS)
+
+/***************************** Type Definitions ******************************/
+
+/** A sighting of a legacy archive. The key is the timestamp (in msecs) and
+  * the index of the SSID, so that the sightings sort by time.
+  */
+struct LegacySighting {
+  u64_t key;
+  f32_t latency;
+  u32_t run;  /* the file until the archive is sorted, then its run */
+};
+
+/** A legacy archive: the sightings of one or more ssids.txt files, and their
+  * distinct SSIDs (with the trailing newline, NUL-terminated). The timestamps
+  * are since the boot of a run, so the files of different runs are sorted
+  * and split into epochs separately.
+  */
+struct LegacyArchive {
+  struct LegacySighting* sightings;
+  u64_t num, capacity;
+
+  char* names;
+  u64_t names_size, names_capacity;
+  u64_t* offsets;
+  u32_t ssid_num, ssid_capacity;
+  u32_t* table;  /* index + 1 of an SSID, 0 if the slot is empty */
+  u32_t table_size;
+
+  u32_t* file_runs;  /* the run of each file, set when the archive is sorted */
+  u32_t file_num, run_num;
+
+  u64_t cursor;  /* the first sighting of the next epoch */
+
+  u64_t bytes, lines, malformed, duplicates, epochs;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Initialize an empty archive.
+* @param archive The archive.
+* @return Void.
+*/
+void initializeLegacyArchive(struct LegacyArchive* archive);
+
+/**
+* @brief Parse a legacy ssids.txt file (as written by writeToFile) and add its
+*        sightings to the archive.
+* @param archive The archive.
+* @param path The file.
+* @return TRUE if the file was read, FALSE otherwise.
+*/
+u8_t readLegacyFile(struct LegacyArchive* archive, const char* path);
+
+/**
+* @brief Find the runs of the files (the files that share sightings are
+*        snapshots of the same run), sort the sightings of each run by time
+*        and drop its duplicates (the snapshots of the store overlap), so
+*        that the epochs can be read.
+* @param archive The archive.
+* @return Void.
+*/
+void sortLegacyArchive(struct LegacyArchive* archive);
+
+/**
+* @brief Get the next scan epoch, i.e. the sightings of a run that are at
+*        most LEGACY_EPOCH_GAP apart.
+* @param archive The (sorted) archive.
+* @param first The first sighting of the epoch.
+* @param timestamp The timestamp of the epoch (of its first sighting).
+* @return The number of sightings, 0 at the end of the archive.
+*/
+u32_t nextLegacyEpoch(struct LegacyArchive* archive, const struct LegacySighting** first,
+                      f32_t* timestamp);
+
+/**
+* @brief Get the SSID of a sighting.
+* @param archive The archive.
+* @param sighting The sighting.
+* @return The SSID, with its trailing newline.
+*/
+const char* getLegacySSID(const struct LegacyArchive* archive,
+                          const struct LegacySighting* sighting);
+
+/**
+* @brief Go back to the first epoch.
+* @param archive The archive.
+* @return Void.
+*/
+void rewindLegacyArchive(struct LegacyArchive* archive);
+
+/**
+* @brief Free the archive.
+* @param archive The archive.
+* @return Void.
+*/
+void exitLegacyArchive(struct LegacyArchive* archive);
+
+/**
+* @brief Print the archive's stats.
+* @param archive The archive.
+* @param file The file to print the stats to.
+* @return Void.
+*/
+void printLegacyArchiveStats(const struct LegacyArchive* archive, FILE* file);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* LEGACY_ARCHIVE_H */
\ No newline at end of file
@@ -0,0 +1,322 @@
+/**
+  * @file legacy_import.c
+  * @brief Imports the legacy text archives (ssids.txt) to log segments: the
+  *        scan epochs of each run are reconstructed from the timestamps the
+  *        SSIDs of a scan share, and written in order as version 1 records
+  *        (which have no BSSID or signal), in segments of their run.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "data_types.h"
+#include "flash_writer.h"
+#include "legacy_archive.h"
+
+/***************************** Macro Definitions *****************************/
+
+/** The version of the segments, and the size of their records besides the
+  * SSID (length, timestamp and latency).
+  */
+#define IMPORT_VERSION         (1u)
+#define IMPORT_RECORD_OVERHEAD (1u + 2u * sizeof(f32_t))
+
+/** The max size of a path. */
+#define PATH_SIZE (4096u)
+
+/***************************** Static Variables ******************************/
+
+/** The options. */
+static const char* output_dir = ".";
+static f64_t base_option;
+static u8_t has_base = FALSE;
+
+/** The base of the segments of the current run. */
+static f64_t realtime_base;
+
+/** The segment being filled. */
+static u8_t* segment;
+static u32_t segment_size;
+static u32_t segment_id;
+
+/** The counters. */
+static u64_t segments, records, truncated, written_bytes;
+
+/************************ Static Function Prototypes *************************/
+
+/**
+ * @brief Find the id after the last segment of the output directory, so that
+ *        the import never overwrites a segment.
+ * @return The id of the first segment of the import.
+ */
+static u32_t findFirstSegment(void);
+
+/**
+ * @brief Start a new segment.
+ * @return Void.
+ */
+static void startSegment(void);
+
+/**
+ * @brief Write the segment to a file, and seal it once it is durable.
+ * @return Void.
+ */
+static void writeSegment(void);
+
+/**
+ * @brief Append a record to the segment, writing it if it is full.
+ * @param ssid The SSID (with the trailing newline).
+ * @param timestamp The timestamp of the record.
+ * @param latency The latency of the record.
+ * @return Void.
+ */
+static void appendRecord(const char* ssid, f32_t timestamp, f32_t latency);
+
+/***************************** Static Functions ******************************/
+
+u32_t findFirstSegment(void)
+{
+  u32_t id, first = 0;
+  char extension[8];
+  struct dirent* entry;
+  DIR* dir = opendir(output_dir);
+
+  if (dir == NULL)
+  {
+    perror("Could not open the output directory");
+    exit(-4);
+  }
+
+  while ((entry = readdir(dir)) != NULL)
+  {
+    if (sscanf(entry->d_name, "ssids_%08u.%7s", &id, extension) == 2 && id >= first)
+      first = id + 1;
+  }
+
+  closedir(dir);
+
+  return first;
+}
+
+void startSegment(void)
+{
+  struct SegmentHeader header;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = SEGMENT_MAGIC;
+  header.version = IMPORT_VERSION;
+  header.header_size = sizeof(header);
+  header.segment_id = segment_id;
+  header.realtime_base = realtime_base;
+
+  memcpy(segment, &header, sizeof(header));
+  segment_size = sizeof(header);
+}
+
+void writeSegment(void)
+{
+  s32_t fd;
+  u32_t written = 0;
+  ssize_t result;
+  char path[PATH_SIZE], sealed_path[PATH_SIZE];
+
+  snprintf(path, PATH_SIZE, "%s/ssids_%08u.open", output_dir, segment_id);
+  snprintf(sealed_path, PATH_SIZE, "%s/ssids_%08u.seg", output_dir, segment_id);
+
+  if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1)
+  {
+    perror("Could not create a segment");
+    exit(-7);
+  }
+
+  while (written < segment_size)
+  {
+    if ((result = write(fd, segment + written, segment_size - written)) <= 0)
+    {
+      perror("Could not write a segment");
+      exit(-7);
+    }
+
+    written += result;
+  }
+
+  if (fdatasync(fd) == -1 || close(fd) == -1 || rename(path, sealed_path) == -1)
+  {
+    perror("Could not seal a segment");
+    exit(-7);
+  }
+
+  written_bytes += segment_size;
+  segments++;
+  segment_id++;
+}
+
+void appendRecord(const char* ssid, f32_t timestamp, f32_t latency)
+{
+  u32_t length = strlen(ssid) - 1;
+
+  if (length > 255)
+  {
+    truncated++;
+    length = 255;
+  }
+
+  if (segment_size + IMPORT_RECORD_OVERHEAD + length > SEGMENT_SIZE)
+  {
+    writeSegment();
+    startSegment();
+  }
+
+  segment[segment_size] = length;
+  memcpy(&segment[segment_size + 1], ssid, length);
+  memcpy(&segment[segment_size + 1 + length], &timestamp, sizeof(f32_t));
+  memcpy(&segment[segment_size + 1 + length + sizeof(f32_t)], &latency, sizeof(f32_t));
+
+  segment_size += IMPORT_RECORD_OVERHEAD + length;
+  records++;
+}
+
+/********************************** Main Entry *******************************/
+
+s32_t main(int argc, char** argv)
+{
+  s32_t option;
+  u32_t i, num, run = U32_MAX;
+  f32_t timestamp;
+  f64_t* file_times;
+  f64_t* run_bases;
+  struct stat file_stat;
+  struct LegacyArchive archive;
+  const struct LegacySighting* first;
+  struct timespec start_t, phase_t[3];
+
+  while ((option = getopt(argc, argv, "o:b:")) != -1)
+  {
+    switch (option)
+    {
+      case 'o':
+        output_dir = optarg;
+        break;
+
+      case 'b':
+        base_option = strtod(optarg, NULL);
+        has_base = TRUE;
+        break;
+
+      default:
+        fprintf(stderr, "Usage: legacy_import [-o output_dir] [-b realtime_base] "
+                        "ssids.txt...\n");
+        exit(-4);
+    }
+  }
+
+  if (argc - optind < 1)
+  {
+    perror("Wrong arguments (no archives)");
+    exit(-4);
+  }
+
+  segment = malloc(SEGMENT_SIZE);
+  file_times = calloc(argc, sizeof(f64_t));
+  run_bases = calloc(argc, sizeof(f64_t));
+
+  if (segment == NULL || file_times == NULL || run_bases == NULL)
+  {
+    perror("Could not allocate the segment");
+    exit(-5);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start_t);
+
+  initializeLegacyArchive(&archive);
+
+  for (i = optind; i < (u32_t)argc; i++)
+  {
+    if (!readLegacyFile(&archive, argv[i]) || stat(argv[i], &file_stat) == -1)
+    {
+      perror("Could not read an archive");
+      exit(-12);
+    }
+
+    file_times[i - optind] = file_stat.st_mtime;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[0]);
+
+  sortLegacyArchive(&archive);
+
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[1]);
+
+  /* The timestamps are since the boot of a run, so without a base, the last
+   * one of a run is taken to be the time its newest file was written.
+   */
+  for (i = 0; i < archive.file_num; i++)
+  {
+    if (file_times[i] > run_bases[archive.file_runs[i]])
+      run_bases[archive.file_runs[i]] = file_times[i];
+  }
+
+  for (i = 0; i < archive.num; i++)
+  {
+    if (i + 1 == archive.num || archive.sightings[i + 1].run != archive.sightings[i].run)
+      run_bases[archive.sightings[i].run] -= (archive.sightings[i].key >> LEGACY_SSID_BITS) / 1000.0;
+  }
+
+  segment_id = findFirstSegment();
+
+  /* The records of an epoch share its timestamp, as in the live log, and
+   * every run starts its own segments, with its own base.
+   */
+  while ((num = nextLegacyEpoch(&archive, &first, &timestamp)) > 0)
+  {
+    if (first->run != run)
+    {
+      if (segment_size > sizeof(struct SegmentHeader))
+        writeSegment();
+
+      run = first->run;
+      realtime_base = has_base ? base_option : run_bases[run];
+      startSegment();
+
+      fprintf(stderr, "base        %.3f (run %u)\n", realtime_base, run);
+    }
+
+    for (i = 0; i < num; i++)
+      appendRecord(getLegacySSID(&archive, &first[i]), timestamp, first[i].latency);
+  }
+
+  if (segment_size > sizeof(struct SegmentHeader))
+    writeSegment();
+
+  clock_gettime(CLOCK_MONOTONIC, &phase_t[2]);
+
+  printLegacyArchiveStats(&archive, stderr);
+
+  fprintf(stderr, "records     %llu (%llu truncated)\n", records, truncated);
+  fprintf(stderr, "segments    %llu (%llu bytes)\n", segments, written_bytes);
+  fprintf(stderr, "parse_mbps  %.1f\n", archive.bytes / 1e6 /
+          ((phase_t[0].tv_sec - start_t.tv_sec) + (phase_t[0].tv_nsec - start_t.tv_nsec) / 1e9));
+  fprintf(stderr, "sort_secs   %.2f\n", (phase_t[1].tv_sec - phase_t[0].tv_sec) +
+          (phase_t[1].tv_nsec - phase_t[0].tv_nsec) / 1e9);
+  fprintf(stderr, "write_secs  %.2f\n", (phase_t[2].tv_sec - phase_t[1].tv_sec) +
+          (phase_t[2].tv_nsec - phase_t[1].tv_nsec) / 1e9);
+
+  exitLegacyArchive(&archive);
+  free(segment);
+  free(file_times);
+  free(run_bases);
+
+  exit(0);
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+  * @file segment_reader.c
+  * @brief Implements a reader of the log segments, for the offline tools.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+/******************************** Inclusions *********************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "segment_reader.h"
+
+/***************************** Public Functions ******************************/
+
+u8_t openSegmentReader(struct SegmentReader* reader, const char* path)
+{
+  s32_t fd;
+  ssize_t result;
+  struct stat segment_stat;
+
+  reader->data = NULL;
+  reader->size = 0;
+  reader->offset = 0;
+
+  if ((fd = open(path, O_RDONLY)) == -1)
+    return FALSE;
+
+  if (fstat(fd, &segment_stat) == -1 || segment_stat.st_size < (off_t)sizeof(struct SegmentHeader) ||
+      (reader->data = malloc(segment_stat.st_size)) == NULL)
+  {
+    close(fd);
+    return FALSE;
+  }
+
+  while (reader->size < (u64_t)segment_stat.st_size)
+  {
+    if ((result = read(fd, reader->data + reader->size, segment_stat.st_size - reader->size)) <= 0)
+      break;
+
+    reader->size += result;
+  }
+
+  close(fd);
+
+  memcpy(&reader->header, reader->data, sizeof(struct SegmentHeader));
+
+  if (reader->header.magic != SEGMENT_MAGIC || reader->header.version == 0 ||
+      reader->header.version > SEGMENT_VERSION || reader->header.header_size > reader->size)
+  {
+    closeSegmentReader(reader);
+    return FALSE;
+  }
+
+  reader->offset = reader->header.header_size;
+
+  return TRUE;
+}
+
+u8_t nextSegmentRecord(struct SegmentReader* reader, struct SegmentRecord* record)
+{
+  u8_t length;
+  u32_t overhead = (reader->header.version >= 2) ? RECORD_OVERHEAD : 1 + 2 * sizeof(f32_t);
+  const u8_t* data;
+
+  /* Padding is skipped */
+  while (reader->offset < reader->size && reader->data[reader->offset] == 0)
+    reader->offset++;
+
+  if (reader->offset >= reader->size)
+    return FALSE;
+
+  data = &reader->data[reader->offset];
+  length = data[0];
+
+  /* A torn record at the end of the segment */
+  if (reader->offset + overhead + length > reader->size)
+  {
+    reader->offset = reader->size;
+    return FALSE;
+  }
+
+  memcpy(record->ssid, &data[1], length);
+  record->ssid[length] = '\0';
+  data += 1 + length;
+
+  if (reader->header.version >= 2)
+  {
+    memcpy(record->bssid, data, 6);
+    record->rssi = (s8_t)data[6];
+    record->has_radio = TRUE;
+    data += 7;
+  }
+  else
+  {
+    memset(record->bssid, 0, 6);
+    record->rssi = 0;
+    record->has_radio = FALSE;
+  }
+
+  memcpy(&record->timestamp, data, sizeof(f32_t));
+  memcpy(&record->latency, data + sizeof(f32_t), sizeof(f32_t));
+
+  reader->offset += overhead + length;
+
+  return TRUE;
+}
+
+f64_t getRecordTime(const struct SegmentReader* reader, const struct SegmentRecord* record)
+{
+  return reader->header.realtime_base + record->timestamp;
+}
+
+void closeSegmentReader(struct SegmentReader* reader)
+{
+  free(reader->data);
+  reader->data = NULL;
+}
+
+u8_t isSealedSegment(const char* name, u32_t* id)
+{
+  char extension[8];
+
+  return sscanf(name, "ssids_%08u.%7s", id, extension) == 2 && !strcmp(extension, "seg");
+}
\ No newline at end of file
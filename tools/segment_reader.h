@@ -0,0 +1,86 @@
+/**
+  * @file segment_reader.h
+  * @brief Contains the declarations of functions defined in segment_reader.c.
+  *
+  * @author Dimitrios Panagiotis G. Geromichalos (geromidg@gmail.com)
+  * @date October, 2026
+  */
+
+#ifndef SEGMENT_READER_H
+#define SEGMENT_READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************** Inclusions *********************************/
+
+#include "data_types.h"
+#include "flash_writer.h"
+
+/***************************** Type Definitions ******************************/
+
+/** A record of a log segment. The SSID is NUL-terminated. */
+struct SegmentRecord {
+  char ssid[256];
+  u8_t bssid[6];
+  s8_t rssi;
+  u8_t has_radio;  /* FALSE for version 1 records */
+  f32_t timestamp, latency;
+};
+
+/** A log segment, read to memory. */
+struct SegmentReader {
+  struct SegmentHeader header;
+  u8_t* data;
+  u64_t size, offset;
+};
+
+/***************************** Public Functions ******************************/
+
+/**
+* @brief Read a log segment and check its header.
+* @param reader The reader.
+* @param path The file of the segment.
+* @return TRUE if the segment is valid, FALSE otherwise.
+*/
+u8_t openSegmentReader(struct SegmentReader* reader, const char* path);
+
+/**
+* @brief Get the next record of a segment.
+* @param reader The reader.
+* @param record The record.
+* @return TRUE if there is a record, FALSE at the end of the segment.
+*/
+u8_t nextSegmentRecord(struct SegmentReader* reader, struct SegmentRecord* record);
+
+/**
+* @brief Get the wall clock time of a record.
+* @param reader The reader.
+* @param record The record.
+* @return The UNIX time (in secs).
+*/
+f64_t getRecordTime(const struct SegmentReader* reader, const struct SegmentRecord* record);
+
+/**
+* @brief Free the segment.
+* @param reader The reader.
+* @return Void.
+*/
+void closeSegmentReader(struct SegmentReader* reader);
+
+/**
+* @brief Check whether a file name is the one of a sealed segment.
+* @param name The name of the file.
+* @param id The id of the segment.
+* @return TRUE if it is a sealed segment, FALSE otherwise.
+*/
+u8_t isSealedSegment(const char* name, u32_t* id);
+
+/*****************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* SEGMENT_READER_H */
\ No newline at end of file